@@ -74,6 +74,70 @@ static unsigned char custom_touch_format[] = {
 /* The delayed time when doing power mode switching */
 #define DEV_POWER_SWITCHING_DELAY_MS (100)
 
+/* Options of input reporting checked per frame, the defaults come from the
+ * build flags; switched by syna_dev_set_input_options() at runtime
+ */
+#ifdef TYPE_B_PROTOCOL
+static DEFINE_STATIC_KEY_TRUE(syna_input_type_b);
+#else
+static DEFINE_STATIC_KEY_FALSE(syna_input_type_b);
+#endif
+#ifdef REPORT_SWAP_XY
+static DEFINE_STATIC_KEY_TRUE(syna_input_swap_xy);
+#else
+static DEFINE_STATIC_KEY_FALSE(syna_input_swap_xy);
+#endif
+#ifdef REPORT_FLIP_X
+static DEFINE_STATIC_KEY_TRUE(syna_input_flip_x);
+#else
+static DEFINE_STATIC_KEY_FALSE(syna_input_flip_x);
+#endif
+#ifdef REPORT_FLIP_Y
+static DEFINE_STATIC_KEY_TRUE(syna_input_flip_y);
+#else
+static DEFINE_STATIC_KEY_FALSE(syna_input_flip_y);
+#endif
+#ifdef REPORT_TOUCH_WIDTH
+static DEFINE_STATIC_KEY_TRUE(syna_input_touch_width);
+#else
+static DEFINE_STATIC_KEY_FALSE(syna_input_touch_width);
+#endif
+#ifdef ENABLE_WAKEUP_GESTURE
+static DEFINE_STATIC_KEY_TRUE(syna_input_wakeup_gesture);
+#else
+static DEFINE_STATIC_KEY_FALSE(syna_input_wakeup_gesture);
+#endif
+
+/* Input options requiring the input device to be registered again */
+#define INPUT_OPTS_CAPABILITY \
+	(BIT(INPUT_OPT_TOUCH_WIDTH) | BIT(INPUT_OPT_WAKEUP_GESTURE))
+
+#if defined(ENABLE_HELPER) || defined(STARTUP_REFLASH) || defined(FLASH_RECOVERY)
+/*
+ * Select a cpu for the housekeeping works, away from the cpus dedicated
+ * to the irq thread.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    the cpu selected; or, WORK_CPU_UNBOUND if no cpu is dedicated.
+ */
+static int syna_dev_get_housekeeping_cpu(struct syna_tcm *tcm)
+{
+	int cpu;
+
+	if (cpumask_empty(&tcm->irq_sched.cpus))
+		return WORK_CPU_UNBOUND;
+
+	for_each_online_cpu(cpu) {
+		if (!cpumask_test_cpu(cpu, &tcm->irq_sched.cpus))
+			return cpu;
+	}
+
+	return WORK_CPU_UNBOUND;
+}
+#endif
 
 #if defined(ENABLE_HELPER)
 /*
@@ -106,7 +170,8 @@ static void syna_dev_helper_work(struct work_struct *work)
 			LOGI("Bootloader status: 0x%x (reset reason: 0x%x)\n",
 				tcm->tcm_dev->boot_info.status, tcm->tcm_dev->boot_info.last_reset_reason);
 #ifdef FLASH_RECOVERY
-		queue_delayed_work(tcm->reflash_workqueue, &tcm->reflash_work, msecs_to_jiffies(100));
+		queue_delayed_work_on(syna_dev_get_housekeeping_cpu(tcm), tcm->reflash_workqueue,
+			&tcm->reflash_work, msecs_to_jiffies(100));
 #endif
 	}
 
@@ -115,7 +180,8 @@ static void syna_dev_helper_work(struct work_struct *work)
 		if (app_status != APP_STATUS_OK) {
 			LOGI("Bad app status: 0x%x\n", app_status);
 #ifdef FLASH_RECOVERY
-			queue_delayed_work(tcm->reflash_workqueue, &tcm->reflash_work, msecs_to_jiffies(100));
+			queue_delayed_work_on(syna_dev_get_housekeeping_cpu(tcm), tcm->reflash_workqueue,
+				&tcm->reflash_work, msecs_to_jiffies(100));
 #endif
 		} else {
 			LOGI("Re-configure the app fw due to reset\n");
@@ -159,6 +225,11 @@ static int syna_dev_process_unexpected_reset(const unsigned char code,
 
 	LOGN("Device has been reset, may be the spontaneous reset\n");
 
+#if defined(ENABLE_CLOCK_SYNC)
+	/* the firmware clock is restarted */
+	syna_dev_reset_clock_sync(tcm);
+#endif
+
 #if defined(ENABLE_HELPER)
 	/* send the command through helper thread */
 	if (!tcm->helper.workqueue) {
@@ -168,7 +239,8 @@ static int syna_dev_process_unexpected_reset(const unsigned char code,
 
 	if (ATOMIC_GET(tcm->helper.task) == HELP_NONE) {
 		ATOMIC_SET(tcm->helper.task, HELP_RESET_DETECTED);
-		queue_work(tcm->helper.workqueue, &tcm->helper.work);
+		queue_work_on(syna_dev_get_housekeeping_cpu(tcm),
+			tcm->helper.workqueue, &tcm->helper.work);
 	}
 #endif
 
@@ -211,7 +283,7 @@ static int syna_dev_parse_custom_touch_data_cb(const unsigned char code,
 	 * switch (code) {
 	 * case CUSTOM_ENTITY_CODE:
 	 *		bits = config[(*config_offset)++];
-	 *		syna_tcm_get_touch_data(report, report_size, *report_offset, bits, &data);
+	 *		data = syna_tcm_get_touch_bits(report, report_size, *report_offset, bits);
 	 *		*report_offset += bits;
 	 *		return bits;
 	 *	default:
@@ -237,26 +309,27 @@ static int syna_dev_parse_custom_touch_data_cb(const unsigned char code,
 static void syna_dev_free_input_events(struct syna_tcm *tcm)
 {
 	struct input_dev *input_dev = tcm->input_dev;
-#ifdef TYPE_B_PROTOCOL
 	unsigned int idx;
-#endif
 
 	if (input_dev == NULL)
 		return;
 
 	syna_pal_mutex_lock(&tcm->tp_event_mutex);
 
-#ifdef TYPE_B_PROTOCOL
-	for (idx = 0; idx < MAX_NUM_OBJECTS; idx++) {
-		input_mt_slot(input_dev, idx);
-		input_mt_report_slot_state(input_dev, MT_TOOL_FINGER, 0);
+	if (static_branch_likely(&syna_input_type_b)) {
+		for (idx = 0; idx < MAX_NUM_OBJECTS; idx++) {
+			input_mt_slot(input_dev, idx);
+			input_mt_report_slot_state(input_dev, MT_TOOL_FINGER, 0);
+		}
 	}
-#endif
+	/* all slots have to be reported again at the next report */
+	tcm->pending_objects = GENMASK(MAX_NUM_OBJECTS - 1, 0);
+	tcm->touching_objects = 0;
+
 	input_report_key(input_dev, BTN_TOUCH, 0);
 	input_report_key(input_dev, BTN_TOOL_FINGER, 0);
-#ifndef TYPE_B_PROTOCOL
-	input_mt_sync(input_dev);
-#endif
+	if (!static_branch_likely(&syna_input_type_b))
+		input_mt_sync(input_dev);
 	input_sync(input_dev);
 
 	syna_pal_mutex_unlock(&tcm->tp_event_mutex);
@@ -298,17 +371,15 @@ static void syna_dev_report_input_knob_events(struct syna_tcm *tcm)
 			input_report_key(knob_dev, BTN_WHEEL, knob_data->grasp);
 			if (knob_data->grasp)
 				input_report_abs(knob_dev, ABS_WHEEL, knob_data->angle);
-#ifndef TYPE_B_PROTOCOL
-			input_mt_sync(knob_dev);
-#endif
+			if (!static_branch_likely(&syna_input_type_b))
+				input_mt_sync(knob_dev);
 			input_sync(knob_dev);
 		}
 
 		if (knob_data->is_clicked) {
 			input_report_key(knob_dev, BTN_SELECT, knob_data->click);
-#ifndef TYPE_B_PROTOCOL
-			input_mt_sync(knob_dev);
-#endif
+			if (!static_branch_likely(&syna_input_type_b))
+				input_mt_sync(knob_dev);
 			input_sync(knob_dev);
 		}
 	}
@@ -321,12 +392,15 @@ static void syna_dev_report_input_knob_events(struct syna_tcm *tcm)
  * Assumes touch data, touch_data_blob and objects_data_blob, is populated.
  *
  * param
- *    [ in] tcm: pointer to the driver context
+ *    [ in] tcm:        pointer to the driver context
+ *    [ in] touch_data: touch data to report
+ *    [ in] timestamp:  time of ATTN for the events; or, zero if unknown
  *
  * return
  *    void.
  */
-static void syna_dev_report_input_events(struct syna_tcm *tcm)
+static void syna_dev_report_input_events(struct syna_tcm *tcm,
+	struct tcm_touch_data_blob *touch_data, ktime_t timestamp)
 {
 	unsigned int idx;
 	unsigned int x;
@@ -335,9 +409,9 @@ static void syna_dev_report_input_events(struct syna_tcm *tcm)
 	int wy;
 	unsigned int status;
 	unsigned int touch_count;
+	unsigned long objects;
 	struct input_dev *input_dev = tcm->input_dev;
 	unsigned int max_objects = tcm->tcm_dev->max_objects;
-	struct tcm_touch_data_blob *touch_data;
 	struct tcm_objects_data_blob *object_data;
 
 	if (input_dev == NULL)
@@ -345,29 +419,37 @@ static void syna_dev_report_input_events(struct syna_tcm *tcm)
 
 	syna_pal_mutex_lock(&tcm->tp_event_mutex);
 
-	touch_data = &tcm->tp_data;
 	object_data = &touch_data->object_data[0];
 
-#ifdef ENABLE_WAKEUP_GESTURE
-	if ((tcm->pwr_state == LOW_PWR_GESTURE) && tcm->irq_wake) {
-		if (touch_data->gesture_id) {
-			LOGD("Gesture detected, id:%d\n",
-				touch_data->gesture_id);
-
-			input_report_key(input_dev, KEY_WAKEUP, 1);
-			input_sync(input_dev);
-			input_report_key(input_dev, KEY_WAKEUP, 0);
-			input_sync(input_dev);
+	if (static_branch_unlikely(&syna_input_wakeup_gesture)) {
+		if ((tcm->pwr_state == LOW_PWR_GESTURE) && tcm->irq_wake) {
+			if (touch_data->gesture_id) {
+				LOGD("Gesture detected, id:%d\n",
+					touch_data->gesture_id);
+
+				input_report_key(input_dev, KEY_WAKEUP, 1);
+				input_sync(input_dev);
+				input_report_key(input_dev, KEY_WAKEUP, 0);
+				input_sync(input_dev);
+			}
 		}
 	}
-#endif
+
+	/* slots keep their states in type B, so only the changed are reported */
+	if (static_branch_likely(&syna_input_type_b))
+		tcm->pending_objects |= touch_data->dirty_objects_mask;
 
 	if ((tcm->pwr_state == LOW_PWR) || (tcm->pwr_state == LOW_PWR_GESTURE))
 		goto exit;
 
 	touch_count = 0;
 
-	for (idx = 0; idx < max_objects; idx++) {
+	if (static_branch_likely(&syna_input_type_b))
+		objects = tcm->pending_objects;
+	else
+		objects = GENMASK(MAX_NUM_OBJECTS - 1, 0);
+
+	for_each_set_bit(idx, &objects, max_objects) {
 		if (tcm->prev_obj_status[idx] == LIFT &&
 				object_data[idx].status == LIFT)
 			status = NOP;
@@ -376,11 +458,11 @@ static void syna_dev_report_input_events(struct syna_tcm *tcm)
 
 		switch (status) {
 		case LIFT:
-#ifdef TYPE_B_PROTOCOL
-			input_mt_slot(input_dev, idx);
-			input_mt_report_slot_state(input_dev,
-					MT_TOOL_FINGER, 0);
-#endif
+			if (static_branch_likely(&syna_input_type_b)) {
+				input_mt_slot(input_dev, idx);
+				input_mt_report_slot_state(input_dev,
+						MT_TOOL_FINGER, 0);
+			}
 			break;
 		case FINGER:
 		case GLOVED_OBJECT:
@@ -389,35 +471,33 @@ static void syna_dev_report_input_events(struct syna_tcm *tcm)
 			wx = object_data[idx].x_width;
 			wy = object_data[idx].y_width;
 
-#ifdef REPORT_SWAP_XY
-			x = x ^ y;
-			y = x ^ y;
-			x = x ^ y;
-#endif
-#ifdef REPORT_FLIP_X
-			x = tcm->input_dev_params.max_x - x;
-#endif
-#ifdef REPORT_FLIP_Y
-			y = tcm->input_dev_params.max_y - y;
-#endif
-#ifdef TYPE_B_PROTOCOL
-			input_mt_slot(input_dev, idx);
-			input_mt_report_slot_state(input_dev,
-					MT_TOOL_FINGER, 1);
-#endif
+			if (static_branch_unlikely(&syna_input_swap_xy)) {
+				x = x ^ y;
+				y = x ^ y;
+				x = x ^ y;
+			}
+			if (static_branch_unlikely(&syna_input_flip_x))
+				x = tcm->input_dev_params.max_x - x;
+			if (static_branch_unlikely(&syna_input_flip_y))
+				y = tcm->input_dev_params.max_y - y;
+
+			if (static_branch_likely(&syna_input_type_b)) {
+				input_mt_slot(input_dev, idx);
+				input_mt_report_slot_state(input_dev,
+						MT_TOOL_FINGER, 1);
+			}
 			input_report_key(input_dev, BTN_TOUCH, 1);
 			input_report_key(input_dev, BTN_TOOL_FINGER, 1);
 			input_report_abs(input_dev, ABS_MT_POSITION_X, x);
 			input_report_abs(input_dev, ABS_MT_POSITION_Y, y);
-#ifdef REPORT_TOUCH_WIDTH
-			input_report_abs(input_dev,
-					ABS_MT_TOUCH_MAJOR, MAX(wx, wy));
-			input_report_abs(input_dev,
-					ABS_MT_TOUCH_MINOR, MIN(wx, wy));
-#endif
-#ifndef TYPE_B_PROTOCOL
-			input_mt_sync(input_dev);
-#endif
+			if (static_branch_likely(&syna_input_touch_width)) {
+				input_report_abs(input_dev,
+						ABS_MT_TOUCH_MAJOR, MAX(wx, wy));
+				input_report_abs(input_dev,
+						ABS_MT_TOUCH_MINOR, MIN(wx, wy));
+			}
+			if (!static_branch_likely(&syna_input_type_b))
+				input_mt_sync(input_dev);
 			LOGD("Finger %d: x = %d, y = %d\n", idx, x, y);
 			touch_count++;
 			break;
@@ -426,252 +506,2739 @@ static void syna_dev_report_input_events(struct syna_tcm *tcm)
 		}
 
 		tcm->prev_obj_status[idx] = object_data[idx].status;
+		if ((status == FINGER) || (status == GLOVED_OBJECT))
+			__set_bit(idx, &tcm->touching_objects);
+		else
+			__clear_bit(idx, &tcm->touching_objects);
+	}
+
+	if (static_branch_likely(&syna_input_type_b)) {
+		touch_count = hweight_long(tcm->touching_objects);
+		tcm->pending_objects = 0;
 	}
 
 	if (touch_count == 0) {
 		input_report_key(input_dev, BTN_TOUCH, 0);
 		input_report_key(input_dev, BTN_TOOL_FINGER, 0);
-#ifndef TYPE_B_PROTOCOL
-		input_mt_sync(input_dev);
-#endif
+		if (!static_branch_likely(&syna_input_type_b))
+			input_mt_sync(input_dev);
 	}
 
+#if (KERNEL_VERSION(5, 4, 0) <= LINUX_VERSION_CODE)
+	/* stamp the events with the time of ATTN rather than the time of sync */
+	if (ktime_to_ns(timestamp) != 0)
+		input_set_timestamp(input_dev, timestamp);
+#endif
+
 	input_sync(input_dev);
 
 exit:
 	syna_pal_mutex_unlock(&tcm->tp_event_mutex);
-
 }
 /*
- * Process the touch report.
+ * Publish the touch data parsed to the readers outside the report stage.
+ *
+ * The buffer not being published is filled first, then the index is flipped
+ * under the seqcount, so the readers never hold up the report stage.
+ * Nothing is copied unless a reader showed up within TOUCH_DATA_DEMAND_MS.
  *
  * param
- *    [ in]    code:          the report type in the given report
- *    [ in]    report:        report data
- *    [ in]    report_size:   size of the given report
- *    [ in]    callback_data: private data being passed to the callback function
+ *    [ in] tcm: pointer to the driver context
  *
  * return
- *    on success, 0 or positive value; otherwise, negative value on error.
+ *    void.
  */
-static int syna_dev_process_touch_report(const unsigned char code,
-	const unsigned char *report, unsigned int report_size,
-	void *callback_data)
+static void syna_dev_publish_touch_data(struct syna_tcm *tcm)
 {
-	int retval;
-	struct syna_tcm *tcm = (struct syna_tcm *)callback_data;
+	struct syna_touch_data_snapshot *snapshot = &tcm->tp_snapshot;
+	unsigned int next = snapshot->idx ^ 1;
 
-	if (!tcm) {
-		LOGE("Invalid callback data\n");
-		return -EINVAL;
-	}
+	if (time_after(jiffies, READ_ONCE(snapshot->demand_until)))
+		return;
 
-	if (code != REPORT_TOUCH) {
-		LOGE("Invalid report to process, report:%d\n", code);
-		return -EINVAL;
-	}
+	syna_pal_mem_cpy(&snapshot->blob[next], sizeof(snapshot->blob[next]),
+		&tcm->tp_data, sizeof(tcm->tp_data), sizeof(tcm->tp_data));
 
-	/* not report to input device subsystem if the cdev interface is in used */
-	if ((tcm->char_dev_ref_count > 0) && !tcm->concurrent_reporting)
-		return 0;
+	preempt_disable();
+	write_seqcount_begin(&snapshot->seq);
+	WRITE_ONCE(snapshot->idx, next);
+	snapshot->frames++;
+	write_seqcount_end(&snapshot->seq);
+	preempt_enable();
 
-	/* parse touch report once received */
-	retval = syna_tcm_parse_touch_report(tcm->tcm_dev,
-			(unsigned char *)report,
-			report_size,
-			&tcm->tp_data);
-	if (retval < 0) {
-		LOGE("Fail to parse touch report\n");
-		return retval;
-	}
-	/* report the touch event to system */
-	syna_dev_report_input_events(tcm);
-#if defined(TOUCHCOMM_TDDI) && defined(REPORT_KNOB)
-	/* report the knob event to system */
-	syna_dev_report_input_knob_events(tcm);
-#endif
-	return 0;
+	if (wq_has_sleeper(&snapshot->wait))
+		wake_up(&snapshot->wait);
+}
+/*
+ * Read the latest touch data published by the report stage.
+ *
+ * The copy is retried if a new frame is published meanwhile, the caller
+ * is never blocked by the report stage nor blocks it. The publishing is
+ * resumed by the read, so the first read after a quiet period waits for
+ * a fresh frame shortly, then falls back to the frame published last.
+ *
+ * param
+ *    [ in] tcm:        pointer to the driver context
+ *    [out] touch_data: buffer to store the touch data
+ *
+ * return
+ *    the number of frames published so far; 0 if none.
+ */
+unsigned int syna_dev_read_touch_data(struct syna_tcm *tcm,
+	struct tcm_touch_data_blob *touch_data)
+{
+	struct syna_touch_data_snapshot *snapshot = &tcm->tp_snapshot;
+	unsigned int seq;
+	unsigned int idx;
+	unsigned int frames;
+	bool publishing;
+
+	frames = READ_ONCE(snapshot->frames);
+	publishing = !time_after(jiffies, READ_ONCE(snapshot->demand_until));
+
+	WRITE_ONCE(snapshot->demand_until,
+		jiffies + msecs_to_jiffies(TOUCH_DATA_DEMAND_MS));
+
+	if (!publishing)
+		wait_event_interruptible_timeout(snapshot->wait,
+			READ_ONCE(snapshot->frames) != frames,
+			msecs_to_jiffies(TOUCH_DATA_WAIT_MS));
+
+	do {
+		seq = read_seqcount_begin(&snapshot->seq);
+		idx = READ_ONCE(snapshot->idx);
+		frames = snapshot->frames;
+		syna_pal_mem_cpy(touch_data, sizeof(*touch_data),
+			&snapshot->blob[idx], sizeof(snapshot->blob[idx]),
+			sizeof(snapshot->blob[idx]));
+	} while (read_seqcount_retry(&snapshot->seq, seq));
+
+	return frames;
 }
+#if defined(ENABLE_CLOCK_SYNC)
+/*
+ * Scan time of the firmware ticks given by the model, called with the lock
+ * of clock synchronization held.
+ *
+ * param
+ *    [ in] sync:  pointer to the clock synchronization
+ *    [ in] ticks: firmware ticks unwrapped
+ *
+ * return
+ *    the scan time in nanoseconds of the host monotonic clock.
+ */
+static s64 syna_dev_clock_sync_predict(struct syna_clock_sync *sync, u64 ticks)
+{
+	s64 scan_ns = sync->base_ns + sync->offset_ns;
 
-#if defined(TOUCHCOMM_TDDI) && defined(REPORT_KNOB)
+	if (ticks >= sync->base_ticks)
+		return scan_ns + (s64)mul_u64_u64_shr(sync->rate_q16,
+				ticks - sync->base_ticks, 16);
+
+	return scan_ns - (s64)mul_u64_u64_shr(sync->rate_q16,
+			sync->base_ticks - ticks, 16);
+}
 /*
- * Allocate an input device for knob and set up relevant parameters
- * to the input subsystem.
+ * Restart the window of samples, called with the lock held.
  *
  * param
- *    [ in] tcm: pointer to the driver context
+ *    [ in] sync: pointer to the clock synchronization
  *
  * return
- *    0 or positive value in case of success, a negative value otherwise.
+ *    void.
  */
-static int syna_dev_create_input_knob_device(struct syna_tcm *tcm)
+static void syna_dev_clock_sync_restart(struct syna_clock_sync *sync)
 {
-	int retval = 0;
-	int idx = 0;
-#ifdef DEV_MANAGED_API
-	struct device *dev;
-#endif
+	sync->head = 0;
+	sync->count = 0;
+	sync->epoch = 0;
+	sync->locked = false;
+}
+/*
+ * Fit the model to the samples in the window, called with the lock held.
+ *
+ * The samples are scaled down before the sums, so the least squares are
+ * done in 64-bit without overflow; the offset is the min. residual.
+ *
+ * param
+ *    [ in] sync: pointer to the clock synchronization
+ *
+ * return
+ *    true if the model is fitted; false otherwise.
+ */
+static bool syna_dev_clock_sync_fit(struct syna_clock_sync *sync)
+{
+	unsigned int n = sync->count;
+	unsigned int first = (sync->head - n) & (CLOCK_SYNC_WINDOW - 1);
+	unsigned int idx, k;
+	u64 max_dx = 0;
+	s64 max_dy = 0;
+	s64 dx[CLOCK_SYNC_WINDOW];
+	s64 dy[CLOCK_SYNC_WINDOW];
+	s64 sum_x = 0, sum_y = 0, mean_x, mean_y;
+	s64 sxx = 0, sxy = 0;
+	s64 q, rem, offset, nominal, diff;
+	int shift_x, shift_y;
+	u64 rate;
+
+	sync->base_ticks = sync->ticks[first];
+	sync->base_ns = sync->attn_ns[first];
+
+	for (idx = 0; idx < n; idx++) {
+		k = (first + idx) & (CLOCK_SYNC_WINDOW - 1);
+		dx[idx] = (s64)(sync->ticks[k] - sync->base_ticks);
+		dy[idx] = sync->attn_ns[k] - sync->base_ns;
+		max_dx = MAX(max_dx, (u64)dx[idx]);
+		max_dy = MAX(max_dy, dy[idx]);
+	}
 
-#ifdef DEV_MANAGED_API
-	dev = syna_request_managed_device();
+	if ((max_dx == 0) || (max_dy <= 0))
+		return false;
 
-	if (!dev) {
-		LOGE("Invalid managed device\n");
-		return -EINVAL;
+	shift_x = MAX(fls64(max_dx) - 21, 0);
+	shift_y = MAX(fls64(max_dy) - 31, 0);
+
+	for (idx = 0; idx < n; idx++) {
+		sum_x += dx[idx] >> shift_x;
+		sum_y += dy[idx] >> shift_y;
 	}
-#endif
+	mean_x = div_s64(sum_x, n);
+	mean_y = div_s64(sum_y, n);
 
-	for (idx = 0; idx < MAX_NUM_KNOB_OBJECTS; idx++) {
-#ifndef HAVE_THE_SECOND_KNOB
-		if (idx > 0)
-			break;
-#endif
-		if (tcm->input_knob_dev[idx]) {
-			input_unregister_device(tcm->input_knob_dev[idx]);
-			tcm->input_knob_dev[idx] = NULL;
-		}
+	for (idx = 0; idx < n; idx++) {
+		sxx += ((dx[idx] >> shift_x) - mean_x) * ((dx[idx] >> shift_x) - mean_x);
+		sxy += ((dx[idx] >> shift_x) - mean_x) * ((dy[idx] >> shift_y) - mean_y);
+	}
 
-#ifdef DEV_MANAGED_API
-		tcm->input_knob_dev[idx] = devm_input_allocate_device(dev);
-#else /* Legacy API */
-		tcm->input_knob_dev[idx] = input_allocate_device();
-#endif
-		if (tcm->input_knob_dev[idx] == NULL) {
-			LOGE("Fail to allocate input device %d for knob\n", idx);
-			break;
-		}
+	if ((sxx == 0) || (sxy <= 0))
+		return false;
 
-		tcm->input_knob_dev[idx]->name = KNOB_INPUT_NAME;
-		tcm->input_knob_dev[idx]->phys = KNOB_INPUT_PHYS_PATH;
-		tcm->input_knob_dev[idx]->id.product = SYNAPTICS_TCM_DRIVER_ID;
-		tcm->input_knob_dev[idx]->id.version = SYNAPTICS_TCM_DRIVER_VERSION;
-		tcm->input_knob_dev[idx]->dev.parent = tcm->pdev->dev.parent;
-		input_set_drvdata(tcm->input_knob_dev[idx], tcm);
+	/* slope in q16 */
+	q = div64_s64(sxy, sxx);
+	rem = sxy - q * sxx;
+	rate = (u64)(q << 16) + (u64)div64_s64(rem << 16, sxx);
+	if (shift_y >= shift_x)
+		rate <<= (shift_y - shift_x);
+	else
+		rate >>= (shift_x - shift_y);
 
-		input_set_capability(tcm->input_knob_dev[idx], EV_KEY, BTN_SELECT);
-		input_set_capability(tcm->input_knob_dev[idx], EV_KEY, BTN_WHEEL);
-		input_set_capability(tcm->input_knob_dev[idx], EV_ABS, ABS_WHEEL);
+	if (rate == 0)
+		return false;
 
-		input_set_abs_params(tcm->input_knob_dev[idx], ABS_WHEEL, 0, 32, 0, 0);
+	sync->rate_q16 = rate;
 
-		retval = input_register_device(tcm->input_knob_dev[idx]);
-		if (retval < 0) {
-			LOGE("Fail to register input device for knob\n");
-			input_free_device(tcm->input_knob_dev[idx]);
-			tcm->input_knob_dev[idx] = NULL;
-			return retval;
-		}
-	}
+	/* lower envelope, the delay to ATTN is never negative */
+	offset = S64_MAX;
+	for (idx = 0; idx < n; idx++)
+		offset = MIN(offset, dy[idx] -
+			(s64)mul_u64_u64_shr(rate, (u64)dx[idx], 16));
+	sync->offset_ns = offset;
 
-	return 0;
+	/* drift against the nominal period of tick */
+	nominal = (s64)sync->tick_ns << 16;
+	diff = clamp_t(s64, (s64)rate - nominal, -nominal, nominal);
+	sync->stats.drift_ppm = (int)div64_s64(diff * 1000000, nominal);
+
+	return true;
 }
 /*
- * Release the input device for knob allocated previously.
+ * Unwrap the firmware timestamp, called with the lock held.
+ *
+ * The ticks elapsed are estimated from the host time since the previous
+ * sample, by the rate fitted or the nominal period, and the timestamp is
+ * taken in the wrap nearest to the estimation; so the wraps are counted
+ * even if the gap of reports is longer than a wrap of the timestamp.
  *
  * param
- *    [ in] tcm: pointer to the driver context
+ *    [ in] sync:      pointer to the clock synchronization
+ *    [ in] raw:       firmware timestamp in the report
+ *    [ in] bits:      width of the firmware timestamp
+ *    [ in] attn_time: time of ATTN for the report
  *
  * return
- *    void.
+ *    the firmware ticks unwrapped.
  */
-static void syna_dev_release_input_knob_device(struct syna_tcm *tcm)
+static u64 syna_dev_clock_sync_unwrap(struct syna_clock_sync *sync,
+	unsigned int raw, unsigned int bits, ktime_t attn_time)
 {
-	int idx = 0;
+	u64 span = BIT_ULL(MIN(bits, 32U));
+	u64 rate, expected, delta, ticks;
+	s64 elapsed_ns;
 
-	for (idx = 0; idx < MAX_NUM_KNOB_OBJECTS; idx++) {
-#ifndef HAVE_THE_SECOND_KNOB
-		if (idx > 0)
-			break;
-#endif
-		if (tcm->input_knob_dev[idx]) {
-			input_unregister_device(tcm->input_knob_dev[idx]);
-			tcm->input_knob_dev[idx] = NULL;
-		}
-	}
-}
-#endif
+	if (sync->count == 0)
+		return raw;
+
+	elapsed_ns = MAX(ktime_to_ns(ktime_sub(attn_time, sync->last_attn)), 0LL);
+	rate = (sync->locked) ? sync->rate_q16 : ((u64)sync->tick_ns << 16);
+
+	expected = sync->last_ticks;
+	if (rate > 0)
+		expected += div64_u64((u64)elapsed_ns << 16, rate);
 
+	/* the nearest ticks to the expectation, having the same raw bits */
+	delta = ((u64)raw - expected) & (span - 1);
+	ticks = expected + delta;
+	if ((delta >= (span >> 1)) && (ticks >= sync->last_ticks + span))
+		ticks -= span;
+
+	sync->stats.wraps += (unsigned int)((ticks >> MIN(bits, 32U)) -
+		(sync->last_ticks >> MIN(bits, 32U)));
+
+	return ticks;
+}
 /*
- * Allocate an input device and set up relevant parameters to the
- * input subsystem.
+ * Add a sample of the firmware timestamp and ATTN time, called with the
+ * lock held.
+ *
+ * The timestamp is unwrapped by the host time elapsed; the window is
+ * restarted after a long gap of reports, or once the firmware clock jumps.
  *
  * param
- *    [ in] tcm: pointer to the driver context
+ *    [ in] sync:      pointer to the clock synchronization
+ *    [ in] raw:       firmware timestamp in the report
+ *    [ in] bits:      width of the firmware timestamp
+ *    [ in] attn_time: time of ATTN for the report
  *
  * return
- *    0 or positive value in case of success, a negative value otherwise.
+ *    void.
  */
-static int syna_dev_create_input_device(struct syna_tcm *tcm)
+static void syna_dev_clock_sync_feed(struct syna_clock_sync *sync,
+	unsigned int raw, unsigned int bits, ktime_t attn_time)
 {
-	int retval = 0;
-	struct tcm_dev *tcm_dev = tcm->tcm_dev;
-	struct input_dev *input_dev = NULL;
-#ifdef DEV_MANAGED_API
-	struct device *dev = syna_request_managed_device();
-
+	s64 attn_ns = ktime_to_ns(attn_time);
+	s64 err_us;
+	u64 ticks;
+	unsigned int residual;
+
+	if ((sync->count > 0) && ((bits != sync->bits) ||
+		(ktime_ms_delta(attn_time, sync->last_attn) > CLOCK_SYNC_GAP_MS)))
+		syna_dev_clock_sync_restart(sync);
+
+	ticks = syna_dev_clock_sync_unwrap(sync, raw, bits, attn_time);
+
+	sync->bits = bits;
+	sync->last_raw = raw;
+	sync->last_attn = attn_time;
+	sync->epoch = ticks - raw;
+
+	/* a jump of the firmware clock */
+	if (sync->locked) {
+		err_us = div_s64(attn_ns - syna_dev_clock_sync_predict(sync, ticks),
+				NSEC_PER_USEC);
+		if ((err_us < -CLOCK_SYNC_RESYNC_US) || (err_us > CLOCK_SYNC_RESYNC_US)) {
+			sync->stats.resyncs++;
+			syna_dev_clock_sync_restart(sync);
+			ticks = raw;
+		}
+	}
+	sync->last_ticks = ticks;
+
+	sync->ticks[sync->head] = ticks;
+	sync->attn_ns[sync->head] = attn_ns;
+	sync->head = (sync->head + 1) & (CLOCK_SYNC_WINDOW - 1);
+	if (sync->count < CLOCK_SYNC_WINDOW)
+		sync->count++;
+	sync->stats.samples++;
+
+	if (sync->count < CLOCK_SYNC_MIN_SAMPLES)
+		return;
+
+	if (!syna_dev_clock_sync_fit(sync))
+		return;
+
+	sync->locked = true;
+
+	/* delay of the ATTN beyond the min. one */
+	residual = (unsigned int)div_s64(attn_ns -
+			syna_dev_clock_sync_predict(sync, ticks), NSEC_PER_USEC);
+	sync->stats.residual_us += residual;
+	sync->stats.residual_samples++;
+	if (residual > sync->stats.max_residual_us)
+		sync->stats.max_residual_us = residual;
+}
+/*
+ * Estimate the time of scan for the touch report.
+ *
+ * The firmware timestamp of report is fed to the clock synchronization once,
+ * then mapped onto the host monotonic clock by the model.
+ *
+ * param
+ *    [ in] tcm:         pointer to the driver context
+ *    [ in] report:      touch report data
+ *    [ in] report_size: size of the given report
+ *    [ in] attn_time:   time of ATTN for the report
+ *
+ * return
+ *    the time of scan estimated; or, the time of ATTN if not available.
+ */
+ktime_t syna_dev_sync_scan_time(struct syna_tcm *tcm,
+	const unsigned char *report, unsigned int report_size, ktime_t attn_time)
+{
+	struct syna_clock_sync *sync = &tcm->clock_sync;
+	ktime_t scan_time = attn_time;
+	unsigned int raw, bits;
+	u64 ticks;
+	bool fed = false;
+
+	if (ktime_to_ns(attn_time) == 0)
+		return attn_time;
+
+	if (syna_tcm_get_touch_timestamp(tcm->tcm_dev, report, report_size,
+		&raw, &bits) < 0)
+		return attn_time;
+
+	spin_lock(&sync->lock);
+
+	/* the same report may come from both the cdev and the input */
+	if (ktime_after(attn_time, sync->last_attn)) {
+		syna_dev_clock_sync_feed(sync, raw, bits, attn_time);
+		fed = true;
+	}
+
+	if (sync->locked) {
+		ticks = sync->epoch + raw;
+		/* an earlier report from before the wrap */
+		if ((!fed) && (raw > sync->last_raw) && (ticks >= BIT_ULL(MIN(bits, 32U))))
+			ticks -= BIT_ULL(MIN(bits, 32U));
+
+		scan_time = ns_to_ktime(syna_dev_clock_sync_predict(sync, ticks));
+		if (ktime_after(scan_time, attn_time))
+			scan_time = attn_time;
+	}
+
+	spin_unlock(&sync->lock);
+
+	return scan_time;
+}
+/*
+ * Restart the clock synchronization, as the firmware clock is restarted
+ * by the reset or power cycle.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+void syna_dev_reset_clock_sync(struct syna_tcm *tcm)
+{
+	struct syna_clock_sync *sync = &tcm->clock_sync;
+
+	spin_lock(&sync->lock);
+	syna_dev_clock_sync_restart(sync);
+	sync->last_attn = 0;
+	spin_unlock(&sync->lock);
+}
+#endif
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+/*
+ * Deliver the latest frame held to the input subsystem.
+ *
+ * In extrapolated mode, the positions of objects are moved forward along
+ * their velocities to the time of the vblank targeted.
+ * Called by the delivery work, or by the report context to flush a frame.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_vsync_deliver(struct syna_tcm *tcm)
+{
+	struct syna_vsync_delivery *vsync = &tcm->vsync;
+	struct tcm_objects_data_blob *object_data;
+	ktime_t now = ktime_get();
+	ktime_t target = 0;
+	ktime_t timestamp;
+	s64 dt_us = 0;
+	unsigned int phase_err;
+	unsigned int idx;
+	unsigned long flags;
+	bool timed;
+	s64 pos;
+
+	syna_pal_mutex_lock(&vsync->deliver_mutex);
+
+	spin_lock_irqsave(&vsync->lock, flags);
+
+	/* consumed even if nothing is pending, so a later delivery is not
+	 * taken as the one by the deadline
+	 */
+	timed = vsync->timed;
+	vsync->timed = false;
+
+	if (!vsync->pending) {
+		vsync->busy = false;
+		spin_unlock_irqrestore(&vsync->lock, flags);
+		goto exit;
+	}
+
+	syna_pal_mem_cpy(&vsync->out, sizeof(vsync->out),
+		&vsync->frame, sizeof(vsync->frame), sizeof(vsync->frame));
+	vsync->out.dirty_objects_mask = vsync->dirty;
+	vsync->dirty = 0;
+	vsync->pending = false;
+	timestamp = vsync->frame_time;
+
+	if (timed) {
+		phase_err = (unsigned int)abs(ktime_us_delta(now, vsync->deadline));
+		vsync->stats.phase_err_us += phase_err;
+		vsync->stats.phase_samples++;
+		if (phase_err > vsync->stats.max_phase_err_us)
+			vsync->stats.max_phase_err_us = phase_err;
+
+		target = ktime_add(vsync->vblank_time, vsync->period);
+		dt_us = ktime_us_delta(target, timestamp);
+		dt_us = clamp_t(s64, dt_us, 0, ktime_to_us(vsync->period));
+	}
+	vsync->stats.delivered++;
+	spin_unlock_irqrestore(&vsync->lock, flags);
+
+	if ((READ_ONCE(vsync->mode) == VSYNC_DELIVERY_EXTRAPOLATED) && (dt_us > 0)) {
+		object_data = &vsync->out.object_data[0];
+		for (idx = 0; idx < MAX_NUM_OBJECTS; idx++) {
+			if ((object_data[idx].status != FINGER) &&
+				(object_data[idx].status != GLOVED_OBJECT))
+				continue;
+
+			pos = object_data[idx].x_pos +
+				div_s64((s64)vsync->vx[idx] * dt_us, USEC_PER_SEC);
+			object_data[idx].x_pos = clamp_t(s64, pos, 0,
+				tcm->input_dev_params.max_x);
+			pos = object_data[idx].y_pos +
+				div_s64((s64)vsync->vy[idx] * dt_us, USEC_PER_SEC);
+			object_data[idx].y_pos = clamp_t(s64, pos, 0,
+				tcm->input_dev_params.max_y);
+		}
+		/* the positions are at the vblank */
+		timestamp = target;
+	}
+
+	syna_dev_report_input_events(tcm, &vsync->out, timestamp);
+
+	/* frames are reported in place again once nothing is held */
+	spin_lock_irqsave(&vsync->lock, flags);
+	if (!vsync->pending)
+		vsync->busy = false;
+	spin_unlock_irqrestore(&vsync->lock, flags);
+
+exit:
+	syna_pal_mutex_unlock(&vsync->deliver_mutex);
+}
+/*
+ * Work to deliver the frame held.
+ *
+ * param
+ *    [ in] work: pointer to the work_struct
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_vsync_deliver_work(struct work_struct *work)
+{
+	struct syna_vsync_delivery *vsync =
+			container_of(work, struct syna_vsync_delivery, deliver_work);
+	struct syna_tcm *tcm =
+			container_of(vsync, struct syna_tcm, vsync);
+
+	syna_dev_vsync_deliver(tcm);
+}
+/*
+ * Timer of the delivery deadline ahead of the vblank.
+ *
+ * param
+ *    [ in] timer: pointer to the hrtimer
+ *
+ * return
+ *    HRTIMER_NORESTART, re-armed by the next vblank.
+ */
+static enum hrtimer_restart syna_dev_vsync_timer(struct hrtimer *timer)
+{
+	struct syna_vsync_delivery *vsync =
+			container_of(timer, struct syna_vsync_delivery, timer);
+
+	spin_lock(&vsync->lock);
+	vsync->timed = true;
+	spin_unlock(&vsync->lock);
+
+	queue_work(system_highpri_wq, &vsync->deliver_work);
+
+	return HRTIMER_NORESTART;
+}
+/*
+ * Vblank work, timestamping the vblank and arming the deadline of the
+ * next delivery.
+ *
+ * The tracking is stopped after the vblanks without any frame, so the
+ * vblank interrupt of display is not kept on while the panel is untouched.
+ *
+ * param
+ *    [ in] work: pointer to the kthread_work of vblank work
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_vsync_vblank_work(struct kthread_work *work)
+{
+	struct syna_vsync_delivery *vsync =
+			container_of(to_drm_vblank_work(work),
+				struct syna_vsync_delivery, vblank_work);
+	struct drm_crtc *crtc;
+	ktime_t vblank_time;
+	ktime_t predicted;
+	ktime_t lead;
+	u64 count;
+	u64 framedur_ns;
+	unsigned int predict_err;
+	unsigned long flags;
+
+	spin_lock_irqsave(&vsync->lock, flags);
+
+	crtc = vsync->crtc;
+	if (!crtc || !vsync->tracking)
+		goto exit;
+
+	/* turned off, no more deadline is armed */
+	if (READ_ONCE(vsync->mode) == VSYNC_DELIVERY_OFF) {
+		vsync->tracking = false;
+		vsync->vblank_time = 0;
+		goto exit;
+	}
+
+	count = drm_crtc_vblank_count_and_time(crtc, &vblank_time);
+	vsync->stats.vblanks++;
+
+	/* how well the previous vblank predicted this one */
+	if ((ktime_to_ns(vsync->vblank_time) != 0) &&
+		(count == vsync->vblank_count + 1)) {
+		predicted = ktime_add(vsync->vblank_time, vsync->period);
+		predict_err = (unsigned int)abs(ktime_us_delta(vblank_time, predicted));
+		vsync->stats.predict_err_us += predict_err;
+		vsync->stats.predict_samples++;
+		if (predict_err > vsync->stats.max_predict_err_us)
+			vsync->stats.max_predict_err_us = predict_err;
+	}
+
+	framedur_ns = crtc->dev->vblank[drm_crtc_index(crtc)].framedur_ns;
+	if (framedur_ns != 0)
+		vsync->period = ns_to_ktime(framedur_ns);
+	else if ((ktime_to_ns(vsync->vblank_time) != 0) &&
+		(count == vsync->vblank_count + 1))
+		vsync->period = ktime_sub(vblank_time, vsync->vblank_time);
+
+	vsync->vblank_time = vblank_time;
+	vsync->vblank_count = count;
+
+	if (vsync->frames == 0) {
+		if (++vsync->idle_vblanks >= VSYNC_IDLE_VBLANKS) {
+			vsync->tracking = false;
+			vsync->vblank_time = 0;
+			goto exit;
+		}
+	} else {
+		vsync->idle_vblanks = 0;
+	}
+	vsync->frames = 0;
+
+	if (drm_vblank_work_schedule(&vsync->vblank_work, count + 1, true) < 0) {
+		vsync->tracking = false;
+		vsync->vblank_time = 0;
+		goto exit;
+	}
+
+	if (ktime_to_ns(vsync->period) == 0)
+		goto exit;
+
+	/* no more than a half of period ahead */
+	lead = ns_to_ktime(MIN((u64)vsync->lead_us * NSEC_PER_USEC,
+			(u64)ktime_to_ns(vsync->period) / 2));
+	vsync->deadline = ktime_sub(ktime_add(vblank_time, vsync->period), lead);
+	hrtimer_start(&vsync->timer, vsync->deadline, HRTIMER_MODE_ABS);
+
+exit:
+	spin_unlock_irqrestore(&vsync->lock, flags);
+}
+/*
+ * Check whether a slot lifted in the frame held is touched again in the
+ * new frame, so coalescing them would hide the lift.
+ * Called with the lock held.
+ *
+ * param
+ *    [ in] vsync:      pointer to the vsync-aligned delivery
+ *    [ in] touch_data: the new frame
+ *
+ * return
+ *    true if the frame held has to be delivered first.
+ */
+static bool syna_dev_vsync_lift_held(struct syna_vsync_delivery *vsync,
+	struct tcm_touch_data_blob *touch_data)
+{
+	unsigned int idx;
+
+	if (!vsync->pending)
+		return false;
+
+	for (idx = 0; idx < MAX_NUM_OBJECTS; idx++) {
+		if (!(vsync->dirty & (1U << idx)))
+			continue;
+
+		if ((vsync->frame.object_data[idx].status == LIFT) &&
+			(touch_data->object_data[idx].status != LIFT))
+			return true;
+	}
+
+	return false;
+}
+/*
+ * Hold the frame parsed until the next vblank.
+ *
+ * The frames held in the same period are coalesced to the latest one; the
+ * velocities of objects are updated for the extrapolation.
+ * If no vblank is tracked yet, the tracking is started and the frame is
+ * delivered at once. Once turned off, the frames are still queued behind
+ * the one held or being delivered, and then delivered at once.
+ *
+ * param
+ *    [ in] tcm:       pointer to the driver context
+ *    [ in] timestamp: time of ATTN for the frame; or, zero if unknown
+ *
+ * return
+ *    true if the frame is held; false to report it in place.
+ */
+static bool syna_dev_vsync_hold_frame(struct syna_tcm *tcm, ktime_t timestamp)
+{
+	struct syna_vsync_delivery *vsync = &tcm->vsync;
+	struct tcm_touch_data_blob *touch_data = &tcm->tp_data;
+	struct tcm_objects_data_blob *prev, *curr;
+	unsigned int mode = READ_ONCE(vsync->mode);
+	unsigned int idx;
+	unsigned long flags;
+	s64 dt_us;
+
+	if (tcm->pwr_state != PWR_ON)
+		return false;
+
+	/* busy is only set by this context, so it is read without the lock */
+	if ((mode == VSYNC_DELIVERY_OFF) && !READ_ONCE(vsync->busy))
+		return false;
+
+	if (ktime_to_ns(timestamp) == 0)
+		timestamp = ktime_get();
+
+	spin_lock_irqsave(&vsync->lock, flags);
+
+	if (!vsync->crtc) {
+		spin_unlock_irqrestore(&vsync->lock, flags);
+		return false;
+	}
+
+	/* a lift followed by a touch is never merged into one contact */
+	if (syna_dev_vsync_lift_held(vsync, touch_data)) {
+		spin_unlock_irqrestore(&vsync->lock, flags);
+		syna_dev_vsync_deliver(tcm);
+		spin_lock_irqsave(&vsync->lock, flags);
+	}
+
+	if ((mode != VSYNC_DELIVERY_OFF) && !vsync->tracking) {
+		vsync->idle_vblanks = 0;
+		vsync->vblank_time = 0;
+		if (drm_vblank_work_schedule(&vsync->vblank_work,
+			drm_crtc_vblank_count(vsync->crtc) + 1, true) >= 0)
+			vsync->tracking = true;
+	}
+
+	/* velocities from the frame held previously */
+	dt_us = ktime_us_delta(timestamp, vsync->frame_time);
+	for (idx = 0; idx < MAX_NUM_OBJECTS; idx++) {
+		prev = &vsync->frame.object_data[idx];
+		curr = &touch_data->object_data[idx];
+		if ((dt_us <= 0) || (dt_us > VSYNC_VELOCITY_WINDOW_MS * USEC_PER_MSEC) ||
+			(prev->status == LIFT) || (curr->status == LIFT)) {
+			vsync->vx[idx] = 0;
+			vsync->vy[idx] = 0;
+			continue;
+		}
+		vsync->vx[idx] = (int)div_s64(((s64)curr->x_pos - prev->x_pos) *
+				USEC_PER_SEC, dt_us);
+		vsync->vy[idx] = (int)div_s64(((s64)curr->y_pos - prev->y_pos) *
+				USEC_PER_SEC, dt_us);
+	}
+
+	if (vsync->pending)
+		vsync->stats.coalesced++;
+
+	syna_pal_mem_cpy(&vsync->frame, sizeof(vsync->frame),
+		touch_data, sizeof(*touch_data), sizeof(*touch_data));
+	vsync->dirty |= touch_data->dirty_objects_mask;
+	vsync->frame_time = timestamp;
+	vsync->pending = true;
+	vsync->busy = true;
+
+	/* no deadline armed before the first vblank tracked, or once off */
+	if (mode == VSYNC_DELIVERY_OFF)
+		queue_work(system_highpri_wq, &vsync->deliver_work);
+	else if (ktime_to_ns(vsync->vblank_time) == 0)
+		queue_work(system_highpri_wq, &vsync->deliver_work);
+
+	if (mode != VSYNC_DELIVERY_OFF)
+		vsync->frames++;
+
+	spin_unlock_irqrestore(&vsync->lock, flags);
+
+	return true;
+}
+/*
+ * Stop the tracking of vblank, the frame held is dropped.
+ *
+ * param
+ *    [ in] tcm:    pointer to the driver context
+ *    [ in] detach: true to detach from the crtc as well
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_stop_vsync_delivery(struct syna_tcm *tcm, bool detach)
+{
+	struct syna_vsync_delivery *vsync = &tcm->vsync;
+	unsigned long flags;
+	bool attached;
+
+	syna_pal_mutex_lock(&vsync->mutex);
+
+	spin_lock_irqsave(&vsync->lock, flags);
+	attached = (vsync->crtc != NULL);
+	vsync->tracking = false;
+	vsync->vblank_time = 0;
+	vsync->pending = false;
+	vsync->busy = false;
+	vsync->timed = false;
+	vsync->dirty = 0;
+	if (detach)
+		vsync->crtc = NULL;
+	spin_unlock_irqrestore(&vsync->lock, flags);
+
+	if (attached)
+		drm_vblank_work_cancel_sync(&vsync->vblank_work);
+	hrtimer_cancel(&vsync->timer);
+	cancel_work_sync(&vsync->deliver_work);
+
+	syna_pal_mutex_unlock(&vsync->mutex);
+}
+/*
+ * Attach the delivery to the crtc driving the panel.
+ *
+ * param
+ *    [ in] tcm:  pointer to the driver context
+ *    [ in] crtc: crtc the panel bridge is attached to
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_attach_vsync_delivery(struct syna_tcm *tcm,
+	struct drm_crtc *crtc)
+{
+	struct syna_vsync_delivery *vsync = &tcm->vsync;
+	unsigned long flags;
+
+	syna_dev_stop_vsync_delivery(tcm, true);
+
+	if (!crtc)
+		return;
+
+	syna_pal_mutex_lock(&vsync->mutex);
+
+	drm_vblank_work_init(&vsync->vblank_work, crtc,
+		syna_dev_vsync_vblank_work);
+
+	spin_lock_irqsave(&vsync->lock, flags);
+	vsync->crtc = crtc;
+	vsync->period = 0;
+	spin_unlock_irqrestore(&vsync->lock, flags);
+
+	syna_pal_mutex_unlock(&vsync->mutex);
+
+	LOGD("Vsync delivery attached to crtc %d\n", drm_crtc_index(crtc));
+}
+/*
+ * Change the mode and lead time of the vsync-aligned delivery.
+ *
+ * param
+ *    [ in] tcm:     pointer to the driver context
+ *    [ in] mode:    enum vsync_delivery_mode
+ *    [ in] lead_us: time to deliver ahead of the vblank
+ *
+ * return
+ *    void.
+ */
+void syna_dev_set_vsync_delivery(struct syna_tcm *tcm, unsigned int mode,
+	unsigned int lead_us)
+{
+	struct syna_vsync_delivery *vsync = &tcm->vsync;
+
+	syna_pal_mutex_lock(&vsync->mutex);
+	vsync->lead_us = lead_us;
+	WRITE_ONCE(vsync->mode, mode);
+	syna_pal_mutex_unlock(&vsync->mutex);
+
+	/* once turned off, the frame held is delivered now rather than by the
+	 * deadline armed, and the tracking stops at the next vblank
+	 */
+	if (mode == VSYNC_DELIVERY_OFF) {
+		hrtimer_cancel(&vsync->timer);
+		syna_dev_vsync_deliver(tcm);
+	}
+
+	LOGI("Vsync delivery: %s, lead %u us\n",
+		(mode == VSYNC_DELIVERY_EXTRAPOLATED) ? "extrapolated" :
+		(mode == VSYNC_DELIVERY_LATEST) ? "latest" : "off", lead_us);
+}
+/*
+ * Initialize the vsync-aligned delivery, off by default.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_init_vsync_delivery(struct syna_tcm *tcm)
+{
+	struct syna_vsync_delivery *vsync = &tcm->vsync;
+
+	syna_pal_mem_set(vsync, 0, sizeof(*vsync));
+	syna_pal_mutex_alloc(&vsync->mutex);
+	syna_pal_mutex_alloc(&vsync->deliver_mutex);
+	spin_lock_init(&vsync->lock);
+	INIT_WORK(&vsync->deliver_work, syna_dev_vsync_deliver_work);
+#if (KERNEL_VERSION(6, 13, 0) <= LINUX_VERSION_CODE)
+	hrtimer_setup(&vsync->timer, syna_dev_vsync_timer,
+		CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+#else
+	hrtimer_init(&vsync->timer, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+	vsync->timer.function = syna_dev_vsync_timer;
+#endif
+	vsync->mode = VSYNC_DELIVERY_OFF;
+	vsync->lead_us = VSYNC_LEAD_US_DEFAULT;
+}
+#endif
+/*
+ * Parse the touch report and then report the events to the input subsystem.
+ *
+ * param
+ *    [ in] tcm:         pointer to the driver context
+ *    [ in] report:      touch report data
+ *    [ in] report_size: size of the given report
+ *    [ in] timestamp:   time of ATTN for the report; or, zero if unknown
+ *
+ * return
+ *    on success, 0 or positive value; otherwise, negative value on error.
+ */
+static int syna_dev_handle_touch_report(struct syna_tcm *tcm,
+	const unsigned char *report, unsigned int report_size, ktime_t timestamp)
+{
+	int retval;
+
+	/* parse touch report once received */
+	retval = syna_tcm_parse_touch_report(tcm->tcm_dev,
+			(unsigned char *)report,
+			report_size,
+			&tcm->tp_data);
+	if (retval < 0) {
+		LOGE("Fail to parse touch report\n");
+		return retval;
+	}
+	syna_dev_publish_touch_data(tcm);
+
+#if defined(ENABLE_CLOCK_SYNC)
+	/* stamp the events with the time of scan */
+	timestamp = syna_dev_sync_scan_time(tcm, report, report_size, timestamp);
+#endif
+
+	/* report the touch event to system */
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	/* unless held until the next vblank */
+	if (!syna_dev_vsync_hold_frame(tcm, timestamp))
+#endif
+	syna_dev_report_input_events(tcm, &tcm->tp_data, timestamp);
+#if defined(TOUCHCOMM_TDDI) && defined(REPORT_KNOB)
+	/* report the knob event to system */
+	syna_dev_report_input_knob_events(tcm);
+#endif
+	return 0;
+}
+
+/*
+ * Set the rt priority of the given thread.
+ *
+ * param
+ *    [ in] task: the thread
+ *    [ in] prio: rt priority, '0' to use the default of irq threads
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_dev_set_thread_priority(struct task_struct *task,
+	unsigned int prio)
+{
+	int retval;
+#if (KERNEL_VERSION(5, 9, 0) <= LINUX_VERSION_CODE)
+	struct sched_attr attr = {
+		.size = sizeof(attr),
+		.sched_policy = SCHED_FIFO,
+		.sched_priority = (prio > 0) ? prio : MAX_RT_PRIO / 2,
+	};
+
+	retval = sched_setattr_nocheck(task, &attr);
+#else
+	struct sched_param param = {
+		.sched_priority = (prio > 0) ? prio : MAX_RT_PRIO / 2,
+	};
+
+	retval = sched_setscheduler_nocheck(task, SCHED_FIFO, &param);
+#endif
+	if (retval < 0)
+		LOGE("Fail to set priority %d to %s\n", prio, task->comm);
+
+	return retval;
+}
+
+#if defined(ENABLE_TOUCH_BOOST)
+/*
+ * Update the cpu latency request.
+ *
+ * param
+ *    [ in] qos:   pointer to the request
+ *    [ in] value: latency in microseconds, or PM_QOS_DEFAULT_VALUE to drop
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_update_cpu_latency(struct pm_qos_request *qos, s32 value)
+{
+#if (KERNEL_VERSION(5, 7, 0) <= LINUX_VERSION_CODE)
+	cpu_latency_qos_update_request(qos, value);
+#else
+	pm_qos_update_request(qos, value);
+#endif
+}
+/*
+ * Clamp the utilization of the given task from the bottom.
+ *
+ * The driver threads are in RT class, which requests the maximum frequency
+ * by default; the clamp takes effect on the platform lowering the default
+ * of RT tasks through sched_util_clamp_min_rt_default.
+ *
+ * param
+ *    [ in] task:     the task to clamp
+ *    [ in] util_min: minimum utilization, 0 ~ SCHED_CAPACITY_SCALE
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_set_uclamp_min(struct task_struct *task,
+	unsigned int util_min)
+{
+#if defined(CONFIG_UCLAMP_TASK) && (KERNEL_VERSION(5, 9, 0) <= LINUX_VERSION_CODE)
+	struct sched_attr attr = {
+		.size = sizeof(attr),
+		.sched_policy = (unsigned int)-1,
+		.sched_flags = SCHED_FLAG_KEEP_ALL | SCHED_FLAG_UTIL_CLAMP_MIN,
+		.sched_util_min = util_min,
+	};
+
+	if (sched_setattr_nocheck(task, &attr) < 0)
+		LOGW("Fail to clamp utilization of %s\n", task->comm);
+#endif
+}
+/*
+ * Drop the clamp applied to the given task.
+ *
+ * param
+ *    [ in] task:  the task clamped
+ *    [ in] saved: minimum utilization before the clamp
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_reset_uclamp_min(struct task_struct *task,
+	unsigned int saved)
+{
+#if (KERNEL_VERSION(5, 11, 0) <= LINUX_VERSION_CODE)
+	/* back to the system default, rather than a clamp defined by user */
+	syna_dev_set_uclamp_min(task, (unsigned int)-1);
+#else
+	syna_dev_set_uclamp_min(task, saved);
+#endif
+}
+/*
+ * Clamp or release all the threads of the driver.
+ *
+ * The caller has to hold the mutex of boost.
+ *
+ * param
+ *    [ in] boost: pointer to the touch boost
+ *    [ in] on:    true to clamp; false to release
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_touch_boost_apply(struct syna_touch_boost *boost, bool on)
+{
+	struct task_struct *task;
+	int idx;
+
+	for (idx = 0; idx < TOUCH_BOOST_THREADS; idx++) {
+		task = boost->threads[idx].task;
+		if (!task)
+			continue;
+
+		if (on) {
+#if defined(CONFIG_UCLAMP_TASK)
+			boost->threads[idx].saved_uclamp_min =
+				task->uclamp_req[UCLAMP_MIN].value;
+#endif
+			syna_dev_set_uclamp_min(task, boost->uclamp_min);
+		} else {
+			syna_dev_reset_uclamp_min(task,
+				boost->threads[idx].saved_uclamp_min);
+		}
+	}
+}
+/*
+ * Register the thread of the driver to be clamped while boosting,
+ * or unregister it if the task is NULL.
+ *
+ * param
+ *    [ in] tcm:    pointer to the driver context
+ *    [ in] thread: the slot of thread, TOUCH_BOOST_IRQ_THREAD, etc.
+ *    [ in] task:   the thread; NULL to unregister
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_touch_boost_attach(struct syna_tcm *tcm,
+	unsigned int thread, struct task_struct *task)
+{
+	struct syna_touch_boost *boost = &tcm->boost;
+	struct task_struct *old;
+
+	syna_pal_mutex_lock(&boost->mutex);
+
+	old = boost->threads[thread].task;
+	if (old) {
+		if (boost->active)
+			syna_dev_reset_uclamp_min(old,
+				boost->threads[thread].saved_uclamp_min);
+		put_task_struct(old);
+	}
+
+	boost->threads[thread].task = (task) ? get_task_struct(task) : NULL;
+
+	if (task && boost->active) {
+#if defined(CONFIG_UCLAMP_TASK)
+		boost->threads[thread].saved_uclamp_min =
+			task->uclamp_req[UCLAMP_MIN].value;
+#endif
+		syna_dev_set_uclamp_min(task, boost->uclamp_min);
+	}
+
+	syna_pal_mutex_unlock(&boost->mutex);
+}
+/*
+ * Take the boost once a touch report arrives, and extend the time to
+ * release it.
+ *
+ * Only the time of report is recorded when the boost is already taken,
+ * the release work re-arms itself for the rest of the idle time.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_touch_boost_on(struct syna_tcm *tcm)
+{
+	struct syna_touch_boost *boost = &tcm->boost;
+	unsigned int idle_ms = READ_ONCE(boost->idle_ms);
+
+	if (idle_ms == 0)
+		return;
+
+	/* no boost for the gesture reports in low power mode */
+	if (tcm->pwr_state != PWR_ON)
+		return;
+
+	WRITE_ONCE(boost->last_report, jiffies);
+
+	if (READ_ONCE(boost->active))
+		return;
+
+	syna_pal_mutex_lock(&boost->mutex);
+	if (!boost->active) {
+		syna_dev_update_cpu_latency(&boost->qos, boost->latency_us);
+		syna_dev_touch_boost_apply(boost, true);
+		WRITE_ONCE(boost->active, true);
+		boost->stats.on++;
+
+		queue_delayed_work(system_wq, &boost->release_work,
+			msecs_to_jiffies(idle_ms));
+	}
+	syna_pal_mutex_unlock(&boost->mutex);
+}
+/*
+ * Drop the boost taken.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_touch_boost_off(struct syna_tcm *tcm)
+{
+	struct syna_touch_boost *boost = &tcm->boost;
+
+	syna_pal_mutex_lock(&boost->mutex);
+
+	if (boost->active) {
+		syna_dev_update_cpu_latency(&boost->qos, PM_QOS_DEFAULT_VALUE);
+		syna_dev_touch_boost_apply(boost, false);
+		WRITE_ONCE(boost->active, false);
+		boost->stats.off++;
+	}
+
+	syna_pal_mutex_unlock(&boost->mutex);
+}
+/*
+ * Work to release the boost after the idle time.
+ * The boost is kept as long as any slot is still being touched, or
+ * the last report is within the idle time.
+ *
+ * param
+ *    [ in] work: pointer to the work_struct
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_touch_boost_work(struct work_struct *work)
+{
+	struct syna_touch_boost *boost = container_of(to_delayed_work(work),
+			struct syna_touch_boost, release_work);
+	struct syna_tcm *tcm = container_of(boost, struct syna_tcm, boost);
+	unsigned long idle = msecs_to_jiffies(READ_ONCE(boost->idle_ms));
+	unsigned long expires = READ_ONCE(boost->last_report) + idle;
+
+	if ((idle > 0) && (tcm->pwr_state == PWR_ON)) {
+		if (READ_ONCE(tcm->touching_objects) != 0) {
+			queue_delayed_work(system_wq, &boost->release_work, idle);
+			return;
+		}
+		if (time_before(jiffies, expires)) {
+			queue_delayed_work(system_wq, &boost->release_work,
+				expires - jiffies);
+			return;
+		}
+	}
+
+	syna_dev_touch_boost_off(tcm);
+}
+/*
+ * Drop the boost immediately, and stop the pending release.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_stop_touch_boost(struct syna_tcm *tcm)
+{
+	cancel_delayed_work_sync(&tcm->boost.release_work);
+	syna_dev_touch_boost_off(tcm);
+}
+/*
+ * Change the thresholds of touch boost.
+ *
+ * param
+ *    [ in] tcm:        pointer to the driver context
+ *    [ in] latency_us: cpu latency requested while boosting
+ *    [ in] idle_ms:    idle time to release the boost; 0 to disable
+ *    [ in] uclamp_min: minimum utilization of the threads while boosting
+ *
+ * return
+ *    void.
+ */
+void syna_dev_set_touch_boost(struct syna_tcm *tcm, unsigned int latency_us,
+	unsigned int idle_ms, unsigned int uclamp_min)
+{
+	struct syna_touch_boost *boost = &tcm->boost;
+	int idx;
+
+	if (idle_ms == 0)
+		syna_dev_stop_touch_boost(tcm);
+
+	syna_pal_mutex_lock(&boost->mutex);
+
+	boost->latency_us = latency_us;
+	boost->uclamp_min = MIN(uclamp_min, SCHED_CAPACITY_SCALE);
+	WRITE_ONCE(boost->idle_ms, idle_ms);
+
+	/* apply to the boost being taken */
+	if (boost->active) {
+		syna_dev_update_cpu_latency(&boost->qos, boost->latency_us);
+		for (idx = 0; idx < TOUCH_BOOST_THREADS; idx++) {
+			if (boost->threads[idx].task)
+				syna_dev_set_uclamp_min(boost->threads[idx].task,
+					boost->uclamp_min);
+		}
+	}
+
+	syna_pal_mutex_unlock(&boost->mutex);
+}
+/*
+ * Initialize the touch boost.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_init_touch_boost(struct syna_tcm *tcm)
+{
+	struct syna_touch_boost *boost = &tcm->boost;
+
+	syna_pal_mutex_alloc(&boost->mutex);
+	INIT_DELAYED_WORK(&boost->release_work, syna_dev_touch_boost_work);
+
+#if (KERNEL_VERSION(5, 7, 0) <= LINUX_VERSION_CODE)
+	cpu_latency_qos_add_request(&boost->qos, PM_QOS_DEFAULT_VALUE);
+#else
+	pm_qos_add_request(&boost->qos, PM_QOS_CPU_DMA_LATENCY, PM_QOS_DEFAULT_VALUE);
+#endif
+
+	boost->latency_us = TOUCH_BOOST_LATENCY_US_DEFAULT;
+	boost->idle_ms = TOUCH_BOOST_IDLE_MS_DEFAULT;
+	boost->uclamp_min = TOUCH_BOOST_UCLAMP_MIN_DEFAULT;
+}
+/*
+ * Release the touch boost.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_release_touch_boost(struct syna_tcm *tcm)
+{
+	struct syna_touch_boost *boost = &tcm->boost;
+	int idx;
+
+	syna_dev_stop_touch_boost(tcm);
+
+	for (idx = 0; idx < TOUCH_BOOST_THREADS; idx++)
+		syna_dev_touch_boost_attach(tcm, idx, NULL);
+
+#if (KERNEL_VERSION(5, 7, 0) <= LINUX_VERSION_CODE)
+	cpu_latency_qos_remove_request(&boost->qos);
+#else
+	pm_qos_remove_request(&boost->qos);
+#endif
+
+	syna_pal_mutex_free(&boost->mutex);
+}
+#endif
+
+#if defined(ENABLE_REPORT_PIPELINE)
+/*
+ * Worker of the report stage.
+ *
+ * Parse and report the touch reports queued by the IRQ thread in order,
+ * then drop the frames held.
+ *
+ * param
+ *    [ in] work: pointer to the work_struct
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_report_work(struct kthread_work *work)
+{
+	struct syna_report_pipeline *pipe =
+			container_of(work, struct syna_report_pipeline, work);
+	struct syna_tcm *tcm =
+			container_of(pipe, struct syna_tcm, report_pipe);
+	struct report_pipeline_stats *stats = &pipe->stats;
+	struct syna_report_entry entry;
+	unsigned int elapsed;
+
+	while (kfifo_get(&pipe->ring, &entry)) {
+		syna_dev_handle_touch_report(tcm,
+				&entry.frame->buf[MESSAGE_HEADER_SIZE],
+				entry.length,
+				entry.attn_time);
+
+		syna_tcm_release_frame(entry.frame);
+
+		elapsed = (unsigned int)ktime_us_delta(ktime_get(), entry.fetch_time);
+		spin_lock(&pipe->lock);
+		stats->report_us += elapsed;
+		if (elapsed > stats->max_report_us)
+			stats->max_report_us = elapsed;
+		spin_unlock(&pipe->lock);
+	}
+}
+/*
+ * Queue the touch report to the report stage.
+ *
+ * Rather than copying, the frame of report is held until it is processed
+ * by the worker, so the next report is read into another frame.
+ * If the ring is full, wait for the worker to catch up. If the frame can't
+ * be held, the worker is drained before returning, so the report processed
+ * in place neither races with the worker nor overtakes the queued ones.
+ *
+ * param
+ *    [ in] tcm:         pointer to the driver context
+ *    [ in] report:      touch report data
+ *    [ in] report_size: size of the given report
+ *
+ * return
+ *    0 in case of success; otherwise, a negative value if the report
+ *    is not queued and shall be processed in place.
+ */
+static int syna_dev_queue_touch_report(struct syna_tcm *tcm,
+	const unsigned char *report, unsigned int report_size)
+{
+	struct syna_report_pipeline *pipe = &tcm->report_pipe;
+	struct report_pipeline_stats *stats = &pipe->stats;
+	struct syna_report_entry entry;
+	unsigned int depth;
+	unsigned int elapsed;
+
+	if (!pipe->worker)
+		return -ENODEV;
+
+	entry.frame = syna_tcm_hold_frame(tcm->tcm_dev);
+	if ((!entry.frame) ||
+		(report != &entry.frame->buf[MESSAGE_HEADER_SIZE]) ||
+		(entry.frame->buf_size < MESSAGE_HEADER_SIZE + report_size)) {
+		syna_tcm_release_frame(entry.frame);
+
+		spin_lock(&pipe->lock);
+		stats->in_place++;
+		spin_unlock(&pipe->lock);
+		kthread_flush_work(&pipe->work);
+		return -EINVAL;
+	}
+
+	entry.length = report_size;
+	entry.attn_time = tcm->irq_timestamp;
+	entry.fetch_time = ktime_get();
+
+	if (kfifo_is_full(&pipe->ring)) {
+		spin_lock(&pipe->lock);
+		stats->stalls++;
+		spin_unlock(&pipe->lock);
+		kthread_flush_work(&pipe->work);
+	}
+
+	kfifo_put(&pipe->ring, entry);
+	kthread_queue_work(pipe->worker, &pipe->work);
+
+	depth = kfifo_len(&pipe->ring);
+
+	spin_lock(&pipe->lock);
+	if (depth > stats->max_depth)
+		stats->max_depth = depth;
+
+	stats->queued++;
+	if (ktime_to_ns(entry.attn_time) != 0) {
+		elapsed = (unsigned int)ktime_us_delta(entry.fetch_time, entry.attn_time);
+		stats->fetch_us += elapsed;
+		if (elapsed > stats->max_fetch_us)
+			stats->max_fetch_us = elapsed;
+	}
+	spin_unlock(&pipe->lock);
+
+	return 0;
+}
+/*
+ * Wait until all reports queued to the report stage are processed.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_flush_report_pipeline(struct syna_tcm *tcm)
+{
+	if (!tcm->report_pipe.worker)
+		return;
+
+	kthread_flush_work(&tcm->report_pipe.work);
+}
+/*
+ * Create the worker of report stage.
+ * Reports are processed in place by the IRQ thread if it fails.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_create_report_pipeline(struct syna_tcm *tcm)
+{
+	struct syna_report_pipeline *pipe = &tcm->report_pipe;
+
+	INIT_KFIFO(pipe->ring);
+	kthread_init_work(&pipe->work, syna_dev_report_work);
+	spin_lock_init(&pipe->lock);
+	syna_pal_mem_set(&pipe->stats, 0, sizeof(pipe->stats));
+
+	pipe->worker = kthread_create_worker(0, "syna_tcm_report");
+	if (IS_ERR(pipe->worker)) {
+		LOGW("Fail to create report worker, process reports in place\n");
+		pipe->worker = NULL;
+		return;
+	}
+
+	/* the same scheduling as the threaded irq handler */
+	syna_dev_set_thread_priority(pipe->worker->task, tcm->irq_sched.prio);
+	if (!cpumask_empty(&tcm->irq_sched.cpus))
+		set_cpus_allowed_ptr(pipe->worker->task, &tcm->irq_sched.cpus);
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_touch_boost_attach(tcm, TOUCH_BOOST_REPORT_THREAD,
+		pipe->worker->task);
+#endif
+}
+/*
+ * Release the worker of report stage as well as the frames still queued.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_release_report_pipeline(struct syna_tcm *tcm)
+{
+	struct syna_report_pipeline *pipe = &tcm->report_pipe;
+	struct syna_report_entry entry;
+
+	if (!pipe->worker)
+		return;
+
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_touch_boost_attach(tcm, TOUCH_BOOST_REPORT_THREAD, NULL);
+#endif
+	kthread_cancel_work_sync(&pipe->work);
+	kthread_destroy_worker(pipe->worker);
+	pipe->worker = NULL;
+
+	while (kfifo_get(&pipe->ring, &entry))
+		syna_tcm_release_frame(entry.frame);
+}
+#endif
+
+/*
+ * Process the touch report.
+ *
+ * param
+ *    [ in]    code:          the report type in the given report
+ *    [ in]    report:        report data
+ *    [ in]    report_size:   size of the given report
+ *    [ in]    callback_data: private data being passed to the callback function
+ *
+ * return
+ *    on success, 0 or positive value; otherwise, negative value on error.
+ */
+static int syna_dev_process_touch_report(const unsigned char code,
+	const unsigned char *report, unsigned int report_size,
+	void *callback_data)
+{
+	struct syna_tcm *tcm = (struct syna_tcm *)callback_data;
+
+	if (!tcm) {
+		LOGE("Invalid callback data\n");
+		return -EINVAL;
+	}
+
+	if (code != REPORT_TOUCH) {
+		LOGE("Invalid report to process, report:%d\n", code);
+		return -EINVAL;
+	}
+
+	/* not report to input device subsystem if the cdev interface is in used */
+	if ((tcm->char_dev_ref_count > 0) && !tcm->concurrent_reporting)
+		return 0;
+
+#if defined(ENABLE_TOUCH_BOOST)
+	/* keep the cpu responsive while the touch reports are arriving */
+	syna_dev_touch_boost_on(tcm);
+#endif
+#if defined(ENABLE_REPORT_PIPELINE)
+	/* hand over to the report stage, so the next report can be fetched */
+	if (syna_dev_queue_touch_report(tcm, report, report_size) == 0)
+		return 0;
+#endif
+
+	return syna_dev_handle_touch_report(tcm, report, report_size,
+			tcm->irq_timestamp);
+}
+
+#if defined(TOUCHCOMM_TDDI) && defined(REPORT_KNOB)
+/*
+ * Allocate an input device for knob and set up relevant parameters
+ * to the input subsystem.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_dev_create_input_knob_device(struct syna_tcm *tcm)
+{
+	int retval = 0;
+	int idx = 0;
+#ifdef DEV_MANAGED_API
+	struct device *dev;
+#endif
+
+#ifdef DEV_MANAGED_API
+	dev = syna_request_managed_device();
+
+	if (!dev) {
+		LOGE("Invalid managed device\n");
+		return -EINVAL;
+	}
+#endif
+
+	for (idx = 0; idx < MAX_NUM_KNOB_OBJECTS; idx++) {
+#ifndef HAVE_THE_SECOND_KNOB
+		if (idx > 0)
+			break;
+#endif
+		if (tcm->input_knob_dev[idx]) {
+			input_unregister_device(tcm->input_knob_dev[idx]);
+			tcm->input_knob_dev[idx] = NULL;
+		}
+
+#ifdef DEV_MANAGED_API
+		tcm->input_knob_dev[idx] = devm_input_allocate_device(dev);
+#else /* Legacy API */
+		tcm->input_knob_dev[idx] = input_allocate_device();
+#endif
+		if (tcm->input_knob_dev[idx] == NULL) {
+			LOGE("Fail to allocate input device %d for knob\n", idx);
+			break;
+		}
+
+		tcm->input_knob_dev[idx]->name = KNOB_INPUT_NAME;
+		tcm->input_knob_dev[idx]->phys = KNOB_INPUT_PHYS_PATH;
+		tcm->input_knob_dev[idx]->id.product = SYNAPTICS_TCM_DRIVER_ID;
+		tcm->input_knob_dev[idx]->id.version = SYNAPTICS_TCM_DRIVER_VERSION;
+		tcm->input_knob_dev[idx]->dev.parent = tcm->pdev->dev.parent;
+		input_set_drvdata(tcm->input_knob_dev[idx], tcm);
+
+		input_set_capability(tcm->input_knob_dev[idx], EV_KEY, BTN_SELECT);
+		input_set_capability(tcm->input_knob_dev[idx], EV_KEY, BTN_WHEEL);
+		input_set_capability(tcm->input_knob_dev[idx], EV_ABS, ABS_WHEEL);
+
+		input_set_abs_params(tcm->input_knob_dev[idx], ABS_WHEEL, 0, 32, 0, 0);
+
+		retval = input_register_device(tcm->input_knob_dev[idx]);
+		if (retval < 0) {
+			LOGE("Fail to register input device for knob\n");
+			input_free_device(tcm->input_knob_dev[idx]);
+			tcm->input_knob_dev[idx] = NULL;
+			return retval;
+		}
+	}
+
+	return 0;
+}
+/*
+ * Release the input device for knob allocated previously.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_release_input_knob_device(struct syna_tcm *tcm)
+{
+	int idx = 0;
+
+	for (idx = 0; idx < MAX_NUM_KNOB_OBJECTS; idx++) {
+#ifndef HAVE_THE_SECOND_KNOB
+		if (idx > 0)
+			break;
+#endif
+		if (tcm->input_knob_dev[idx]) {
+			input_unregister_device(tcm->input_knob_dev[idx]);
+			tcm->input_knob_dev[idx] = NULL;
+		}
+	}
+}
+#endif
+
+/*
+ * Allocate an input device and set up relevant parameters to the
+ * input subsystem.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_dev_create_input_device(struct syna_tcm *tcm)
+{
+	int retval = 0;
+	struct tcm_dev *tcm_dev = tcm->tcm_dev;
+	struct input_dev *input_dev = NULL;
+#ifdef DEV_MANAGED_API
+	struct device *dev = syna_request_managed_device();
+
 	if (!dev) {
 		LOGE("Invalid managed device\n");
 		return -EINVAL;
 	}
 
-	input_dev = devm_input_allocate_device(dev);
-#else /* Legacy API */
-	input_dev = input_allocate_device();
-#endif
-	if (input_dev == NULL) {
-		LOGE("Fail to allocate input device\n");
-		return -ENODEV;
-	}
+	input_dev = devm_input_allocate_device(dev);
+#else /* Legacy API */
+	input_dev = input_allocate_device();
+#endif
+	if (input_dev == NULL) {
+		LOGE("Fail to allocate input device\n");
+		return -ENODEV;
+	}
+
+	input_dev->name = TOUCH_INPUT_NAME;
+	input_dev->phys = TOUCH_INPUT_PHYS_PATH;
+	input_dev->id.product = SYNAPTICS_TCM_DRIVER_ID;
+	input_dev->id.version = SYNAPTICS_TCM_DRIVER_VERSION;
+	input_dev->dev.parent = tcm->pdev->dev.parent;
+	input_set_drvdata(input_dev, tcm);
+
+	set_bit(EV_SYN, input_dev->evbit);
+	set_bit(EV_KEY, input_dev->evbit);
+	set_bit(EV_ABS, input_dev->evbit);
+	set_bit(BTN_TOUCH, input_dev->keybit);
+	set_bit(BTN_TOOL_FINGER, input_dev->keybit);
+#ifdef INPUT_PROP_DIRECT
+	set_bit(INPUT_PROP_DIRECT, input_dev->propbit);
+#endif
+
+	if (tcm->input_opts & BIT(INPUT_OPT_WAKEUP_GESTURE)) {
+		set_bit(KEY_WAKEUP, input_dev->keybit);
+		input_set_capability(input_dev, EV_KEY, KEY_WAKEUP);
+	}
+
+	input_set_abs_params(input_dev, ABS_MT_POSITION_X, 0, tcm_dev->max_x, 0, 0);
+	input_set_abs_params(input_dev, ABS_MT_POSITION_Y, 0, tcm_dev->max_y, 0, 0);
+
+	input_mt_init_slots(input_dev, tcm_dev->max_objects, INPUT_MT_DIRECT);
+
+	if (tcm->input_opts & BIT(INPUT_OPT_TOUCH_WIDTH)) {
+		input_set_abs_params(input_dev, ABS_MT_TOUCH_MAJOR, 0, 255, 0, 0);
+		input_set_abs_params(input_dev, ABS_MT_TOUCH_MINOR, 0, 255, 0, 0);
+	}
+
+	tcm->input_dev_params.max_x = tcm_dev->max_x;
+	tcm->input_dev_params.max_y = tcm_dev->max_y;
+	tcm->input_dev_params.max_objects = tcm_dev->max_objects;
+	tcm->input_dev_params.opts = tcm->input_opts;
+
+	retval = input_register_device(input_dev);
+	if (retval < 0) {
+		LOGE("Fail to register input device\n");
+		input_free_device(input_dev);
+		input_dev = NULL;
+		return retval;
+	}
+
+	tcm->input_dev = input_dev;
+
+	return 0;
+}
+/*
+ * Release the input device allocated previously.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_release_input_device(struct syna_tcm *tcm)
+{
+	if (!tcm->input_dev)
+		return;
+
+	input_unregister_device(tcm->input_dev);
+
+	tcm->input_dev = NULL;
+}
+/*
+ * Check whether it's need to register the new input device
+ * if any of parameters has been changed.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    true if parameters are mismatched, false otherwise.
+ */
+static bool syna_dev_check_input_params(struct syna_tcm *tcm)
+{
+	struct tcm_dev *tcm_dev = tcm->tcm_dev;
+
+	if (tcm_dev->max_x == 0 && tcm_dev->max_y == 0)
+		return false;
+
+	if (tcm->input_dev_params.max_x != tcm_dev->max_x)
+		return true;
+
+	if (tcm->input_dev_params.max_y != tcm_dev->max_y)
+		return true;
+
+	if (tcm->input_dev_params.max_objects != tcm_dev->max_objects)
+		return true;
+
+	if ((tcm->input_dev_params.opts ^ tcm->input_opts) & INPUT_OPTS_CAPABILITY)
+		return true;
+
+	if (tcm_dev->max_objects > MAX_NUM_OBJECTS) {
+		LOGW("Out of max num objects defined, in app_info: %d\n",
+			tcm_dev->max_objects);
+		return false;
+	}
+
+	LOGN("Input parameters non-changed\n");
+	return false;
+}
+
+/*
+ * Check and prepare input relevant setup.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    0 in case of success, a negative value otherwise.
+ */
+static int syna_dev_set_up_input_device(struct syna_tcm *tcm)
+{
+	int retval;
+
+	if (IS_NOT_APP_FW_MODE(tcm->tcm_dev->dev_mode)) {
+		LOGN("Application firmware not running, current mode: %02x\n",
+			tcm->tcm_dev->dev_mode);
+		return 0;
+	}
+
+#if defined(ENABLE_REPORT_PIPELINE)
+	syna_dev_flush_report_pipeline(tcm);
+#endif
+	syna_dev_free_input_events(tcm);
+
+	if (!syna_dev_check_input_params(tcm))
+		return 0;
+
+	syna_pal_mutex_lock(&tcm->tp_event_mutex);
+
+	if (tcm->input_dev != NULL)
+		syna_dev_release_input_device(tcm);
+
+	retval = syna_dev_create_input_device(tcm);
+	if (retval < 0) {
+		LOGE("Fail to create input device\n");
+		syna_pal_mutex_unlock(&tcm->tp_event_mutex);
+		return retval;
+	}
+
+	/* register the handling function for touch reports */
+	retval = syna_tcm_set_report_dispatcher(tcm->tcm_dev,
+			REPORT_TOUCH, syna_dev_process_touch_report, (void *)tcm);
+	if (retval < 0)
+		LOGE("Fail to register the touch report handling function\n");
+
+	syna_pal_mutex_unlock(&tcm->tp_event_mutex);
+
+	return 0;
+}
+
+/*
+ * Get the default options of input reporting defined by the build flags.
+ *
+ * param
+ *    void
+ *
+ * return
+ *    bits of enum input_option.
+ */
+static unsigned int syna_dev_get_default_input_options(void)
+{
+	unsigned int opts = 0;
+
+#ifdef TYPE_B_PROTOCOL
+	opts |= BIT(INPUT_OPT_TYPE_B);
+#endif
+#ifdef REPORT_SWAP_XY
+	opts |= BIT(INPUT_OPT_SWAP_XY);
+#endif
+#ifdef REPORT_FLIP_X
+	opts |= BIT(INPUT_OPT_FLIP_X);
+#endif
+#ifdef REPORT_FLIP_Y
+	opts |= BIT(INPUT_OPT_FLIP_Y);
+#endif
+#ifdef REPORT_TOUCH_WIDTH
+	opts |= BIT(INPUT_OPT_TOUCH_WIDTH);
+#endif
+#ifdef ENABLE_WAKEUP_GESTURE
+	opts |= BIT(INPUT_OPT_WAKEUP_GESTURE);
+#endif
+	return opts;
+}
+/*
+ * Switch the static key of an input option.
+ *
+ * param
+ *    [ in] key: the static key
+ *    [ in] en:  true to enable, false to disable
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_switch_input_key(struct static_key *key, bool en)
+{
+	if (en)
+		static_key_enable(key);
+	else
+		static_key_disable(key);
+}
+/*
+ * Switch the options of input reporting.
+ *
+ * The options checked per frame are implemented with static keys, so the
+ * report path costs the same as the one built with the fixed flags.
+ * The input device is registered again if its capabilities are changed.
+ *
+ * param
+ *    [ in] tcm:  pointer to the driver context
+ *    [ in] opts: bits of enum input_option
+ *
+ * return
+ *    0 in case of success, a negative value otherwise.
+ */
+int syna_dev_set_input_options(struct syna_tcm *tcm, unsigned int opts)
+{
+	opts &= (BIT(INPUT_OPT_MAX) - 1);
+
+#if defined(ENABLE_REPORT_PIPELINE)
+	syna_dev_flush_report_pipeline(tcm);
+#endif
+	/* release the events reported in the previous protocol */
+	syna_dev_free_input_events(tcm);
+
+	syna_pal_mutex_lock(&tcm->tp_event_mutex);
+
+	syna_dev_switch_input_key(&syna_input_type_b.key,
+		opts & BIT(INPUT_OPT_TYPE_B));
+	syna_dev_switch_input_key(&syna_input_swap_xy.key,
+		opts & BIT(INPUT_OPT_SWAP_XY));
+	syna_dev_switch_input_key(&syna_input_flip_x.key,
+		opts & BIT(INPUT_OPT_FLIP_X));
+	syna_dev_switch_input_key(&syna_input_flip_y.key,
+		opts & BIT(INPUT_OPT_FLIP_Y));
+	syna_dev_switch_input_key(&syna_input_touch_width.key,
+		opts & BIT(INPUT_OPT_TOUCH_WIDTH));
+	syna_dev_switch_input_key(&syna_input_wakeup_gesture.key,
+		opts & BIT(INPUT_OPT_WAKEUP_GESTURE));
+
+	tcm->input_opts = opts;
+	tcm->lpwg_enabled = !!(opts & BIT(INPUT_OPT_WAKEUP_GESTURE));
+
+	syna_pal_mutex_unlock(&tcm->tp_event_mutex);
+
+	LOGI("Input options: type B(%s) swap xy(%s) flip x(%s) flip y(%s) width(%s) gesture(%s)\n",
+		(opts & BIT(INPUT_OPT_TYPE_B)) ? "yes" : "no",
+		(opts & BIT(INPUT_OPT_SWAP_XY)) ? "yes" : "no",
+		(opts & BIT(INPUT_OPT_FLIP_X)) ? "yes" : "no",
+		(opts & BIT(INPUT_OPT_FLIP_Y)) ? "yes" : "no",
+		(opts & BIT(INPUT_OPT_TOUCH_WIDTH)) ? "yes" : "no",
+		(opts & BIT(INPUT_OPT_WAKEUP_GESTURE)) ? "yes" : "no");
+
+	if (!tcm->input_dev)
+		return 0;
+
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+	/* the entities of touch report in use may be changed as well */
+	if ((tcm->pwr_state == PWR_ON) && (tcm->dev_set_up_app_fw)) {
+		if (tcm->dev_set_up_app_fw(tcm) < 0)
+			LOGE("Fail to set up the touch report config\n");
+	}
+#endif
+
+	return syna_dev_set_up_input_device(tcm);
+}
+
+/* Upper bounds of the buckets of irq wakeup latency, in microseconds */
+static const unsigned int irq_latency_bounds[IRQ_LATENCY_BUCKETS - 1] = {
+	50, 100, 200, 500, 1000
+};
+/*
+ * Record the latency from the ATTN edge to the threaded handler.
+ *
+ * param
+ *    [ in] tcm:        pointer to the driver context
+ *    [ in] latency_us: latency in microseconds
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_record_irq_latency(struct syna_tcm *tcm,
+	unsigned int latency_us)
+{
+	struct isr_stats *stats = &tcm->isr_stats;
+	unsigned int idx;
+
+	for (idx = 0; idx < IRQ_LATENCY_BUCKETS - 1; idx++) {
+		if (latency_us < irq_latency_bounds[idx])
+			break;
+	}
+	stats->latency_hist[idx]++;
+
+	stats->latency_us += latency_us;
+	if (latency_us > stats->max_latency_us)
+		stats->max_latency_us = latency_us;
+}
+/*
+ * Apply the cpus to the interrupt line, and the irq thread follows.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_dev_apply_irq_affinity(struct syna_tcm *tcm)
+{
+	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
+	const struct cpumask *cpus = &tcm->irq_sched.cpus;
+
+	if (attn->irq_id <= 0)
+		return 0;
+
+	if (cpumask_empty(cpus))
+		cpus = cpu_possible_mask;
+
+#if (KERNEL_VERSION(5, 17, 0) <= LINUX_VERSION_CODE)
+	return irq_set_affinity_and_hint(attn->irq_id, cpus);
+#else
+	return irq_set_affinity_hint(attn->irq_id, cpus);
+#endif
+}
+#if defined(ENABLE_REPORT_POLLING)
+/*
+ * Update the period of report polling.
+ *
+ * The rate given in dt is applied in prior to the frame rate reported
+ * by firmware when the touch is active.
+ *
+ * param
+ *    [ in] tcm:    pointer to the driver context
+ *    [ in] active: true to poll at the report rate; false at the idle rate
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_set_polling_rate(struct syna_tcm *tcm, bool active)
+{
+	struct syna_report_polling *poll = &tcm->report_poll;
+	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
+	unsigned int rate;
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	/* aligned to the frame period observed in the interrupt mode */
+	if (tcm->hybrid.polling) {
+		WRITE_ONCE(poll->period, tcm->hybrid.period);
+		return;
+	}
+#endif
+
+	if (!active)
+		rate = (attn->polling_idle_hz > 0) ?
+			attn->polling_idle_hz : REPORT_POLLING_IDLE_HZ_DEFAULT;
+	else if (attn->polling_report_hz > 0)
+		rate = attn->polling_report_hz;
+	else if (READ_ONCE(tcm->tp_data.frame_rate) > 0)
+		rate = READ_ONCE(tcm->tp_data.frame_rate);
+	else
+		rate = REPORT_POLLING_RATE_HZ_DEFAULT;
+
+	rate = MIN(MAX(rate, 1), REPORT_POLLING_RATE_HZ_MAX);
+
+	WRITE_ONCE(poll->period, ns_to_ktime(div_u64(NSEC_PER_SEC, rate)));
+
+	if (poll->active != active) {
+		if (active)
+			poll->stats.ramp_up++;
+		else
+			poll->stats.ramp_down++;
+		poll->active = active;
+	}
+}
+/*
+ * Timer of report polling, running in hard-IRQ context.
+ *
+ * Count the ticks elapsed and then wake up the polling thread.
+ *
+ * param
+ *    [ in] timer: pointer to the hrtimer
+ *
+ * return
+ *    HRTIMER_RESTART to keep the timer running.
+ */
+static enum hrtimer_restart syna_dev_report_polling_timer(struct hrtimer *timer)
+{
+	struct syna_report_polling *poll =
+			container_of(timer, struct syna_report_polling, timer);
+	u64 ticks;
+
+	ticks = hrtimer_forward_now(timer, READ_ONCE(poll->period));
+	atomic_add((int)MIN(ticks, (u64)INT_MAX), &poll->ticks);
+
+	wake_up_process(poll->task);
+
+	return HRTIMER_RESTART;
+}
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+/*
+ * Account the time spent in the current mode, and then switch.
+ *
+ * param
+ *    [ in] tcm:     pointer to the driver context
+ *    [ in] polling: true for the polling mode; false for the interrupt mode
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_hybrid_switch(struct syna_tcm *tcm, bool polling)
+{
+	struct syna_hybrid_mode *hybrid = &tcm->hybrid;
+	ktime_t now = ktime_get();
+
+	if (hybrid->polling)
+		hybrid->stats.poll_us += ktime_us_delta(now, hybrid->since);
+	else
+		hybrid->stats.irq_us += ktime_us_delta(now, hybrid->since);
+
+	if (polling && !hybrid->polling)
+		hybrid->stats.enters++;
+	else if (!polling && hybrid->polling)
+		hybrid->stats.exits++;
+
+	hybrid->since = now;
+	hybrid->streak = 0;
+	hybrid->empty_polls = 0;
+	hybrid->polling = polling;
+}
+/*
+ * Leave the polling mode, called with the mutex of report polling held.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_hybrid_exit(struct syna_tcm *tcm)
+{
+	struct syna_report_polling *poll = &tcm->report_poll;
+	struct tcm_hw_platform *hw = &tcm->hw_if->hw_platform;
+
+	hrtimer_cancel(&poll->timer);
+	atomic_set(&poll->ticks, 0);
+	poll->running = false;
+
+	syna_dev_hybrid_switch(tcm, false);
+
+	/* ATTN is level triggered, so the report pending is not missed */
+	if (!tcm->hw_if->bdata_attn.irq_enabled && hw->ops_enable_attn)
+		hw->ops_enable_attn(hw, true);
+
+	LOGD("Hybrid mode: back to interrupts\n");
+}
+/*
+ * Track the polls in the polling mode.
+ *
+ * The period is nudged toward the frame period of firmware, and the polling
+ * mode is left once the reports stop.
+ *
+ * param
+ *    [ in] tcm:     pointer to the driver context
+ *    [ in] reports: number of reports fetched by the poll
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_hybrid_track_polls(struct syna_tcm *tcm,
+	unsigned int reports)
+{
+	struct syna_hybrid_mode *hybrid = &tcm->hybrid;
+	s64 period = ktime_to_ns(hybrid->period);
+
+	/* ATTN turned on by the others, leave to the irq thread */
+	if (tcm->hw_if->bdata_attn.irq_enabled) {
+		syna_dev_hybrid_exit(tcm);
+		return;
+	}
+
+	if (reports == 0) {
+		if (++hybrid->empty_polls >= hybrid->exit_polls) {
+			syna_dev_hybrid_exit(tcm);
+			return;
+		}
+		/* ahead of the frames */
+		period += (period >> 6);
+	} else {
+		hybrid->empty_polls = 0;
+		/* behind the frames */
+		if (reports > 1)
+			period -= (period >> 6);
+	}
+
+	period = MAX(period, (s64)(NSEC_PER_SEC / REPORT_POLLING_RATE_HZ_MAX));
+	hybrid->period = ns_to_ktime(period);
+	WRITE_ONCE(tcm->report_poll.period, hybrid->period);
+}
+/*
+ * Leave the polling mode, and turn ATTN back on.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_stop_hybrid_mode(struct syna_tcm *tcm)
+{
+	struct syna_report_polling *poll = &tcm->report_poll;
+
+	if (!poll->task)
+		return;
+
+	syna_pal_mutex_lock(&poll->mutex);
+	if (tcm->hybrid.polling)
+		syna_dev_hybrid_exit(tcm);
+	syna_pal_mutex_unlock(&poll->mutex);
+}
+#endif
+/*
+ * Request the reports generated by firmware since the last poll.
+ *
+ * At most one report per tick is requested, so the empty reads are kept
+ * to one per poll; the ticks missed are caught up within the budget.
+ *
+ * param
+ *    [ in] tcm:   pointer to the driver context
+ *    [ in] ticks: number of ticks elapsed
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_poll_reports(struct syna_tcm *tcm, unsigned int ticks)
+{
+	int retval;
+	unsigned char code = 0;
+	struct syna_report_polling *poll = &tcm->report_poll;
+	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
+	unsigned int budget;
+	unsigned int reports = 0;
+	ktime_t now;
+	bool active;
+
+	/* the response of command in progress is polled by the command itself */
+	if (ATOMIC_GET(tcm->tcm_dev->msg_data.command_status) == CMD_STATE_BUSY) {
+		poll->stats.skipped++;
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+		/* unless ATTN is routed, then the response is read by the irq
+		 * thread, so ATTN has to be turned back on
+		 */
+		if (tcm->hybrid.polling)
+			syna_dev_hybrid_exit(tcm);
+#endif
+		return;
+	}
+
+	budget = (attn->irq_drain_budget > 0) ?
+		attn->irq_drain_budget : IRQ_DRAIN_BUDGET_DEFAULT;
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	/* drained as the irq thread does, the period is corrected afterwards */
+	if (!tcm->hybrid.polling)
+		budget = MIN(budget, ticks);
+#else
+	budget = MIN(budget, ticks);
+#endif
+
+	tcm->isr_pid = current->pid;
+
+	do {
+		tcm->irq_timestamp = ktime_get();
+
+		retval = syna_tcm_get_event_data(tcm->tcm_dev,
+				&code,
+				NULL);
+		if (retval < 0) {
+			LOGE("Fail to get event data\n");
+			break;
+		}
+
+		if ((code == STATUS_NO_REPORT_AVAILABLE) || (code == STATUS_INVALID))
+			break;
+
+		reports++;
+	} while (reports < budget);
+
+	tcm->irq_timestamp = ktime_set(0, 0);
+
+	poll->stats.polls++;
+	poll->stats.reports += reports;
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	if (tcm->hybrid.polling) {
+		syna_dev_hybrid_track_polls(tcm, reports);
+		return;
+	}
+#endif
+
+	/* stay at the report rate while reports arrive or objects are touched */
+	now = ktime_get();
+	if ((reports > 0) || (READ_ONCE(tcm->touching_objects) != 0))
+		poll->last_active = now;
+
+	active = (ktime_ms_delta(now, poll->last_active) < REPORT_POLLING_IDLE_DELAY_MS);
+	if (active && !poll->active) {
+		/* ramp up upon the contact, rather than at the next idle tick */
+		syna_dev_set_polling_rate(tcm, true);
+		hrtimer_start(&poll->timer, poll->period, HRTIMER_MODE_REL);
+	} else {
+		syna_dev_set_polling_rate(tcm, active);
+	}
+}
+/*
+ * Thread of report polling.
+ *
+ * param
+ *    [ in] data: pointer to the driver context
+ *
+ * return
+ *    0 once the thread is stopped.
+ */
+static int syna_dev_report_polling_thread(void *data)
+{
+	struct syna_tcm *tcm = data;
+	struct syna_report_polling *poll = &tcm->report_poll;
+	int ticks;
+
+	while (!kthread_should_stop()) {
+		set_current_state(TASK_INTERRUPTIBLE);
+
+		ticks = atomic_xchg(&poll->ticks, 0);
+		if (ticks == 0) {
+			if (!kthread_should_stop())
+				schedule();
+			continue;
+		}
+
+		__set_current_state(TASK_RUNNING);
+
+		syna_pal_mutex_lock(&poll->mutex);
+		if (poll->running)
+			syna_dev_poll_reports(tcm, ticks);
+		syna_pal_mutex_unlock(&poll->mutex);
+	}
+
+	__set_current_state(TASK_RUNNING);
+
+	return 0;
+}
+/*
+ * Start or stop the report polling.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *    [ in] en:  true to start, false to stop
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_enable_report_polling(struct syna_tcm *tcm, bool en)
+{
+	struct syna_report_polling *poll = &tcm->report_poll;
+
+	if (!poll->task)
+		return;
+
+	syna_pal_mutex_lock(&poll->mutex);
+
+	if (en && !poll->running) {
+		poll->last_active = ktime_get();
+		syna_dev_set_polling_rate(tcm, true);
+		hrtimer_start(&poll->timer, poll->period, HRTIMER_MODE_REL);
+		poll->running = true;
+	} else if (!en && poll->running) {
+		hrtimer_cancel(&poll->timer);
+		atomic_set(&poll->ticks, 0);
+		poll->running = false;
+	}
+
+	syna_pal_mutex_unlock(&poll->mutex);
+
+	LOGD("Report polling %s\n", (en) ? "started" : "stopped");
+}
+/*
+ * Create the thread and timer of report polling, used in place of the
+ * interrupt line when no ATTN is routed.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_dev_create_report_polling(struct syna_tcm *tcm)
+{
+	struct syna_report_polling *poll = &tcm->report_poll;
+
+	syna_pal_mutex_alloc(&poll->mutex);
+	atomic_set(&poll->ticks, 0);
+	poll->active = false;
+	poll->running = false;
+	syna_pal_mem_set(&poll->stats, 0, sizeof(poll->stats));
+
+#if (KERNEL_VERSION(6, 13, 0) <= LINUX_VERSION_CODE)
+	hrtimer_setup(&poll->timer, syna_dev_report_polling_timer,
+		CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+#else
+	hrtimer_init(&poll->timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	poll->timer.function = syna_dev_report_polling_timer;
+#endif
+
+	poll->task = kthread_run(syna_dev_report_polling_thread, tcm,
+			"syna_tcm_poll");
+	if (IS_ERR(poll->task)) {
+		LOGE("Fail to create the thread of report polling\n");
+		poll->task = NULL;
+		syna_pal_mutex_free(&poll->mutex);
+		return -ENOMEM;
+	}
+	/* the same scheduling as the threaded irq handler */
+	syna_dev_set_thread_priority(poll->task, tcm->irq_sched.prio);
+	if (!cpumask_empty(&tcm->irq_sched.cpus))
+		set_cpus_allowed_ptr(poll->task, &tcm->irq_sched.cpus);
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_touch_boost_attach(tcm, TOUCH_BOOST_POLL_THREAD, poll->task);
+#endif
+
+	return 0;
+}
+/*
+ * Stop and release the report polling.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_release_report_polling(struct syna_tcm *tcm)
+{
+	struct syna_report_polling *poll = &tcm->report_poll;
+
+	if (!poll->task)
+		return;
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	syna_dev_stop_hybrid_mode(tcm);
+#endif
+	syna_dev_enable_report_polling(tcm, false);
+
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_touch_boost_attach(tcm, TOUCH_BOOST_POLL_THREAD, NULL);
+#endif
+	kthread_stop(poll->task);
+	poll->task = NULL;
+
+	syna_pal_mutex_free(&poll->mutex);
+
+	LOGI("Report polling released\n");
+}
+#endif
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+/*
+ * Track the ATTN in the interrupt mode, called by the irq thread.
+ *
+ * The polling mode is entered after the back-to-back reports, at the frame
+ * period averaged over them.
+ *
+ * param
+ *    [ in] tcm:       pointer to the driver context
+ *    [ in] attn_time: time of the ATTN edge
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_hybrid_track_attn(struct syna_tcm *tcm, ktime_t attn_time)
+{
+	struct syna_hybrid_mode *hybrid = &tcm->hybrid;
+	struct tcm_hw_platform *hw = &tcm->hw_if->hw_platform;
+	s64 interval = ktime_to_ns(ktime_sub(attn_time, hybrid->last_attn));
+	s64 period;
+
+	hybrid->last_attn = attn_time;
+
+	if (hybrid->polling || (READ_ONCE(hybrid->enter_reports) == 0) ||
+		!tcm->report_poll.task || (tcm->pwr_state != PWR_ON))
+		return;
+
+	/* the response of command is waited on ATTN, stay in interrupts */
+	if (ATOMIC_GET(tcm->tcm_dev->msg_data.command_status) == CMD_STATE_BUSY) {
+		hybrid->streak = 0;
+		return;
+	}
+
+	if ((interval <= 0) || (interval > NSEC_PER_SEC / HYBRID_MIN_RATE_HZ)) {
+		hybrid->streak = 0;
+		return;
+	}
+
+	/* moving average of the frame period */
+	period = (hybrid->streak == 0) ? interval : ktime_to_ns(hybrid->period);
+	period += div_s64(interval - period, 8);
+	period = MAX(period, (s64)(NSEC_PER_SEC / REPORT_POLLING_RATE_HZ_MAX));
+	hybrid->period = ns_to_ktime(period);
+
+	if (++hybrid->streak < hybrid->enter_reports)
+		return;
+
+	if (hw->ops_enable_attn)
+		hw->ops_enable_attn(hw, false);
+
+	syna_dev_hybrid_switch(tcm, true);
+	syna_dev_enable_report_polling(tcm, true);
+
+	LOGD("Hybrid mode: polling at %lld us\n", ktime_to_us(hybrid->period));
+}
+/*
+ * Change the thresholds of hybrid mode.
+ *
+ * param
+ *    [ in] tcm:           pointer to the driver context
+ *    [ in] enter_reports: back-to-back reports to enter polling; 0 to disable
+ *    [ in] exit_polls:    polls without report to fall back to interrupts
+ *
+ * return
+ *    void.
+ */
+void syna_dev_set_hybrid_mode(struct syna_tcm *tcm, unsigned int enter_reports,
+	unsigned int exit_polls)
+{
+	tcm->hybrid.exit_polls = MAX(exit_polls, 1);
+	WRITE_ONCE(tcm->hybrid.enter_reports, enter_reports);
+}
+#endif
+/*
+ * Primary interrupt handler running in hard-IRQ context.
+ *
+ * Record the time of ATTN edge, and then wake up the threaded handler.
+ *
+ * param
+ *    [ in] irq:  IRQ number
+ *    [ in] data: private data being passed to the handler function
+ *
+ * return
+ *    IRQ_WAKE_THREAD to run the threaded handler.
+ */
+static irqreturn_t syna_dev_isr_primary(int irq, void *data)
+{
+	struct syna_tcm *tcm = data;
+
+	tcm->irq_timestamp = ktime_get();
 
-	input_dev->name = TOUCH_INPUT_NAME;
-	input_dev->phys = TOUCH_INPUT_PHYS_PATH;
-	input_dev->id.product = SYNAPTICS_TCM_DRIVER_ID;
-	input_dev->id.version = SYNAPTICS_TCM_DRIVER_VERSION;
-	input_dev->dev.parent = tcm->pdev->dev.parent;
-	input_set_drvdata(input_dev, tcm);
+	return IRQ_WAKE_THREAD;
+}
 
-	set_bit(EV_SYN, input_dev->evbit);
-	set_bit(EV_KEY, input_dev->evbit);
-	set_bit(EV_ABS, input_dev->evbit);
-	set_bit(BTN_TOUCH, input_dev->keybit);
-	set_bit(BTN_TOOL_FINGER, input_dev->keybit);
-#ifdef INPUT_PROP_DIRECT
-	set_bit(INPUT_PROP_DIRECT, input_dev->propbit);
+/*
+ * Interrupt handling routine.
+ *
+ * Triggered when the device asserts an interrupt.
+ * Reads and processes the events generated by the device.
+ *
+ * The reports queued in firmware are drained in one wakeup as long as the
+ * ATTN remains asserted, until no report is available or the budget runs out.
+ *
+ * param
+ *    [ in] irq:  IRQ number
+ *    [ in] data: private data being passed to the handler function
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static irqreturn_t syna_dev_isr(int irq, void *data)
+{
+	int retval;
+	unsigned char code = 0;
+	struct syna_tcm *tcm = data;
+	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
+	unsigned int budget;
+	unsigned int reports = 0;
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	ktime_t attn_time = (ktime_to_ns(tcm->irq_timestamp) != 0) ?
+		tcm->irq_timestamp : ktime_get();
 #endif
 
-#ifdef ENABLE_WAKEUP_GESTURE
-	set_bit(KEY_WAKEUP, input_dev->keybit);
-	input_set_capability(input_dev, EV_KEY, KEY_WAKEUP);
+	if (ktime_to_ns(tcm->irq_timestamp) != 0)
+		syna_dev_record_irq_latency(tcm,
+			(unsigned int)ktime_us_delta(ktime_get(), tcm->irq_timestamp));
+
+	/* the priority has to be changed by the irq thread itself */
+	if (unlikely(atomic_xchg(&tcm->irq_sched.prio_update, 0)))
+		syna_dev_set_thread_priority(current, tcm->irq_sched.prio);
+#if defined(ENABLE_TOUCH_BOOST)
+	/* the irq thread is known once it runs */
+	if (unlikely(READ_ONCE(tcm->boost.threads[TOUCH_BOOST_IRQ_THREAD].task)
+			!= current))
+		syna_dev_touch_boost_attach(tcm, TOUCH_BOOST_IRQ_THREAD, current);
 #endif
 
-	input_set_abs_params(input_dev, ABS_MT_POSITION_X, 0, tcm_dev->max_x, 0, 0);
-	input_set_abs_params(input_dev, ABS_MT_POSITION_Y, 0, tcm_dev->max_y, 0, 0);
+	if (unlikely(gpio_get_value(attn->irq_gpio) != attn->irq_on_state))
+		goto exit;
 
-	input_mt_init_slots(input_dev, tcm_dev->max_objects, INPUT_MT_DIRECT);
+	tcm->isr_pid = current->pid;
 
-#ifdef REPORT_TOUCH_WIDTH
-	input_set_abs_params(input_dev, ABS_MT_TOUCH_MAJOR, 0, 255, 0, 0);
-	input_set_abs_params(input_dev, ABS_MT_TOUCH_MINOR, 0, 255, 0, 0);
+	budget = (attn->irq_drain_budget > 0) ?
+		attn->irq_drain_budget : IRQ_DRAIN_BUDGET_DEFAULT;
+
+	do {
+		/* retrieve the original report date generated by firmware
+		 * no need to copy it out, the registered callbacks get the data in place
+		 */
+		retval = syna_tcm_get_event_data(tcm->tcm_dev,
+				&code,
+				NULL);
+		if (retval < 0) {
+			LOGE("Fail to get event data\n");
+			break;
+		}
+
+		if ((code == STATUS_NO_REPORT_AVAILABLE) || (code == STATUS_INVALID))
+			break;
+
+		reports++;
+
+		/* the reports drained afterwards are stamped when being read */
+		tcm->irq_timestamp = ktime_get();
+
+	} while ((reports < budget) &&
+		(gpio_get_value(attn->irq_gpio) == attn->irq_on_state));
+
+	tcm->isr_stats.wakeups++;
+	tcm->isr_stats.reports += reports;
+	if (reports > tcm->isr_stats.max_reports)
+		tcm->isr_stats.max_reports = reports;
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	if (reports > 0)
+		syna_dev_hybrid_track_attn(tcm, attn_time);
 #endif
 
-	tcm->input_dev_params.max_x = tcm_dev->max_x;
-	tcm->input_dev_params.max_y = tcm_dev->max_y;
-	tcm->input_dev_params.max_objects = tcm_dev->max_objects;
+exit:
+	tcm->irq_timestamp = ktime_set(0, 0);
 
-	retval = input_register_device(input_dev);
+	return IRQ_HANDLED;
+}
+
+/*
+ * Request IRQ and register the interrupt handling routine.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_dev_request_irq(struct syna_tcm *tcm)
+{
+	int retval;
+	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
+#ifdef DEV_MANAGED_API
+	struct device *dev = syna_request_managed_device();
+
+	if (!dev) {
+		LOGE("Invalid managed device\n");
+		retval = -EINVAL;
+		goto exit;
+	}
+#endif
+
+	if (attn->irq_gpio < 0) {
+		LOGE("Invalid IRQ GPIO\n");
+		retval = -EINVAL;
+		goto exit;
+	}
+
+	attn->irq_id = gpio_to_irq(attn->irq_gpio);
+
+#ifdef DEV_MANAGED_API
+	retval = devm_request_threaded_irq(dev,
+			attn->irq_id,
+			syna_dev_isr_primary,
+			syna_dev_isr,
+			attn->irq_flags,
+			PLATFORM_DRIVER_NAME,
+			tcm);
+#else /* Legacy API */
+	retval = request_threaded_irq(attn->irq_id,
+			syna_dev_isr_primary,
+			syna_dev_isr,
+			attn->irq_flags,
+			PLATFORM_DRIVER_NAME,
+			tcm);
+#endif
 	if (retval < 0) {
-		LOGE("Fail to register input device\n");
-		input_free_device(input_dev);
-		input_dev = NULL;
-		return retval;
+		LOGE("Fail to request threaded irq\n");
+		goto exit;
 	}
 
-	tcm->input_dev = input_dev;
+	attn->irq_enabled = true;
 
-	return 0;
+	if (syna_dev_apply_irq_affinity(tcm) < 0)
+		LOGW("Fail to set the affinity of irq\n");
+
+	/* apply the priority at the first run of the irq thread */
+	if (tcm->irq_sched.prio > 0)
+		atomic_set(&tcm->irq_sched.prio_update, 1);
+
+	LOGI("Interrupt handler registered\n");
+
+exit:
+	return retval;
 }
+
 /*
- * Release the input device allocated previously.
+ * Release an interrupt line allocated previously
  *
  * param
  *    [ in] tcm: pointer to the driver context
@@ -679,236 +3246,313 @@ static int syna_dev_create_input_device(struct syna_tcm *tcm)
  * return
  *    void.
  */
-static void syna_dev_release_input_device(struct syna_tcm *tcm)
+static void syna_dev_release_irq(struct syna_tcm *tcm)
 {
-	if (!tcm->input_dev)
+	struct tcm_hw_platform *hw = &tcm->hw_if->hw_platform;
+	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
+#ifdef DEV_MANAGED_API
+	struct device *dev = syna_request_managed_device();
+
+	if (!dev) {
+		LOGE("Invalid managed device\n");
+		return;
+	}
+#endif
+
+	if (attn->irq_id <= 0)
 		return;
 
-	input_unregister_device(tcm->input_dev);
+	if (hw->ops_enable_attn)
+		hw->ops_enable_attn(hw, false);
 
-	tcm->input_dev = NULL;
+#if (KERNEL_VERSION(5, 17, 0) <= LINUX_VERSION_CODE)
+	irq_update_affinity_hint(attn->irq_id, NULL);
+#else
+	irq_set_affinity_hint(attn->irq_id, NULL);
+#endif
+
+#ifdef DEV_MANAGED_API
+	devm_free_irq(dev, attn->irq_id, tcm);
+#else
+	free_irq(attn->irq_id, tcm);
+#endif
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_touch_boost_attach(tcm, TOUCH_BOOST_IRQ_THREAD, NULL);
+#endif
+
+	attn->irq_id = 0;
+	attn->irq_enabled = false;
+
+	LOGI("Interrupt handler released\n");
 }
+
 /*
- * Check whether it's need to register the new input device
- * if any of parameters has been changed.
+ * Change the rt priority of the irq thread, and the polling and report
+ * threads.
  *
  * param
- *    [ in] tcm: pointer to the driver context
+ *    [ in] tcm:  pointer to the driver context
+ *    [ in] prio: rt priority, 1 ~ 99; or '0' to use the default
  *
  * return
- *    true if parameters are mismatched, false otherwise.
+ *    0 or positive value in case of success, a negative value otherwise.
  */
-static bool syna_dev_check_input_params(struct syna_tcm *tcm)
+int syna_dev_set_irq_thread_priority(struct syna_tcm *tcm, unsigned int prio)
 {
-	struct tcm_dev *tcm_dev = tcm->tcm_dev;
-
-	if (tcm_dev->max_x == 0 && tcm_dev->max_y == 0)
-		return false;
+	int retval = 0;
 
-	if (tcm->input_dev_params.max_x != tcm_dev->max_x)
-		return true;
+	if (prio >= MAX_RT_PRIO) {
+		LOGE("Invalid priority %d (1 ~ %d)\n", prio, MAX_RT_PRIO - 1);
+		return -EINVAL;
+	}
 
-	if (tcm->input_dev_params.max_y != tcm_dev->max_y)
-		return true;
+	tcm->irq_sched.prio = prio;
 
-	if (tcm->input_dev_params.max_objects != tcm_dev->max_objects)
-		return true;
+	/* applied by the irq thread at the next interrupt */
+	atomic_set(&tcm->irq_sched.prio_update, 1);
 
-	if (tcm_dev->max_objects > MAX_NUM_OBJECTS) {
-		LOGW("Out of max num objects defined, in app_info: %d\n",
-			tcm_dev->max_objects);
-		return false;
+#if defined(ENABLE_REPORT_POLLING)
+	if (tcm->report_poll.task) {
+		retval = syna_dev_set_thread_priority(tcm->report_poll.task, prio);
+		if (retval < 0)
+			return retval;
+	}
+#endif
+#if defined(ENABLE_REPORT_PIPELINE)
+	if (tcm->report_pipe.worker) {
+		retval = syna_dev_set_thread_priority(
+			tcm->report_pipe.worker->task, prio);
+		if (retval < 0)
+			return retval;
 	}
+#endif
 
-	LOGN("Input parameters non-changed\n");
-	return false;
+	return retval;
 }
-
 /*
- * Check and prepare input relevant setup.
+ * Change the cpus running the irq thread, and the polling and report
+ * threads.
+ * The helper and reflash works are queued on the other cpus.
  *
  * param
- *    [ in] tcm: pointer to the driver context
+ *    [ in] tcm:  pointer to the driver context
+ *    [ in] cpus: cpus to run on; or, empty to use the default
  *
  * return
- *    0 in case of success, a negative value otherwise.
+ *    0 or positive value in case of success, a negative value otherwise.
  */
-static int syna_dev_set_up_input_device(struct syna_tcm *tcm)
+int syna_dev_set_irq_cpus(struct syna_tcm *tcm, const struct cpumask *cpus)
 {
 	int retval;
 
-	if (IS_NOT_APP_FW_MODE(tcm->tcm_dev->dev_mode)) {
-		LOGN("Application firmware not running, current mode: %02x\n",
-			tcm->tcm_dev->dev_mode);
-		return 0;
+	if (!cpumask_empty(cpus) && !cpumask_intersects(cpus, cpu_online_mask)) {
+		LOGE("No online cpu given\n");
+		return -EINVAL;
 	}
 
-	syna_dev_free_input_events(tcm);
-
-	if (!syna_dev_check_input_params(tcm))
-		return 0;
-
-	syna_pal_mutex_lock(&tcm->tp_event_mutex);
-
-	if (tcm->input_dev != NULL)
-		syna_dev_release_input_device(tcm);
+	cpumask_copy(&tcm->irq_sched.cpus, cpus);
 
-	retval = syna_dev_create_input_device(tcm);
+	retval = syna_dev_apply_irq_affinity(tcm);
 	if (retval < 0) {
-		LOGE("Fail to create input device\n");
-		syna_pal_mutex_unlock(&tcm->tp_event_mutex);
+		LOGE("Fail to set the affinity of irq\n");
 		return retval;
 	}
 
-	/* register the handling function for touch reports */
-	retval = syna_tcm_set_report_dispatcher(tcm->tcm_dev,
-			REPORT_TOUCH, syna_dev_process_touch_report, (void *)tcm);
-	if (retval < 0)
-		LOGE("Fail to register the touch report handling function\n");
+#if defined(ENABLE_REPORT_POLLING)
+	if (tcm->report_poll.task) {
+		retval = set_cpus_allowed_ptr(tcm->report_poll.task,
+			(cpumask_empty(cpus)) ? cpu_possible_mask : cpus);
+	}
+#endif
+#if defined(ENABLE_REPORT_PIPELINE)
+	if (tcm->report_pipe.worker && retval >= 0) {
+		retval = set_cpus_allowed_ptr(tcm->report_pipe.worker->task,
+			(cpumask_empty(cpus)) ? cpu_possible_mask : cpus);
+	}
+#endif
 
-	syna_pal_mutex_unlock(&tcm->tp_event_mutex);
+	return retval;
+}
 
-	return 0;
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+/*
+ * Collect the touch entities consumed by the driver, as well as the entities
+ * requested through the character device.
+ *
+ * param
+ *    [ in] tcm:  tcm driver handle
+ *    [out] mask: mask of touch entities, TOUCH_ENTITY_MASK_SIZE bytes
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_get_touch_entities_in_use(struct syna_tcm *tcm,
+	unsigned char *mask)
+{
+#ifdef ENABLE_CUSTOM_TOUCH_ENTITY
+	unsigned int code;
+#endif
+
+	syna_pal_mem_cpy(mask, TOUCH_ENTITY_MASK_SIZE,
+		tcm->cdev_touch_entities, sizeof(tcm->cdev_touch_entities),
+		TOUCH_ENTITY_MASK_SIZE);
+
+	/* position of objects */
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_NUM_OF_ACTIVE_OBJECTS);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_INDEX);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_CLASSIFICATION);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_X_POSITION);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_Y_POSITION);
+	if (tcm->input_opts & BIT(INPUT_OPT_TOUCH_WIDTH)) {
+		syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_X_WIDTH);
+		syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_Y_WIDTH);
+	}
+	if (tcm->input_opts & BIT(INPUT_OPT_WAKEUP_GESTURE)) {
+		syna_tcm_set_touch_entity(mask, TOUCH_REPORT_GESTURE_ID);
+		syna_tcm_set_touch_entity(mask, TOUCH_REPORT_GESTURE_DATA);
+	}
+#if defined(TOUCHCOMM_TDDI) && defined(REPORT_KNOB)
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_KNOB_DATA);
+#endif
+#if defined(ENABLE_CLOCK_SYNC)
+	/* firmware time of scan, fed to the clock synchronization */
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_TIMESTAMP);
+#endif
+#if defined(ENABLE_REPORT_POLLING)
+	/* frame rate followed by the report polling */
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_FRAME_RATE);
+#endif
+#ifdef ENABLE_CUSTOM_TOUCH_ENTITY
+	/* entities not defined in common are handled by the custom callback */
+	for (code = TOUCH_REPORT_SENSING_MODE + 1; code < TOUCH_ENTITY_MASK_SIZE * 8; code++) {
+		if ((code == TOUCH_REPORT_KNOB_DATA) || (code == TOUCH_REPORT_KNOB_CALIB))
+			continue;
+		syna_tcm_set_touch_entity(mask, (unsigned char)code);
+	}
+#endif
 }
-
 /*
- * Interrupt handling routine.
+ * Reduce the touch report config to the entities in use, so the bits
+ * of the entities nobody consumes are no longer transferred per frame.
  *
- * Triggered when the device asserts an interrupt.
- * Reads and processes the event generated by the device.
+ * The reduced config is derived from the firmware default, which is
+ * kept once the current config is not the one written by the driver.
  *
  * param
- *    [ in] irq:  IRQ number
- *    [ in] data: private data being passed to the handler function
+ *    [ in] tcm:           tcm driver handle
+ *    [ in] resp_handling: delay time for response reading
  *
  * return
  *    0 or positive value in case of success, a negative value otherwise.
  */
-static irqreturn_t syna_dev_isr(int irq, void *data)
+static int syna_dev_set_up_minimal_touch_config(struct syna_tcm *tcm,
+	unsigned int resp_handling)
 {
 	int retval;
-	unsigned char code = 0;
-	struct syna_tcm *tcm = data;
-	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
+	struct tcm_dev *tcm_dev = tcm->tcm_dev;
+	struct tcm_buffer *config = &tcm_dev->touch_config;
+	struct tcm_buffer *config_default = &tcm->touch_config_default;
+	struct tcm_buffer *config_minimal = &tcm->touch_config_minimal;
+	unsigned char mask[TOUCH_ENTITY_MASK_SIZE] = { 0 };
+	unsigned int bits_default[2];
+	unsigned int bits_minimal[2];
+	int size;
+
+	if (config->data_length == 0) {
+		LOGE("No touch report config preserved\n");
+		return -EINVAL;
+	}
 
-	if (unlikely(gpio_get_value(attn->irq_gpio) != attn->irq_on_state))
-		goto exit;
+	/* the current config is the firmware default unless written previously */
+	if ((config_default->data_length == 0) ||
+		(config_minimal->data_length == 0) ||
+		(config->data_length < config_minimal->data_length) ||
+		(memcmp(config->buf, config_minimal->buf, config_minimal->data_length) != 0)) {
+		retval = syna_tcm_buf_copy(config_default, config);
+		if (retval < 0) {
+			LOGE("Fail to keep the default touch report config\n");
+			return retval;
+		}
+	}
 
-	tcm->isr_pid = current->pid;
+	syna_dev_get_touch_entities_in_use(tcm, mask);
+
+	syna_tcm_buf_lock(config_minimal);
 
-	/* retrieve the original report date generated by firmware */
-	retval = syna_tcm_get_event_data(tcm->tcm_dev,
-			&code,
-			&tcm->event_data);
+	retval = syna_tcm_buf_alloc(config_minimal, config_default->data_length + 1);
 	if (retval < 0) {
-		LOGE("Fail to get event data\n");
+		LOGE("Fail to allocate memory for the minimal touch report config\n");
 		goto exit;
 	}
 
-exit:
-	return IRQ_HANDLED;
-}
-
-/*
- * Request IRQ and register the interrupt handling routine.
- *
- * param
- *    [ in] tcm: pointer to the driver context
- *
- * return
- *    0 or positive value in case of success, a negative value otherwise.
- */
-static int syna_dev_request_irq(struct syna_tcm *tcm)
-{
-	int retval;
-	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
-#ifdef DEV_MANAGED_API
-	struct device *dev = syna_request_managed_device();
-
-	if (!dev) {
-		LOGE("Invalid managed device\n");
-		retval = -EINVAL;
+	size = syna_tcm_reduce_touch_report_config(config_default->buf,
+			config_default->data_length, mask,
+			config_minimal->buf, config_minimal->buf_size);
+	if (size < 0) {
+		LOGE("Fail to reduce the touch report config\n");
+		retval = size;
 		goto exit;
 	}
-#endif
 
-	if (attn->irq_gpio < 0) {
-		LOGE("Invalid IRQ GPIO\n");
-		retval = -EINVAL;
-		goto exit;
+	/* sizes of a report with one object and with all objects */
+	bits_default[0] = syna_tcm_get_touch_report_bits(config_default->buf,
+			config_default->data_length, 1);
+	bits_default[1] = syna_tcm_get_touch_report_bits(config_default->buf,
+			config_default->data_length, tcm_dev->max_objects);
+	bits_minimal[0] = syna_tcm_get_touch_report_bits(config_minimal->buf,
+			size, 1);
+	bits_minimal[1] = syna_tcm_get_touch_report_bits(config_minimal->buf,
+			size, tcm_dev->max_objects);
+
+	/* restore the default if nothing is saved */
+	if (bits_minimal[1] >= bits_default[1]) {
+		LOGI("No touch entity to reduce, use the default config\n");
+		size = (int)config_default->data_length;
+		retval = syna_pal_mem_cpy(config_minimal->buf, config_minimal->buf_size,
+				config_default->buf, config_default->buf_size, size);
+		if (retval < 0)
+			goto exit;
+		bits_minimal[0] = bits_default[0];
+		bits_minimal[1] = bits_default[1];
 	}
 
-	attn->irq_id = gpio_to_irq(attn->irq_gpio);
+	config_minimal->data_length = size;
 
-#ifdef DEV_MANAGED_API
-	retval = devm_request_threaded_irq(dev,
-			attn->irq_id,
-			NULL,
-			syna_dev_isr,
-			attn->irq_flags,
-			PLATFORM_DRIVER_NAME,
-			tcm);
-#else /* Legacy API */
-	retval = request_threaded_irq(attn->irq_id,
-			NULL,
-			syna_dev_isr,
-			attn->irq_flags,
-			PLATFORM_DRIVER_NAME,
-			tcm);
-#endif
+	/* no need to write again if the minimal config is in use */
+	if ((config->data_length >= config_minimal->data_length) &&
+		(memcmp(config->buf, config_minimal->buf, config_minimal->data_length) == 0))
+		goto exit;
+
+	retval = syna_tcm_set_touch_report_config(tcm_dev,
+			config_minimal->buf,
+			config_minimal->data_length,
+			resp_handling);
 	if (retval < 0) {
-		LOGE("Fail to request threaded irq\n");
+		LOGE("Fail to set up the minimal touch report config\n");
+		config_minimal->data_length = 0;
 		goto exit;
 	}
 
-	attn->irq_enabled = true;
+	retval = syna_tcm_preserve_touch_report_config(tcm_dev, resp_handling);
+	if (retval < 0) {
+		LOGE("Fail to preserve the minimal touch report config\n");
+		goto exit;
+	}
 
-	LOGI("Interrupt handler registered\n");
+	LOGI("Minimal touch config, bytes per frame: %d -> %d (1 object), %d -> %d (%d objects)\n",
+		syna_pal_int_division(bits_default[0], 8, true),
+		syna_pal_int_division(bits_minimal[0], 8, true),
+		syna_pal_int_division(bits_default[1], 8, true),
+		syna_pal_int_division(bits_minimal[1], 8, true),
+		tcm_dev->max_objects);
 
 exit:
+	syna_tcm_buf_unlock(config_minimal);
+
 	return retval;
 }
-
-/*
- * Release an interrupt line allocated previously
- *
- * param
- *    [ in] tcm: pointer to the driver context
- *
- * return
- *    void.
- */
-static void syna_dev_release_irq(struct syna_tcm *tcm)
-{
-	struct tcm_hw_platform *hw = &tcm->hw_if->hw_platform;
-	struct syna_hw_attn_data *attn = &tcm->hw_if->bdata_attn;
-#ifdef DEV_MANAGED_API
-	struct device *dev = syna_request_managed_device();
-
-	if (!dev) {
-		LOGE("Invalid managed device\n");
-		return;
-	}
-#endif
-
-	if (attn->irq_id <= 0)
-		return;
-
-	if (hw->ops_enable_attn)
-		hw->ops_enable_attn(hw, false);
-
-#ifdef DEV_MANAGED_API
-	devm_free_irq(dev, attn->irq_id, tcm);
-#else
-	free_irq(attn->irq_id, tcm);
 #endif
 
-	attn->irq_id = 0;
-	attn->irq_enabled = false;
-
-	LOGI("Interrupt handler released\n");
-}
-
 /*
  * Initialization including the preparation of app info and the
  * configuration of touch report.
@@ -967,6 +3611,15 @@ static int syna_dev_set_up_app_fw(struct syna_tcm *tcm)
 		return retval;
 	}
 
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+	/* reduce the format of touch report to the entities in use */
+	retval = syna_dev_set_up_minimal_touch_config(tcm, resp_handling);
+	if (retval < 0) {
+		LOGE("Fail to setup the minimal touch report format\n");
+		return retval;
+	}
+#endif
+
 #ifdef ENABLE_CUSTOM_TOUCH_ENTITY
 	/* set up custom touch data parsing method */
 	retval = syna_tcm_set_custom_touch_entity_callback(tcm_dev,
@@ -1373,6 +4026,126 @@ static int syna_dev_disp_notifier_cb(struct notifier_block *nb,
 }
 #endif
 #endif
+/*
+ * Work to complete the asynchronous command in flight once its deadline has
+ * passed, in case no ATTN arrives to retrieve the response.
+ *
+ * param
+ *    [ in] work: pointer to the work_struct
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_async_command_work(struct work_struct *work)
+{
+	struct syna_tcm *tcm = container_of(to_delayed_work(work),
+			struct syna_tcm, async_work);
+	int next_ms;
+
+	next_ms = syna_tcm_check_async_command(tcm->tcm_dev);
+	if (next_ms > 0)
+		queue_delayed_work(system_wq, &tcm->async_work,
+			msecs_to_jiffies(next_ms));
+}
+/*
+ * Submit an asynchronous command, and arm the check of its deadline.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *    [ in] cmd: context of the command
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_dev_send_command_async(struct syna_tcm *tcm,
+	struct tcm_async_command *cmd)
+{
+	int retval;
+
+	retval = syna_tcm_send_command_async(tcm->tcm_dev, cmd);
+	if (retval < 0)
+		return retval;
+
+	queue_delayed_work(system_wq, &tcm->async_work,
+		msecs_to_jiffies(tcm->tcm_dev->msg_data.command_timeout_time));
+
+	return 0;
+}
+/*
+ * Complete the asynchronous commands left, the one in flight has been
+ * terminated by the caller.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_flush_async_commands(struct syna_tcm *tcm)
+{
+	cancel_delayed_work_sync(&tcm->async_work);
+
+	if (syna_tcm_check_async_command(tcm->tcm_dev) > 0)
+		queue_delayed_work(system_wq, &tcm->async_work, 0);
+}
+#if !defined(RESET_ON_RESUME)
+/*
+ * Completion callback of the rezero issued on resume.
+ *
+ * param
+ *    [ in] cmd:           the completed command
+ *    [ in] callback_data: pointer to the driver context
+ *
+ * return
+ *    void.
+ */
+static void syna_dev_rezero_done(struct tcm_async_command *cmd,
+	void *callback_data)
+{
+	struct syna_tcm *tcm = (struct syna_tcm *)callback_data;
+
+	if (cmd->status < 0)
+		LOGE("Fail to rezero on resume, status: %d\n", cmd->status);
+
+	WRITE_ONCE(tcm->rezero_pending, false);
+}
+/*
+ * Rezero the sensing without waiting for the response, so resuming doesn't
+ * wait for the re-estimation of the baseline.
+ *
+ * param
+ *    [ in] tcm: pointer to the driver context
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_dev_rezero_async(struct syna_tcm *tcm)
+{
+	struct tcm_async_command *cmd = &tcm->rezero_cmd;
+	int retval;
+
+	/* the context is still in the submission list */
+	if (READ_ONCE(tcm->rezero_pending)) {
+		LOGW("Rezero of the last resume not completed yet\n");
+		return 0;
+	}
+
+	cmd->command = CMD_REZERO;
+	cmd->payload = NULL;
+	cmd->payload_length = 0;
+	cmd->resp = NULL;
+	cmd->private_data = tcm;
+	cmd->cb = syna_dev_rezero_done;
+
+	WRITE_ONCE(tcm->rezero_pending, true);
+
+	retval = syna_dev_send_command_async(tcm, cmd);
+	if (retval < 0)
+		WRITE_ONCE(tcm->rezero_pending, false);
+
+	return retval;
+}
+#endif
 /*
  * Resume from the suspend state.
  *
@@ -1389,7 +4162,9 @@ static int syna_dev_resume(struct device *dev)
 	struct tcm_dev *tcm_dev;
 	struct syna_hw_interface *hw_if;
 	struct syna_hw_attn_data *attn;
+#if defined(RESET_ON_RESUME) && !defined(HW_RESET_ON_RESUME)
 	unsigned int resp_handling;
+#endif
 
 	if (!tcm)
 		return -EINVAL;
@@ -1397,16 +4172,21 @@ static int syna_dev_resume(struct device *dev)
 	tcm_dev = tcm->tcm_dev;
 	hw_if = tcm->hw_if;
 	attn = &hw_if->bdata_attn;
+#if defined(RESET_ON_RESUME) && !defined(HW_RESET_ON_RESUME)
 	if (attn && (attn->irq_id) && (attn->irq_enabled))
 		resp_handling = CMD_RESPONSE_IN_ATTN;
 	else
 		resp_handling = tcm_dev->msg_data.command_polling_time;
+#endif
 
 	if (tcm->pwr_state == PWR_ON)
 		return 0;
 
 	LOGI("Prepare to resume device\n");
 
+#if defined(ENABLE_REPORT_PIPELINE)
+	syna_dev_flush_report_pipeline(tcm);
+#endif
 	/* clear all input events  */
 	syna_dev_free_input_events(tcm);
 
@@ -1421,6 +4201,17 @@ static int syna_dev_resume(struct device *dev)
 	/* enable irq */
 	if ((!attn->irq_enabled) && (hw_if->hw_platform.ops_enable_attn))
 		hw_if->hw_platform.ops_enable_attn(&hw_if->hw_platform, true);
+#if defined(ENABLE_REPORT_POLLING)
+	if (!hw_if->hw_platform.support_attn)
+		syna_dev_enable_report_polling(tcm, true);
+#endif
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	tcm->hybrid.streak = 0;
+	tcm->hybrid.since = ktime_get();
+#endif
+#if defined(ENABLE_CLOCK_SYNC)
+	syna_dev_reset_clock_sync(tcm);
+#endif
 #else
 	/* power on the device */
 	if (hw_if->ops_power_on)
@@ -1429,6 +4220,17 @@ static int syna_dev_resume(struct device *dev)
 	/* enable irq */
 	if ((!attn->irq_enabled) && (hw_if->hw_platform.ops_enable_attn))
 		hw_if->hw_platform.ops_enable_attn(&hw_if->hw_platform, true);
+#if defined(ENABLE_REPORT_POLLING)
+	if (!hw_if->hw_platform.support_attn)
+		syna_dev_enable_report_polling(tcm, true);
+#endif
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	tcm->hybrid.streak = 0;
+	tcm->hybrid.since = ktime_get();
+#endif
+#if defined(ENABLE_CLOCK_SYNC)
+	syna_dev_reset_clock_sync(tcm);
+#endif
 
 	syna_pal_sleep_ms(DEV_POWER_SWITCHING_DELAY_MS);
 #endif
@@ -1457,12 +4259,6 @@ static int syna_dev_resume(struct device *dev)
 		LOGW("Device is not in the application mode after reset\n");
 		goto exit;
 	}
-#else
-	retval = syna_tcm_rezero(tcm->tcm_dev, resp_handling);
-	if (retval < 0) {
-		LOGE("Fail to rezero\n");
-		goto exit;
-	}
 #endif
 
 	tcm->pwr_state = PWR_ON;
@@ -1476,6 +4272,15 @@ static int syna_dev_resume(struct device *dev)
 		goto exit;
 	}
 
+#if !defined(RESET_ON_RESUME)
+	/* rezero at last, its response is retrieved once resumed */
+	retval = syna_dev_rezero_async(tcm);
+	if (retval < 0) {
+		LOGE("Fail to rezero\n");
+		goto exit;
+	}
+#endif
+
 	retval = 0;
 
 	LOGI("Device resumed (pwr_state:%d)\n", tcm->pwr_state);
@@ -1503,11 +4308,28 @@ static int syna_dev_suspend(struct device *dev)
 
 	LOGI("Prepare to suspend device\n");
 
+#if defined(ENABLE_REPORT_PIPELINE)
+	/* complete the reports fetched before releasing the events */
+	syna_dev_flush_report_pipeline(tcm);
+#endif
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	/* the frame held is superseded by the release of events */
+	syna_dev_stop_vsync_delivery(tcm, false);
+#endif
 	/* clear all input events */
 	syna_dev_free_input_events(tcm);
 
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_stop_touch_boost(tcm);
+#endif
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	/* back to interrupts, so the lpwg reports are able to wake the system */
+	syna_dev_stop_hybrid_mode(tcm);
+#endif
+
 	/* clear all pending commands */
 	syna_tcm_clear_command_processing(tcm->tcm_dev);
+	syna_dev_flush_async_commands(tcm);
 
 #ifdef LOW_POWER_MODE
 	/* enter power saved mode */
@@ -1521,10 +4343,17 @@ static int syna_dev_suspend(struct device *dev)
 	 */
 	if ((tcm->pwr_state != LOW_PWR_GESTURE) && (hw_if->hw_platform.ops_enable_attn))
 		hw_if->hw_platform.ops_enable_attn(&hw_if->hw_platform, false);
+#if defined(ENABLE_REPORT_POLLING)
+	if (tcm->pwr_state != LOW_PWR_GESTURE)
+		syna_dev_enable_report_polling(tcm, false);
+#endif
 #else
 	/* disable the attn before powering off */
 	if (hw_if->hw_platform.ops_enable_attn)
 		hw_if->hw_platform.ops_enable_attn(&hw_if->hw_platform, false);
+#if defined(ENABLE_REPORT_POLLING)
+	syna_dev_enable_report_polling(tcm, false);
+#endif
 
 	/* power off the device */
 	if (hw_if->ops_power_on)
@@ -1553,6 +4382,7 @@ static void syna_dev_show_info(struct syna_tcm *tcm)
 	bool startup_reflash_enabled = false;
 	bool rst_on_resume_enabled = false;
 	bool background_helper_enabled  = false;
+	bool report_pipeline_enabled = false;
 
 	if (!tcm->is_connected)
 		return;
@@ -1572,6 +4402,9 @@ static void syna_dev_show_info(struct syna_tcm *tcm)
 #ifdef ENABLE_HELPER
 	background_helper_enabled = true;
 #endif
+#ifdef ENABLE_REPORT_PIPELINE
+	report_pipeline_enabled = (tcm->report_pipe.worker != NULL);
+#endif
 
 #ifdef TOUCHCOMM_TDDI
 	LOGI("Config: touch/display devices, multichip(%s)\n",
@@ -1585,6 +4418,8 @@ static void syna_dev_show_info(struct syna_tcm *tcm)
 		(tcm->lpwg_enabled) ? "yes" : "no",
 		(has_custom_tp_config) ? "yes" : "no",
 		(background_helper_enabled) ? "yes" : "no");
+	LOGI("Config: report pipeline(%s)\n",
+		(report_pipeline_enabled) ? "yes" : "no");
 }
 
 /*
@@ -1619,10 +4454,20 @@ static int syna_dev_disconnect(struct syna_tcm *tcm)
 	}
 #endif
 
+#if defined(ENABLE_REPORT_POLLING)
+	/* stopped ahead of the interrupt line that the hybrid mode may turn on */
+	syna_dev_release_report_polling(tcm);
+#endif
 	/* free interrupt line */
 	if (hw_if->bdata_attn.irq_id)
 		syna_dev_release_irq(tcm);
 
+	cancel_delayed_work_sync(&tcm->async_work);
+
+#if defined(ENABLE_REPORT_PIPELINE)
+	syna_dev_flush_report_pipeline(tcm);
+#endif
+
 	/* unregister input device */
 #if defined(TOUCHCOMM_TDDI) && defined(REPORT_KNOB)
 	syna_dev_release_input_knob_device(tcm);
@@ -1744,20 +4589,39 @@ static int syna_dev_connect(struct syna_tcm *tcm)
 		LOGE("Fail to register the handling function of unexpected reset\n");
 
 	/* register the interrupt handler */
+#if defined(ENABLE_REPORT_POLLING)
+	if (!hw_if->hw_platform.support_attn) {
+		retval = syna_dev_create_report_polling(tcm);
+		if (retval >= 0) {
+			syna_dev_enable_report_polling(tcm, true);
+			LOGI("No ATTN routed, polling reports instead\n");
+		}
+	} else
+#endif
 	retval = syna_dev_request_irq(tcm);
 	if (retval < 0) {
 		LOGE("Fail to request the interrupt line\n");
 		goto err_request_irq;
 	}
 
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	/* the polling engine is started once the reports keep arriving */
+	if (hw_if->hw_platform.support_attn) {
+		if (syna_dev_create_report_polling(tcm) < 0)
+			LOGW("Fail to create report polling, no hybrid mode\n");
+	}
+#endif
+
 	/* for the reference,
 	 * create a delayed work to perform fw update during the startup time
 	 */
 #if defined(STARTUP_REFLASH) || defined(FLASH_RECOVERY)
-	tcm->reflash_workqueue = create_singlethread_workqueue("syna_reflash");
+	/* per-cpu with one work in flight, so the work can be kept away from the irq cpus */
+	tcm->reflash_workqueue = alloc_workqueue("syna_reflash", WQ_MEM_RECLAIM, 1);
 	INIT_DELAYED_WORK(&tcm->reflash_work, syna_dev_reflash_startup_work);
 #if defined(STARTUP_REFLASH)
-	queue_delayed_work(tcm->reflash_workqueue, &tcm->reflash_work, msecs_to_jiffies(200));
+	queue_delayed_work_on(syna_dev_get_housekeeping_cpu(tcm), tcm->reflash_workqueue,
+		&tcm->reflash_work, msecs_to_jiffies(200));
 #endif
 #endif
 
@@ -1804,6 +4668,12 @@ static void syna_dev_panel_enable(struct drm_bridge *bridge)
 	struct syna_tcm *tcm =
 			container_of(bridge, struct syna_tcm, panel_bridge);
 
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	/* vblanks of the crtc driving the panel */
+	syna_dev_attach_vsync_delivery(tcm,
+		(bridge->encoder) ? bridge->encoder->crtc : NULL);
+#endif
+
 	LOGD("Panel bridge enabled (pwr_state:%d)\n", tcm->pwr_state);
 }
 
@@ -1812,6 +4682,11 @@ static void syna_dev_panel_disable(struct drm_bridge *bridge)
 	struct syna_tcm *tcm =
 			container_of(bridge, struct syna_tcm, panel_bridge);
 
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	/* no vblank any more, the frames are reported in place */
+	syna_dev_stop_vsync_delivery(tcm, true);
+#endif
+
 	LOGD("Panel bridge disabled (pwr_state:%d)\n", tcm->pwr_state);
 }
 
@@ -1880,6 +4755,8 @@ static void syna_dev_unregister_panel(struct drm_bridge *bridge)
 static int syna_dev_probe(struct platform_device *pdev)
 {
 	int retval;
+	unsigned int input_opts;
+	unsigned int cpu;
 	struct syna_tcm *tcm = NULL;
 	struct tcm_dev *tcm_dev = NULL;
 	struct syna_hw_interface *hw_if = NULL;
@@ -1918,15 +4795,57 @@ static int syna_dev_probe(struct platform_device *pdev)
 	}
 
 	/* basic initialization */
-	syna_tcm_buf_init(&tcm->event_data);
-
 	syna_pal_mutex_alloc(&tcm->tp_event_mutex);
 
-#ifdef ENABLE_WAKEUP_GESTURE
-	tcm->lpwg_enabled = true;
-#else
-	tcm->lpwg_enabled = false;
+	/* scheduling of the irq thread, given in dt */
+	tcm->irq_sched.prio = 0;
+	if (hw_if->bdata_attn.irq_thread_prio < MAX_RT_PRIO)
+		tcm->irq_sched.prio = hw_if->bdata_attn.irq_thread_prio;
+	cpumask_clear(&tcm->irq_sched.cpus);
+	for (cpu = 0; (cpu < 32) && (cpu < nr_cpu_ids); cpu++) {
+		if (hw_if->bdata_attn.irq_cpus & BIT(cpu))
+			cpumask_set_cpu(cpu, &tcm->irq_sched.cpus);
+	}
+	atomic_set(&tcm->irq_sched.prio_update, 0);
+	seqcount_init(&tcm->tp_snapshot.seq);
+	init_waitqueue_head(&tcm->tp_snapshot.wait);
+	tcm->tp_snapshot.demand_until = jiffies;
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	syna_pal_mem_set(&tcm->hybrid, 0, sizeof(tcm->hybrid));
+	tcm->hybrid.enter_reports = (hw_if->bdata_attn.hybrid_enter_reports > 0) ?
+		hw_if->bdata_attn.hybrid_enter_reports : HYBRID_ENTER_REPORTS_DEFAULT;
+	tcm->hybrid.exit_polls = HYBRID_EXIT_POLLS_DEFAULT;
+	tcm->hybrid.since = ktime_get();
+#endif
+#if defined(ENABLE_CLOCK_SYNC)
+	syna_pal_mem_set(&tcm->clock_sync, 0, sizeof(tcm->clock_sync));
+	spin_lock_init(&tcm->clock_sync.lock);
+	tcm->clock_sync.tick_ns = CLOCK_SYNC_TICK_NS_DEFAULT;
+#endif
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	syna_dev_init_vsync_delivery(tcm);
 #endif
+
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_init_touch_boost(tcm);
+#endif
+	INIT_DELAYED_WORK(&tcm->async_work, syna_dev_async_command_work);
+#if defined(ENABLE_REPORT_PIPELINE)
+	syna_dev_create_report_pipeline(tcm);
+#endif
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+	syna_tcm_buf_init(&tcm->touch_config_default);
+	syna_tcm_buf_init(&tcm->touch_config_minimal);
+	syna_pal_mem_set(tcm->cdev_touch_entities, 0, sizeof(tcm->cdev_touch_entities));
+#endif
+
+	/* options of input reporting, the defaults can be overridden by dt */
+	input_opts = syna_dev_get_default_input_options();
+	input_opts &= ~hw_if->product.input_opts_mask;
+	input_opts |= (hw_if->product.input_opts & hw_if->product.input_opts_mask);
+	syna_dev_set_input_options(tcm, input_opts);
+
 #ifdef TOUCHCOMM_TDDI
 #ifdef IS_TDDI_MULTICHIP
 	tcm->is_tddi_multichip = true;
@@ -2000,8 +4919,9 @@ static int syna_dev_probe(struct platform_device *pdev)
 
 #if defined(ENABLE_HELPER)
 	ATOMIC_SET(tcm->helper.task, HELP_NONE);
+	/* per-cpu with one work in flight, so the work can be kept away from the irq cpus */
 	tcm->helper.workqueue =
-			create_singlethread_workqueue("synaptics_tcm_helper");
+			alloc_workqueue("synaptics_tcm_helper", WQ_MEM_RECLAIM, 1);
 	INIT_WORK(&tcm->helper.work, syna_dev_helper_work);
 #endif
 
@@ -2029,7 +4949,16 @@ err_create_cdev:
 #ifndef FORCE_CONNECTION
 err_connect:
 #endif
-	syna_tcm_buf_release(&tcm->event_data);
+#if defined(ENABLE_REPORT_PIPELINE)
+	syna_dev_release_report_pipeline(tcm);
+#endif
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_release_touch_boost(tcm);
+#endif
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+	syna_tcm_buf_release(&tcm->touch_config_default);
+	syna_tcm_buf_release(&tcm->touch_config_minimal);
+#endif
 	syna_pal_mutex_free(&tcm->tp_event_mutex);
 err_setup_timings:
 	syna_tcm_remove_device(tcm_dev);
@@ -2073,6 +5002,11 @@ static int syna_dev_remove(struct platform_device *pdev)
 #endif
 #if defined(ENABLE_DISP_NOTIFIER)
 #if defined(USE_DRM_BRIDGE)
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	syna_dev_stop_vsync_delivery(tcm, true);
+	syna_pal_mutex_free(&tcm->vsync.deliver_mutex);
+	syna_pal_mutex_free(&tcm->vsync.mutex);
+#endif
 	syna_dev_unregister_panel(&tcm->panel_bridge);
 #else
 	fb_unregister_client(&tcm->fb_notifier);
@@ -2085,14 +5019,28 @@ static int syna_dev_remove(struct platform_device *pdev)
 	/* remove the cdev and sysfs nodes */
 	syna_cdev_remove(tcm);
 
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_stop_touch_boost(tcm);
+#endif
+
 	/* check the connection status, and do disconnection */
 	if (syna_dev_disconnect(tcm) < 0)
 		LOGE("Fail to do device disconnection\n");
 
+#if defined(ENABLE_REPORT_PIPELINE)
+	syna_dev_release_report_pipeline(tcm);
+#endif
+#if defined(ENABLE_TOUCH_BOOST)
+	syna_dev_release_touch_boost(tcm);
+#endif
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+	syna_tcm_buf_release(&tcm->touch_config_default);
+	syna_tcm_buf_release(&tcm->touch_config_minimal);
+#endif
+
 	if (tcm->userspace_app_info != NULL)
 		syna_pal_mem_free(tcm->userspace_app_info);
 
-	syna_tcm_buf_release(&tcm->event_data);
 	syna_pal_mutex_free(&tcm->tp_event_mutex);
 
 	/* remove the allocated tcm device */
@@ -39,6 +39,7 @@
 #include "syna_tcm2_platform.h"
 #include "synaptics_touchcom_core_dev.h"
 #include "synaptics_touchcom_func_base.h"
+#include "synaptics_touchcom_func_touch.h"
 
 #define PLATFORM_DRIVER_NAME "synaptics_tcm"
 
@@ -81,7 +82,16 @@
  * Driver Configuration Flags
  */
 
-/* Use Type B (multi-touch) input protocol */
+/* Default number of reports drained per interrupt */
+#define IRQ_DRAIN_BUDGET_DEFAULT (4)
+
+/* Number of buckets in the histogram of irq wakeup latency */
+#define IRQ_LATENCY_BUCKETS (6)
+
+/* Use Type B (multi-touch) input protocol
+ * This and the following input options are the defaults, which can be
+ * overridden by the device tree or the sysfs attribute 'input_options'
+ */
 #define TYPE_B_PROTOCOL
 
 /* Reset the touch controller on device connect */
@@ -99,16 +109,16 @@
 /* #define LOW_POWER_MODE */
 
 #if defined(LOW_POWER_MODE)
-/* Enable wake-up gesture support */
+/* Enable wake-up gesture support (input option) */
 /* #define ENABLE_WAKEUP_GESTURE */
 #endif
 
-/* Transform reported touch coordinates before input event processing */
+/* Transform reported touch coordinates before input event processing (input options) */
 /* #define REPORT_SWAP_XY */
 /* #define REPORT_FLIP_X */
 /* #define REPORT_FLIP_Y */
 
-/* Include touch width in input reports */
+/* Include touch width in input reports (input option) */
 #define REPORT_TOUCH_WIDTH
 
 #if defined(TOUCHCOMM_TDDI)
@@ -127,6 +137,13 @@
 /* Use a custom touch report format defined in syna_tcm2.c */
 /* #define USE_CUSTOM_TOUCH_REPORT_CONFIG */
 
+/* Reduce the touch report format to the entities in use, including
+ * those requested through the character device
+ */
+#if !defined(USE_CUSTOM_TOUCH_REPORT_CONFIG)
+/* #define USE_MINIMAL_TOUCH_REPORT_CONFIG */
+#endif
+
 /* Parse custom touch entity codes */
 /* #define ENABLE_CUSTOM_TOUCH_ENTITY */
 
@@ -161,12 +178,58 @@
 /* Forward frame data to userspace */
 #define ENABLE_EXTERNAL_FRAME_PROCESS
 
+/* Forward the frames through a ring of fixed-size slots mapped into the
+ * userspace by mmap(), rather than one ioctl per frame
+ */
+#if defined(ENABLE_EXTERNAL_FRAME_PROCESS)
+#define ENABLE_FRAME_RING_MMAP
+#endif
+
 /* Allow driver installation even if errors occur */
 #define FORCE_CONNECTION
 
 /* Perform additional tasks in background workqueue */
 /* #define ENABLE_HELPER */
 
+/* Parse and report touch events in a rt worker thread, so the IRQ
+ * thread is able to fetch the next report in the meantime; it costs a
+ * wakeup per report, so it only pays off when the bus reads are long
+ */
+/* #define ENABLE_REPORT_PIPELINE */
+
+/* Hold a cpu latency request and clamp up the utilization of the driver
+ * threads from the touch-down, so the first reports are not delayed by deep idle
+ * states or the minimum frequency
+ */
+#define ENABLE_TOUCH_BOOST
+
+/* Acquire the touch reports by a periodic timer on the platform where
+ * no ATTN is routed
+ */
+#define ENABLE_REPORT_POLLING
+
+/* Mask ATTN and fetch the reports by the timer aligned to the frame period,
+ * once the reports arrive back-to-back at a high rate; fall back to the
+ * interrupts once the reports stop
+ */
+#if defined(ENABLE_REPORT_POLLING)
+#define ENABLE_HYBRID_REPORT_MODE
+#endif
+
+/* Map the firmware timestamps of touch reports onto the host monotonic
+ * clock, so the events are stamped with the time of scan rather than the
+ * time of ATTN
+ */
+#define ENABLE_CLOCK_SYNC
+
+/* Deliver the freshest touch frame right before the vblank of display
+ * the panel bridge is attached to, rather than at arbitrary phase
+ * (requires the vblank work of drm, kernel 5.11 or later)
+ */
+#if defined(USE_DRM_BRIDGE) && (KERNEL_VERSION(5, 11, 0) <= LINUX_VERSION_CODE)
+#define ENABLE_VSYNC_ALIGNED_REPORT
+#endif
+
 /* Enable support for TDDI multichip architecture */
 #if defined(TOUCHCOMM_TDDI)
 /* #define IS_TDDI_MULTICHIP */
@@ -204,6 +267,331 @@ struct syna_tcm_helper {
 };
 #endif
 
+#if defined(ENABLE_TOUCH_BOOST)
+/* Default thresholds of touch boost */
+#define TOUCH_BOOST_LATENCY_US_DEFAULT (100)
+#define TOUCH_BOOST_IDLE_MS_DEFAULT (200)
+#define TOUCH_BOOST_UCLAMP_MIN_DEFAULT (512)
+
+/* Threads of the driver clamped while boosting */
+enum touch_boost_threads {
+	TOUCH_BOOST_IRQ_THREAD = 0,
+	TOUCH_BOOST_POLL_THREAD,
+	TOUCH_BOOST_REPORT_THREAD,
+	TOUCH_BOOST_THREADS,
+};
+
+/* Definitions of the boost taken while fingers are down
+ *
+ * The boost is taken once a touch report arrives in the normal power mode,
+ * and dropped by the work when no slot is active for the idle time since
+ * the last report. Only the threads registered by the driver are clamped.
+ */
+struct syna_touch_boost {
+	syna_pal_mutex_t mutex;
+	struct pm_qos_request qos;
+	struct delayed_work release_work;
+	struct touch_boost_thread {
+		struct task_struct *task;
+		unsigned int saved_uclamp_min;
+	} threads[TOUCH_BOOST_THREADS];
+	unsigned long last_report;
+	bool active;
+	/* thresholds, tunable via sysfs */
+	unsigned int latency_us;
+	unsigned int idle_ms;
+	unsigned int uclamp_min;
+	/* statistics of the transitions */
+	struct touch_boost_stats {
+		unsigned int on;
+		unsigned int off;
+	} stats;
+};
+#endif
+
+#if defined(ENABLE_REPORT_POLLING)
+/* Default rates of report polling, in Hz */
+#define REPORT_POLLING_RATE_HZ_DEFAULT (120)
+#define REPORT_POLLING_IDLE_HZ_DEFAULT (20)
+#define REPORT_POLLING_RATE_HZ_MAX (1000)
+/* Time without any report to drop to the idle rate */
+#define REPORT_POLLING_IDLE_DELAY_MS (500)
+
+/* Definitions of the report polling engine
+ *
+ * The hrtimer counts the ticks and wakes up the thread, which requests
+ * the reports as the IRQ thread does once ATTN is asserted.
+ */
+struct syna_report_polling {
+	struct hrtimer timer;
+	struct task_struct *task;
+	syna_pal_mutex_t mutex;
+	atomic_t ticks;
+	ktime_t period;
+	ktime_t last_active;
+	bool active;
+	bool running;
+	/* statistics of the polls */
+	struct report_polling_stats {
+		unsigned int polls;
+		unsigned int reports;
+		unsigned int skipped;
+		unsigned int ramp_up;
+		unsigned int ramp_down;
+	} stats;
+};
+#endif
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+/* Default thresholds of the hybrid mode, off unless enabled by DT or sysfs */
+#define HYBRID_ENTER_REPORTS_DEFAULT (0)
+#define HYBRID_EXIT_POLLS_DEFAULT (4)
+/* Min. rate of the reports taken as back-to-back */
+#define HYBRID_MIN_RATE_HZ (200)
+
+/* Definitions of the hybrid interrupt/polling mode
+ *
+ * The interrupt mode is left after the given number of back-to-back reports,
+ * and the report polling engine is run at the frame period observed. The
+ * polling mode is left after the given number of polls without any report,
+ * or once a command is in progress, since its response is waited on ATTN.
+ */
+struct syna_hybrid_mode {
+	bool polling;
+	/* thresholds, tunable via sysfs; enter_reports '0' to disable */
+	unsigned int enter_reports;
+	unsigned int exit_polls;
+	/* tracking of the reports */
+	unsigned int streak;
+	unsigned int empty_polls;
+	ktime_t last_attn;
+	ktime_t period;
+	ktime_t since;
+	/* statistics of the modes, time in microseconds */
+	struct hybrid_mode_stats {
+		unsigned int enters;
+		unsigned int exits;
+		unsigned long long irq_us;
+		unsigned long long poll_us;
+	} stats;
+};
+#endif
+
+#if defined(ENABLE_CLOCK_SYNC)
+/* Number of samples to fit, power of 2 */
+#define CLOCK_SYNC_WINDOW (16)
+/* Min. samples before the model is used */
+#define CLOCK_SYNC_MIN_SAMPLES (8)
+/* Gap of reports to restart the fitting, the drift over a longer gap
+ * could exceed half a wrap of a narrow timestamp
+ */
+#define CLOCK_SYNC_GAP_MS (500)
+/* Prediction error to take as a jump of the firmware clock */
+#define CLOCK_SYNC_RESYNC_US (5000)
+/* Default nominal period of a firmware tick */
+#define CLOCK_SYNC_TICK_NS_DEFAULT (1000)
+
+/* Definitions of the clock synchronization
+ *
+ * The pairs of the firmware timestamp and the ATTN time are fitted to
+ *   scan_time = base_time + offset + rate * (ticks - base_ticks)
+ * The rate is the least-squares slope over the window, and the offset is the
+ * lower envelope of the residuals, since the delay from the scan to ATTN is
+ * never negative; the constant delay of firmware is not observable, and
+ * remains in the offset.
+ */
+struct syna_clock_sync {
+	spinlock_t lock;
+	unsigned int tick_ns;
+	bool locked;
+	/* unwrapping of the firmware timestamp */
+	unsigned int bits;
+	unsigned int last_raw;
+	u64 last_ticks;
+	u64 epoch;
+	ktime_t last_attn;
+	/* samples in the window */
+	unsigned int head;
+	unsigned int count;
+	u64 ticks[CLOCK_SYNC_WINDOW];
+	s64 attn_ns[CLOCK_SYNC_WINDOW];
+	/* model fitted, rate in ns per tick in q16 */
+	u64 base_ticks;
+	s64 base_ns;
+	s64 offset_ns;
+	u64 rate_q16;
+	/* statistics */
+	struct clock_sync_stats {
+		unsigned int samples;
+		unsigned int wraps;
+		unsigned int resyncs;
+		unsigned int residual_samples;
+		unsigned long long residual_us;
+		unsigned int max_residual_us;
+		int drift_ppm;
+	} stats;
+};
+#endif
+
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+/* Modes of the vsync-aligned delivery */
+enum vsync_delivery_mode {
+	VSYNC_DELIVERY_OFF = 0,
+	VSYNC_DELIVERY_LATEST = 1,
+	VSYNC_DELIVERY_EXTRAPOLATED = 2,
+};
+/* Default lead time of delivery ahead of the vblank */
+#define VSYNC_LEAD_US_DEFAULT (2000)
+/* Vblanks without any frame to stop the tracking of vblank */
+#define VSYNC_IDLE_VBLANKS (4)
+/* Max. interval of frames to estimate the velocities of objects */
+#define VSYNC_VELOCITY_WINDOW_MS (50)
+
+/* Definitions of the vsync-aligned delivery
+ *
+ * While the touch frames arrive, the vblanks are tracked by the vblank
+ * work of crtc the panel bridge is attached to. The frames parsed are held,
+ * and only the latest one is delivered at the lead time before the next
+ * vblank; positions are extrapolated to the vblank if requested. A lift held
+ * is delivered at once if the slot is touched again within the period.
+ *
+ * While a frame is held or being delivered, the following frames are queued
+ * behind it even if the mode is turned off, so they are never reported out
+ * of order.
+ */
+struct syna_vsync_delivery {
+	syna_pal_mutex_t mutex;
+	/* serialize the deliveries by the work and by the report context */
+	syna_pal_mutex_t deliver_mutex;
+	unsigned int mode;
+	unsigned int lead_us;
+	struct drm_crtc *crtc;
+	struct drm_vblank_work vblank_work;
+	struct hrtimer timer;
+	struct work_struct deliver_work;
+	bool tracking;
+	bool timed;
+	unsigned int frames;
+	unsigned int idle_vblanks;
+	u64 vblank_count;
+	ktime_t period;
+	ktime_t vblank_time;
+	ktime_t deadline;
+	/* the latest frame held, protected by the lock */
+	spinlock_t lock;
+	bool pending;
+	bool busy;
+	unsigned int dirty;
+	ktime_t frame_time;
+	struct tcm_touch_data_blob frame;
+	/* frame being delivered */
+	struct tcm_touch_data_blob out;
+	/* velocities in units per second, for the extrapolation */
+	int vx[MAX_NUM_OBJECTS];
+	int vy[MAX_NUM_OBJECTS];
+	/* statistics, time in microseconds */
+	struct vsync_delivery_stats {
+		unsigned int vblanks;
+		unsigned int delivered;
+		unsigned int coalesced;
+		unsigned int phase_samples;
+		unsigned long long phase_err_us;
+		unsigned int max_phase_err_us;
+		unsigned int predict_samples;
+		unsigned long long predict_err_us;
+		unsigned int max_predict_err_us;
+	} stats;
+};
+#endif
+
+#if defined(ENABLE_FRAME_RING_MMAP)
+/* Number of slots in the frame ring, power of 2 */
+#define FRAME_RING_SLOTS (64)
+/* Bounds of the size of a slot, including the slot header */
+#define FRAME_RING_SLOT_SIZE_MIN (512)
+#define FRAME_RING_SLOT_SIZE_MAX (65536)
+
+/* Definitions of the frame ring shared with userspace
+ *
+ * The ring is allocated at the first mmap() of a file, with the slots sized
+ * to the largest frame of the device, and it is kept until the device is
+ * removed unless the size changes. The ring is owned by the file mapping it
+ * until that file is released. The layout is declared in syna_tcm2_cdev.h;
+ * the driver keeps its own copy of the head, and never trusts the indices
+ * read back from the mapping other than to check the room.
+ */
+struct syna_frame_ring {
+	void *buf;
+	unsigned int size;
+	struct syna_frame_ring_ctrl *ctrl;
+	unsigned char *data;
+	unsigned int slots;
+	unsigned int slot_size;
+	unsigned int head;
+	struct file *owner;
+	bool mapped;
+};
+#endif
+
+#if defined(ENABLE_REPORT_PIPELINE)
+/* Number of touch reports queued to the report stage, power of 2 */
+#define REPORT_RING_DEPTH (8)
+
+/* A touch report fetched, held in the frame buffer */
+struct syna_report_entry {
+	struct tcm_frame_buffer *frame;
+	unsigned int length;
+	ktime_t attn_time;
+	ktime_t fetch_time;
+};
+
+/* Definitions of the two-stage report pipeline
+ *
+ * The IRQ thread is the only producer, since the reports are dispatched one
+ * at a time by the core library; the worker is the only consumer. The worker
+ * thread is scheduled the same as the IRQ thread.
+ */
+struct syna_report_pipeline {
+	DECLARE_KFIFO(ring, struct syna_report_entry, REPORT_RING_DEPTH);
+	struct kthread_work work;
+	struct kthread_worker *worker;
+	/* statistics of the stages, in microseconds, protected by the lock */
+	spinlock_t lock;
+	struct report_pipeline_stats {
+		unsigned int queued;
+		unsigned int max_depth;
+		unsigned int stalls;
+		unsigned int in_place;
+		unsigned long long fetch_us;
+		unsigned int max_fetch_us;
+		unsigned long long report_us;
+		unsigned int max_report_us;
+	} stats;
+};
+#endif
+
+/* Time to keep publishing the touch data since the latest read, and
+ * time for a reader to wait for a fresh frame, in milliseconds
+ */
+#define TOUCH_DATA_DEMAND_MS (1000)
+#define TOUCH_DATA_WAIT_MS (100)
+
+/* Snapshots of the parsed touch data shared with the readers
+ *
+ * The report stage is the only writer. It fills the buffer not being
+ * published and then flips the index under the seqcount, so readers
+ * retry instead of blocking the writer. The copy is made only while a
+ * reader has shown up recently, since nothing else consumes it.
+ */
+struct syna_touch_data_snapshot {
+	seqcount_t seq;
+	unsigned int idx;
+	unsigned int frames;
+	unsigned long demand_until;
+	wait_queue_head_t wait;
+	struct tcm_touch_data_blob blob[2];
+};
+
 /*
  * Synaptics TouchComm driver context
  *
@@ -217,18 +605,51 @@ struct syna_tcm {
 	/* Platform device handle */
 	struct platform_device *pdev;
 
-	/* Touch data and status tracking */
+	/* Touch data and status tracking
+	 * tp_data is the working copy owned by the report stage, while the
+	 * other readers access the snapshot published on demand
+	 */
 	struct tcm_touch_data_blob tp_data;
+	struct syna_touch_data_snapshot tp_snapshot;
 	unsigned char prev_obj_status[MAX_NUM_OBJECTS];
+	/* slots changed but not yet reported, and slots being touched */
+	unsigned long pending_objects;
+	unsigned long touching_objects;
 
 	/* Hardware interface abstraction */
 	struct syna_hw_interface *hw_if;
 
-	/* IRQ handling */
+	/* IRQ handling
+	 * tp_event_mutex serializes the input reporting with the release
+	 * and re-creation of the input device
+	 */
 	syna_pal_mutex_t tp_event_mutex;
-	struct tcm_buffer event_data;
 	pid_t isr_pid;
 	bool irq_wake;
+	/* time of the report being processed, taken at the ATTN edge
+	 * in hard-IRQ context; zero if not driven by the interrupt
+	 */
+	ktime_t irq_timestamp;
+	/* statistics of the reports drained per interrupt, and the latency
+	 * from the ATTN edge to the threaded handler in microseconds
+	 */
+	struct isr_stats {
+		unsigned int wakeups;
+		unsigned int reports;
+		unsigned int max_reports;
+		unsigned long long latency_us;
+		unsigned int max_latency_us;
+		unsigned int latency_hist[IRQ_LATENCY_BUCKETS];
+	} isr_stats;
+	/* scheduling of the irq thread, or the polling thread */
+	struct syna_irq_sched {
+		/* rt priority, '0' to use the default */
+		unsigned int prio;
+		/* cpus to run on, empty to use the default */
+		struct cpumask cpus;
+		/* the priority is applied by the thread itself */
+		atomic_t prio_update;
+	} irq_sched;
 
 	/* Character device interface */
 	struct cdev char_dev;
@@ -252,7 +673,10 @@ struct syna_tcm {
 		unsigned int max_x;
 		unsigned int max_y;
 		unsigned int max_objects;
+		unsigned int opts;
 	} input_dev_params;
+	/* options of input reporting, bits of enum input_option */
+	unsigned int input_opts;
 #ifdef REPORT_KNOB
 	struct input_dev *input_knob_dev[MAX_NUM_KNOB_OBJECTS];
 #endif
@@ -275,6 +699,16 @@ struct syna_tcm {
 #endif
 #endif
 
+#if defined(ENABLE_CLOCK_SYNC)
+	/* Firmware timestamps mapped onto the host clock */
+	struct syna_clock_sync clock_sync;
+#endif
+
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	/* Delivery of touch frames aligned to the vblank */
+	struct syna_vsync_delivery vsync;
+#endif
+
 #ifdef PID_TASK
 	pid_t proc_pid;
 	struct task_struct *proc_task;
@@ -289,11 +723,42 @@ struct syna_tcm {
 	unsigned int fifo_depth;
 #endif
 
+#if defined(ENABLE_FRAME_RING_MMAP)
+	/* Frame ring shared with userspace */
+	struct syna_frame_ring frame_ring;
+#endif
+
 #if defined(ENABLE_HELPER)
 	/* Background workqueue */
 	struct syna_tcm_helper helper;
 #endif
 
+#if defined(ENABLE_REPORT_PIPELINE)
+	/* Stage to parse and report touch events */
+	struct syna_report_pipeline report_pipe;
+#endif
+
+#if defined(ENABLE_REPORT_POLLING)
+	/* Report acquisition without ATTN */
+	struct syna_report_polling report_poll;
+#endif
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	/* Switching between the interrupt and polling */
+	struct syna_hybrid_mode hybrid;
+#endif
+
+#if defined(ENABLE_TOUCH_BOOST)
+	/* Boost while fingers are down */
+	struct syna_touch_boost boost;
+#endif
+
+	/* Deadline of the asynchronous commands, checked without an ATTN */
+	struct delayed_work async_work;
+	/* Rezero issued on resume without waiting for its response */
+	struct tcm_async_command rezero_cmd;
+	bool rezero_pending;
+
 	/* Driver state flags */
 	int pwr_state;
 	bool lpwg_enabled;
@@ -314,6 +779,14 @@ struct syna_tcm {
 	unsigned int cdev_origin_max_wr_size;
 	unsigned int cdev_origin_max_rd_size;
 
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+	/* Touch report config of firmware and the one reduced from it */
+	struct tcm_buffer touch_config_default;
+	struct tcm_buffer touch_config_minimal;
+	/* Touch entities requested through the character device */
+	unsigned char cdev_touch_entities[TOUCH_ENTITY_MASK_SIZE];
+#endif
+
 	/* Abstraction helpers */
 	int (*dev_connect)(struct syna_tcm *tcm);
 	int (*dev_disconnect)(struct syna_tcm *tcm);
@@ -322,6 +795,42 @@ struct syna_tcm {
 	int (*dev_suspend)(struct device *dev);
 };
 
+/* Helper to switch the options of input reporting */
+int syna_dev_set_input_options(struct syna_tcm *tcm, unsigned int opts);
+
+#if defined(ENABLE_TOUCH_BOOST)
+/* Helper to change the thresholds of touch boost */
+void syna_dev_set_touch_boost(struct syna_tcm *tcm, unsigned int latency_us,
+	unsigned int idle_ms, unsigned int uclamp_min);
+#endif
+
+/* Helpers to change the scheduling of irq thread */
+int syna_dev_set_irq_thread_priority(struct syna_tcm *tcm, unsigned int prio);
+int syna_dev_set_irq_cpus(struct syna_tcm *tcm, const struct cpumask *cpus);
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+/* Helper to change the thresholds of hybrid mode */
+void syna_dev_set_hybrid_mode(struct syna_tcm *tcm, unsigned int enter_reports,
+	unsigned int exit_polls);
+#endif
+
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+/* Helper to change the vsync-aligned delivery */
+void syna_dev_set_vsync_delivery(struct syna_tcm *tcm, unsigned int mode,
+	unsigned int lead_us);
+#endif
+
+#if defined(ENABLE_CLOCK_SYNC)
+/* Helpers of the clock synchronization */
+ktime_t syna_dev_sync_scan_time(struct syna_tcm *tcm,
+	const unsigned char *report, unsigned int report_size, ktime_t attn_time);
+void syna_dev_reset_clock_sync(struct syna_tcm *tcm);
+#endif
+
+/* Helper to read the latest touch data published */
+unsigned int syna_dev_read_touch_data(struct syna_tcm *tcm,
+	struct tcm_touch_data_blob *touch_data);
+
 /* Helpers for the character device registration */
 int syna_cdev_create(struct syna_tcm *ptcm);
 void syna_cdev_remove(struct syna_tcm *ptcm);
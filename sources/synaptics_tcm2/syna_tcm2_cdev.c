@@ -35,6 +35,9 @@
  */
 
 #include <linux/string.h>
+#include <linux/mm.h>
+#include <linux/poll.h>
+#include <linux/vmalloc.h>
 
 #include "syna_tcm2.h"
 #include "syna_tcm2_cdev.h"
@@ -66,12 +69,24 @@ struct syna_tcm_ioctl_data_compat {
 
 /* Definitions of kernel fifo */
 #define FIFO_QUEUE_MAX_FRAMES		(1200)
+/* idle frames kept for reuse unless the depth of fifo is given */
+#define FIFO_POOL_IDLE_FRAMES		(16)
 
 #ifdef ENABLE_EXTERNAL_FRAME_PROCESS
-/* Structure for the kernel fifo */
+/* Structure for the kernel fifo
+ *
+ * The entry lives in the private area of the frame it queues, so nothing is
+ * allocated per frame.
+ */
 struct fifo_queue {
 	struct list_head next;
-	unsigned char *fifo_data;
+	/* frame held from the core library, the payload is not copied */
+	struct tcm_frame_buffer *frame;
+	unsigned char header[3];
+	unsigned char extra[TCM_MSG_CRC_LENGTH + TCM_EXTRA_RC_LENGTH];
+	unsigned int payload_length;
+	unsigned int extra_length;
+	/* total size of data returned to the userspace */
 	unsigned int data_length;
 #ifdef BUILD_64
 	struct timespec64 timestamp;
@@ -102,8 +117,7 @@ static void syna_cdev_clean_fifo(struct syna_tcm *tcm)
 	while (!list_empty(&tcm->frame_fifo_queue)) {
 		pfifo_data = list_first_entry(&tcm->frame_fifo_queue, struct fifo_queue, next);
 		list_del(&pfifo_data->next);
-		kfree(pfifo_data->fifo_data);
-		kfree(pfifo_data);
+		syna_tcm_release_frame(pfifo_data->frame);
 		if (tcm->fifo_remaining_frame != 0)
 			tcm->fifo_remaining_frame--;
 	}
@@ -112,23 +126,44 @@ static void syna_cdev_clean_fifo(struct syna_tcm *tcm)
 
 	syna_pal_mutex_unlock(&tcm->fifo_queue_mutex);
 }
+/*
+ *  Set the depth of the kernel fifo, and size the pool of frame buffers
+ *  accordingly.
+ *
+ *  The pool keeps as many idle frames as the fifo may hold, so the frames
+ *  popped in a burst are reused later rather than being freed. Each frame
+ *  also carries the entry of fifo queuing it.
+ *
+ * param
+ *    [ in] tcm:   pointer to the driver context
+ *    [ in] depth: depth of the fifo; or, 0 for the default
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_cdev_set_fifo_depth(struct syna_tcm *tcm, unsigned int depth)
+{
+	tcm->fifo_depth = depth;
+
+	return syna_tcm_set_frame_pool(tcm->tcm_dev,
+		(depth != 0) ? depth : FIFO_POOL_IDLE_FRAMES,
+		sizeof(struct fifo_queue));
+}
 /*
  *  Push one data packet to the kernel fifo.
  *
  * param
- *    [ in] tcm:      the driver handle
- *    [ in] buf_ptr:  points to a data going to push
- *    [ in] length:   data length
+ *    [ in] tcm:        the driver handle
+ *    [ in] pfifo_data: the packet going to push
+ *    [ in] timestamp:  time of the packet; or, zero if unknown
  *
  * return
  *    0 or positive value in case of success, a negative value otherwise.
  */
 static int syna_cdev_push_data_to_fifo(struct syna_tcm *tcm,
-	unsigned char *buf_ptr, unsigned int length)
+	struct fifo_queue *pfifo_data, ktime_t timestamp)
 {
-	int retval = 0;
 	struct tcm_hw_platform *hw = &tcm->hw_if->hw_platform;
-	struct fifo_queue *pfifo_data;
 	struct fifo_queue *pfifo_data_temp;
 	static int pre_remaining_frames = -1;
 
@@ -142,8 +177,7 @@ static int syna_cdev_push_data_to_fifo(struct syna_tcm *tcm,
 		pfifo_data_temp = list_first_entry(&tcm->frame_fifo_queue, struct fifo_queue, next);
 
 		list_del(&pfifo_data_temp->next);
-		kfree(pfifo_data_temp->fifo_data);
-		kfree(pfifo_data_temp);
+		syna_tcm_release_frame(pfifo_data_temp->frame);
 		pre_remaining_frames = tcm->fifo_remaining_frame;
 		tcm->fifo_remaining_frame--;
 	} else if (pre_remaining_frames >= FIFO_QUEUE_MAX_FRAMES) {
@@ -151,33 +185,23 @@ static int syna_cdev_push_data_to_fifo(struct syna_tcm *tcm,
 		pre_remaining_frames = tcm->fifo_remaining_frame;
 	}
 
-	pfifo_data = kmalloc(sizeof(*pfifo_data), GFP_KERNEL);
-	if (!(pfifo_data)) {
-		LOGE("Failed to allocate memory\n");
-		LOGE("Allocation size = %zu\n", (sizeof(*pfifo_data)));
-		retval = -ENOMEM;
-		goto exit;
-	}
-
-	pfifo_data->fifo_data = kmalloc(length, GFP_KERNEL);
-	if (!(pfifo_data->fifo_data)) {
-		LOGE("Failed to allocate memory, size = %d\n", length);
-		retval = -ENOMEM;
-		goto exit;
-	}
-
-	pfifo_data->data_length = length;
-
-	memcpy((void *)pfifo_data->fifo_data, (void *)buf_ptr, length);
+	/* prefer the time given, converted from the monotonic to real time */
+	if (ktime_to_ns(timestamp) != 0) {
 #ifdef BUILD_64
-	ktime_get_real_ts64(&(pfifo_data->timestamp));
+		pfifo_data->timestamp = ktime_to_timespec64(ktime_mono_to_real(timestamp));
 #else
-	ktime_get_real_ts(&(pfifo_data->timestamp));
+		pfifo_data->timestamp = ktime_to_timespec(ktime_mono_to_real(timestamp));
 #endif
+	} else {
+#ifdef BUILD_64
+		ktime_get_real_ts64(&(pfifo_data->timestamp));
+#else
+		ktime_get_real_ts(&(pfifo_data->timestamp));
+#endif
+	}
 	/* append the data to the tail for FIFO queueing */
 	list_add_tail(&pfifo_data->next, &tcm->frame_fifo_queue);
 	tcm->fifo_remaining_frame++;
-	retval = 0;
 
 	LOGD("Frames %d (size:%d) queued in FIFO\n", tcm->fifo_remaining_frame, pfifo_data->data_length);
 
@@ -189,10 +213,269 @@ static int syna_cdev_push_data_to_fifo(struct syna_tcm *tcm,
 		}
 	}
 
+	syna_pal_mutex_unlock(&tcm->fifo_queue_mutex);
+
+	return 0;
+}
+/*
+ *  Fill in the extra bytes appended to the data packet,
+ *  according to the request of the userspace.
+ *
+ * param
+ *    [ in] tcm:   the driver handle
+ *    [out] extra: buffer of TCM_MSG_CRC_LENGTH + TCM_EXTRA_RC_LENGTH bytes
+ *
+ * return
+ *    the number of extra bytes to append; the bytes beyond the buffer
+ *    given are zeros.
+ */
+static unsigned int syna_cdev_get_extra_bytes(struct syna_tcm *tcm,
+	unsigned char *extra)
+{
+	struct tcm_dev *tcm_dev = tcm->tcm_dev;
+	unsigned short val;
+
+	if (tcm->cdev_extra_bytes >= TCM_MSG_CRC_LENGTH) {
+		val = tcm_dev->msg_data.crc_bytes;
+		extra[0] = (unsigned char)val;
+		extra[1] = (unsigned char)(val >> 8);
+
+		val = tcm->cdev_extra_bytes - TCM_MSG_CRC_LENGTH;
+		if (val >= TCM_EXTRA_RC_LENGTH)
+			extra[TCM_MSG_CRC_LENGTH] = tcm_dev->msg_data.rc_byte;
+	}
+
+	return (tcm->cdev_extra_bytes > 0) ? tcm->cdev_extra_bytes : 0;
+}
+#if defined(ENABLE_FRAME_RING_MMAP)
+/*
+ *  Reset the indices and counters of the frame ring.
+ *  The caller should hold the fifo_queue_mutex.
+ *
+ * param
+ *    [ in] ring: the frame ring
+ *
+ * return
+ *    void.
+ */
+static void syna_cdev_reset_ring(struct syna_frame_ring *ring)
+{
+	struct syna_frame_ring_ctrl *ctrl = ring->ctrl;
+
+	if (!ring->buf)
+		return;
+
+	ring->head = 0;
+
+	ctrl->dropped = 0;
+	ctrl->oversized = 0;
+	ctrl->tail = 0;
+	smp_store_release(&ctrl->head, 0);
+}
+/*
+ *  Determine the size of a slot able to hold the largest frame, which is
+ *  an image of 16-bit pixels along with the profiles, or a full read.
+ *
+ * param
+ *    [ in] tcm: the driver handle
+ *
+ * return
+ *    the size of a slot, power of 2.
+ */
+static unsigned int syna_cdev_get_ring_slot_size(struct syna_tcm *tcm)
+{
+	struct tcm_dev *tcm_dev = tcm->tcm_dev;
+	unsigned int size;
+
+	size = (tcm_dev->rows * tcm_dev->cols + tcm_dev->rows + tcm_dev->cols) *
+		sizeof(short);
+	size = MAX(size, tcm_dev->max_rd_size);
+
+	size += sizeof(struct syna_frame_ring_slot) + 3 +
+		TCM_MSG_CRC_LENGTH + TCM_EXTRA_RC_LENGTH;
+
+	size = clamp_t(unsigned int, size, FRAME_RING_SLOT_SIZE_MIN,
+		FRAME_RING_SLOT_SIZE_MAX);
+
+	return roundup_pow_of_two(size);
+}
+/*
+ *  Allocate the frame ring shared with userspace, or re-allocate it if the
+ *  size of a slot is changed.
+ *  The caller should hold the fifo_queue_mutex, and the ring is not mapped.
+ *
+ * param
+ *    [ in] ring:      the frame ring
+ *    [ in] slot_size: size of a slot, power of 2
+ *
+ * return
+ *    0 in case of success, a negative value otherwise.
+ */
+static int syna_cdev_alloc_ring(struct syna_frame_ring *ring,
+	unsigned int slot_size)
+{
+	struct syna_frame_ring_ctrl *ctrl;
+	unsigned int size;
+
+	if (ring->buf && (ring->slot_size == slot_size))
+		return 0;
+
+	BUILD_BUG_ON(!is_power_of_2(FRAME_RING_SLOTS));
+	BUILD_BUG_ON(sizeof(struct syna_frame_ring_ctrl) > PAGE_SIZE);
+
+	/* the pages still mapped by a stale vma are released along with it */
+	if (ring->buf) {
+		vfree(ring->buf);
+		ring->buf = NULL;
+	}
+
+	size = PAGE_SIZE + PAGE_ALIGN(FRAME_RING_SLOTS * slot_size);
+
+	/* zeroed, and allowed to be mapped to the userspace */
+	ring->buf = vmalloc_user(size);
+	if (!ring->buf) {
+		LOGE("Fail to allocate the frame ring, size:%d\n", size);
+		return -ENOMEM;
+	}
+
+	ring->size = size;
+	ring->ctrl = (struct syna_frame_ring_ctrl *)ring->buf;
+	ring->data = (unsigned char *)ring->buf + PAGE_SIZE;
+	ring->slots = FRAME_RING_SLOTS;
+	ring->slot_size = slot_size;
+	ring->head = 0;
+
+	ctrl = ring->ctrl;
+	ctrl->version = FRAME_RING_VERSION;
+	ctrl->size = ring->size;
+	ctrl->data_offset = PAGE_SIZE;
+	ctrl->slots = ring->slots;
+	ctrl->slot_size = ring->slot_size;
+
+	LOGI("Frame ring allocated, %d slots of %d bytes\n", ring->slots, ring->slot_size);
+
+	return 0;
+}
+/*
+ *  Release the frame ring.
+ *
+ * param
+ *    [ in] ring: the frame ring
+ *
+ * return
+ *    void.
+ */
+static void syna_cdev_free_ring(struct syna_frame_ring *ring)
+{
+	WRITE_ONCE(ring->mapped, false);
+	ring->owner = NULL;
+
+	if (ring->buf)
+		vfree(ring->buf);
+
+	ring->buf = NULL;
+	ring->ctrl = NULL;
+	ring->data = NULL;
+	ring->size = 0;
+}
+/*
+ *  Write one data packet to the frame ring mapped by the userspace.
+ *  The layout of packet is the same as the data queued in the kernel fifo,
+ *  and it is written once, straightly from the frame buffer.
+ *
+ * param
+ *    [ in] tcm:         the driver handle
+ *    [ in] code:        report type
+ *    [ in] data_ptr:    points to a data going to push
+ *    [ in] data_length: data length
+ *    [ in] timestamp:   time of the packet; or, zero if unknown
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_cdev_push_data_to_ring(struct syna_tcm *tcm, unsigned char code,
+	const unsigned char *data_ptr, unsigned int data_length, ktime_t timestamp)
+{
+	int retval = 0;
+	struct syna_frame_ring *ring = &tcm->frame_ring;
+	struct syna_frame_ring_ctrl *ctrl;
+	struct syna_frame_ring_slot *slot;
+	unsigned char extra[TCM_MSG_CRC_LENGTH + TCM_EXTRA_RC_LENGTH] = {0};
+	unsigned char *ptr;
+	unsigned int extra_length;
+	unsigned int size;
+	unsigned int tail;
+	const int header_size = 3;
+
+	syna_pal_mutex_lock(&tcm->fifo_queue_mutex);
+
+	/* unmapped in the meantime, no one to consume the frame */
+	if (!ring->mapped || !ring->buf)
+		goto exit;
+
+	ctrl = ring->ctrl;
+
+	extra_length = syna_cdev_get_extra_bytes(tcm, extra);
+	size = header_size + data_length + extra_length;
+	if (size > ring->slot_size - sizeof(*slot)) {
+		LOGD("Frame larger than a slot, size:%d\n", size);
+		WRITE_ONCE(ctrl->oversized, ctrl->oversized + 1);
+		goto exit;
+	}
+
+	/* the tail is only used to check the room, even if it is corrupted */
+	tail = smp_load_acquire(&ctrl->tail);
+	if (ring->head - tail >= ring->slots) {
+		WRITE_ONCE(ctrl->dropped, ctrl->dropped + 1);
+		goto exit;
+	}
+
+	slot = (struct syna_frame_ring_slot *)(ring->data +
+		(ring->head & (ring->slots - 1)) * ring->slot_size);
+	ptr = (unsigned char *)(slot + 1);
+
+	ptr[0] = code;
+	ptr[1] = (unsigned char)data_length;
+	ptr[2] = (unsigned char)(data_length >> 8);
+	ptr += header_size;
+
+	if (data_length > 0) {
+		retval = syna_pal_mem_cpy(ptr, data_length, data_ptr, data_length,
+			data_length);
+		if (retval < 0) {
+			LOGE("Fail to copy data to the slot, size:%d\n", data_length);
+			goto exit;
+		}
+		ptr += data_length;
+	}
+
+	if (extra_length > 0) {
+		syna_pal_mem_set(ptr, 0x00, extra_length);
+		syna_pal_mem_cpy(ptr, extra_length, extra, sizeof(extra),
+			MIN(extra_length, (unsigned int)sizeof(extra)));
+	}
+
+	if (ktime_to_ns(timestamp) == 0)
+		timestamp = ktime_get();
+
+	slot->seq = ring->head;
+	slot->length = size;
+	slot->timestamp_ns = ktime_to_ns(ktime_mono_to_real(timestamp));
+
+	/* publish the slot once it is completely written */
+	ring->head++;
+	smp_store_release(&ctrl->head, ring->head);
+
+	LOGD("Frame %d (size:%d) written to ring\n", slot->seq, size);
+
+	retval = 0;
+
 exit:
 	syna_pal_mutex_unlock(&tcm->fifo_queue_mutex);
+
 	return retval;
 }
+#endif
 /*
  *  Queue the specified data packet to the kernel fifo.
  *  Below is the format of data to queue.
@@ -200,6 +483,11 @@ exit:
  *            [   0   ]  report code
  *            [ 1 - 2 ]  length of payload data
  *            [ 3 -N+3]  N bytes of payload data
+ *
+ *  Rather than copying, the payload is kept in the frame buffer held from
+ *  the core library until it is popped by the userspace. The entry of fifo
+ *  is placed in the private area of that frame.
+ *
  * param
  *    [ in] tcm:         the driver handle
  *    [ in] code:        report type
@@ -214,79 +502,69 @@ static int syna_cdev_update_fifo(struct syna_tcm *tcm, unsigned char code,
 {
 	int retval;
 	struct tcm_dev *tcm_dev = tcm->tcm_dev;
-	unsigned char *frame_buffer = NULL;
-	unsigned int size = 0;
-	unsigned short val;
-	unsigned char *extrabytes = NULL;
-	unsigned char *extraptr = NULL;
-	int offset;
+	struct tcm_frame_buffer *frame;
+	struct fifo_queue *pfifo_data;
 	const int header_size = 3;
+	ktime_t timestamp;
 
 	if (data_ptr == NULL) {
 		LOGE("Invalid event data pointer\n");
 		return -EINVAL;
 	}
 
-	size = data_length + header_size;
-	if (tcm->cdev_extra_bytes > 0)
-		size += tcm->cdev_extra_bytes;
-
-	frame_buffer = (unsigned char *)syna_pal_mem_alloc(size, sizeof(unsigned char));
-	if (!frame_buffer) {
-		LOGE("Fail to allocate buffer, size: %d, data_length: %d\n",
-			size, data_length);
-		return -ENOMEM;
-	}
+	/* the time of ATTN, or the time of scan estimated for touch reports */
+	timestamp = tcm->irq_timestamp;
+#if defined(ENABLE_CLOCK_SYNC)
+	if ((code == REPORT_TOUCH) && (data_length > 0))
+		timestamp = syna_dev_sync_scan_time(tcm, data_ptr, data_length, timestamp);
+#endif
 
-	if (tcm->cdev_extra_bytes > 0) {
-		extrabytes = (unsigned char *)syna_pal_mem_alloc(
-					tcm->cdev_extra_bytes, sizeof(unsigned char));
-		if (!extrabytes) {
-			syna_pal_mem_free((void *)frame_buffer);
+#if defined(ENABLE_FRAME_RING_MMAP)
+	/* write the frame to the ring straightly once mapped by the userspace */
+	if (READ_ONCE(tcm->frame_ring.mapped)) {
+		retval = syna_cdev_push_data_to_ring(tcm, code, data_ptr,
+			data_length, timestamp);
+		if (retval < 0)
+			LOGE("Fail to push data to ring\n");
+		else
+			wake_up_interruptible(&(tcm->wait_frame));
 
-			LOGE("Fail to allocate extra buffer, size: %d\n", tcm->cdev_extra_bytes);
-			return -ENOMEM;
-		}
+		return retval;
 	}
+#endif
 
-	frame_buffer[0] = code;
-	frame_buffer[1] = (unsigned char)data_length;
-	frame_buffer[2] = (unsigned char)(data_length >> 8);
+	frame = syna_tcm_hold_frame(tcm_dev);
+	if ((!frame) || (frame->priv_size < sizeof(*pfifo_data))) {
+		LOGE("Fail to hold the frame for fifo\n");
+		retval = -EINVAL;
+		goto exit;
+	}
 
-	if (data_length > 0) {
-		retval = syna_pal_mem_cpy(&frame_buffer[header_size],
-				(size - header_size),
-				data_ptr,
-				data_length,
-				data_length);
-		if (retval < 0) {
-			LOGE("Fail to copy data to buffer, size: %d\n", data_length);
-			goto exit;
-		}
+	if ((data_length > 0) &&
+		((data_ptr != &frame->buf[MESSAGE_HEADER_SIZE]) ||
+		(frame->buf_size < MESSAGE_HEADER_SIZE + data_length))) {
+		LOGE("Fail to hold the frame, data_length: %d\n", data_length);
+		retval = -EINVAL;
+		goto exit;
 	}
 
-	if (tcm->cdev_extra_bytes >= TCM_MSG_CRC_LENGTH) {
-		val = tcm_dev->msg_data.crc_bytes;
-		extrabytes[0] = (unsigned char)val;
-		extrabytes[1] = (unsigned char)(val >> 8);
+	pfifo_data = (struct fifo_queue *)frame->priv;
+	syna_pal_mem_set(pfifo_data, 0x00, sizeof(*pfifo_data));
 
-		val = tcm->cdev_extra_bytes - TCM_MSG_CRC_LENGTH;
-		if (val >= TCM_EXTRA_RC_LENGTH)
-			extrabytes[TCM_MSG_CRC_LENGTH] = tcm_dev->msg_data.rc_byte;
+	pfifo_data->frame = frame;
+	pfifo_data->header[0] = code;
+	pfifo_data->header[1] = (unsigned char)data_length;
+	pfifo_data->header[2] = (unsigned char)(data_length >> 8);
+	pfifo_data->payload_length = data_length;
 
-		offset = data_length + header_size;
-		extraptr = &frame_buffer[offset];
-		retval = syna_pal_mem_cpy(extraptr, (size - offset),
-				extrabytes, tcm->cdev_extra_bytes, tcm->cdev_extra_bytes);
-		if (retval < 0) {
-			LOGE("Fail to copy extra bytes to buffer\n");
-			goto exit;
-		}
-	}
+	pfifo_data->extra_length = syna_cdev_get_extra_bytes(tcm, pfifo_data->extra);
 
-	LOGD("Pushing data to queue (size:%d code:0x%02x data length:%d)\n", size, code, data_length);
+	pfifo_data->data_length = header_size + data_length + pfifo_data->extra_length;
 
-	retval = syna_cdev_push_data_to_fifo(tcm, frame_buffer, size);
+	LOGD("Pushing data to queue (size:%d code:0x%02x data length:%d)\n",
+		pfifo_data->data_length, code, data_length);
+
+	retval = syna_cdev_push_data_to_fifo(tcm, pfifo_data, timestamp);
 	if (retval < 0) {
 		LOGE("Fail to push data to fifo\n");
 		goto exit;
@@ -294,9 +572,56 @@ static int syna_cdev_update_fifo(struct syna_tcm *tcm, unsigned char code,
 
 	wake_up_interruptible(&(tcm->wait_frame));
 
+	return retval;
+
 exit:
-	syna_pal_mem_free((void *)extrabytes);
-	syna_pal_mem_free((void *)frame_buffer);
+	syna_tcm_release_frame(frame);
+
+	return retval;
+}
+/*
+ *  Copy one packet queued in the kernel fifo to the userspace.
+ *  The layout is the same as the data queued by syna_cdev_update_fifo().
+ *
+ * param
+ *    [out] ubuf_ptr:   buffer of memory space from userspace
+ *    [ in] pfifo_data: the packet to copy
+ *
+ * return
+ *    0 in case of success, otherwise, the number of bytes not copied.
+ */
+static unsigned long syna_cdev_copy_fifo_data_to_user(const unsigned char *ubuf_ptr,
+	struct fifo_queue *pfifo_data)
+{
+	unsigned char __user *ptr = (unsigned char __user *)ubuf_ptr;
+	unsigned int size;
+	unsigned long retval;
+
+	size = sizeof(pfifo_data->header);
+	retval = copy_to_user(ptr, pfifo_data->header, size);
+	if (retval)
+		return retval;
+	ptr += size;
+
+	size = pfifo_data->payload_length;
+	if (size > 0) {
+		retval = copy_to_user(ptr, &pfifo_data->frame->buf[MESSAGE_HEADER_SIZE], size);
+		if (retval)
+			return retval;
+		ptr += size;
+	}
+
+	size = MIN(pfifo_data->extra_length, (unsigned int)sizeof(pfifo_data->extra));
+	if (size > 0) {
+		retval = copy_to_user(ptr, pfifo_data->extra, size);
+		if (retval)
+			return retval;
+		ptr += size;
+	}
+
+	size = pfifo_data->extra_length - size;
+	if (size > 0)
+		retval = clear_user(ptr, size);
 
 	return retval;
 }
@@ -487,6 +812,69 @@ static int syna_cdev_ioctl_application_info(struct syna_tcm *tcm,
 exit:
 	return retval;
 }
+/*
+ *  Request the touch entities to be reported through IOCTL interface.
+ *
+ *  The given entities are kept in the touch report when the touch report
+ *  config is reduced to the entities in use. Give no entity to clear.
+ *
+ * param
+ *    [ in] tcm:       the driver handle
+ *    [ in] ubuf_ptr:  buffer of memory space from userspace;
+ *                     one byte for each code of touch entity
+ *    [ in] buf_size:  size of given buffer
+ *    [ in] data_size: size of actual data
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_cdev_ioctl_set_touch_entities(struct syna_tcm *tcm,
+	const unsigned char *ubuf_ptr, unsigned int buf_size,
+	unsigned int data_size)
+{
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+	int retval = 0;
+	unsigned char data[TOUCH_ENTITY_MASK_SIZE * 8] = { 0 };
+	unsigned int idx;
+
+	if (!tcm->is_connected) {
+		LOGE("Not connected\n");
+		return -ENXIO;
+	}
+
+	if ((buf_size < data_size) || (data_size > sizeof(data))) {
+		LOGE("Invalid input buffer size, buf_size:%u, data_size:%u\n",
+			buf_size, data_size);
+		return -EINVAL;
+	}
+
+	if (data_size > 0) {
+		retval = copy_from_user(data, ubuf_ptr, data_size);
+		if (retval) {
+			LOGE("Fail to copy data from user space, size:%d\n", retval);
+			return -EBADE;
+		}
+	}
+
+	syna_pal_mem_set(tcm->cdev_touch_entities, 0, sizeof(tcm->cdev_touch_entities));
+	for (idx = 0; idx < data_size; idx++)
+		syna_tcm_set_touch_entity(tcm->cdev_touch_entities, data[idx]);
+
+	/* apply to the touch report config */
+	if ((tcm->pwr_state == PWR_ON) && (tcm->dev_set_up_app_fw)) {
+		retval = tcm->dev_set_up_app_fw(tcm);
+		if (retval < 0) {
+			LOGE("Fail to update the touch report config\n");
+			return retval;
+		}
+	}
+
+	return 0;
+#else
+	LOGE("USE_MINIMAL_TOUCH_REPORT_CONFIG is not enabled\n");
+	return -EBADE;
+#endif
+}
 /*
  *  Check the queuing status of kernel fifo through IOCTL interface.
  *
@@ -671,7 +1059,7 @@ static int syna_cdev_ioctl_get_frame(struct syna_tcm *tcm,
 	LOGD("Popping data from the queue, data size:%d\n", pfifo_data->data_length);
 
 	if (buf_size >= pfifo_data->data_length) {
-		retval = copy_to_user((void *)ubuf_ptr, pfifo_data->fifo_data, pfifo_data->data_length);
+		retval = syna_cdev_copy_fifo_data_to_user(ubuf_ptr, pfifo_data);
 		if (retval) {
 			LOGE("Fail to copy data to user space, size:%d\n", retval);
 			retval = -EBADE;
@@ -688,15 +1076,14 @@ static int syna_cdev_ioctl_get_frame(struct syna_tcm *tcm,
 	}
 
 	LOGD("Data popped: 0x%02x, 0x%02x, 0x%02x ...\n",
-		pfifo_data->fifo_data[0], pfifo_data->fifo_data[1], pfifo_data->fifo_data[2]);
+		pfifo_data->header[0], pfifo_data->header[1], pfifo_data->header[2]);
 
 	list_del(&pfifo_data->next);
 
 	if (retval >= 0)
 		retval = pfifo_data->data_length;
 
-	kfree(pfifo_data->fifo_data);
-	kfree(pfifo_data);
+	syna_tcm_release_frame(pfifo_data->frame);
 	if (tcm->fifo_remaining_frame != 0)
 		tcm->fifo_remaining_frame--;
 
@@ -1308,6 +1695,7 @@ static int syna_cdev_ioctl_get_config_params(struct syna_tcm *tcm,
 		param->dut.touchcomm_version = (unsigned char)tcm_dev->id_info.version;
 
 	param->feature.predict_reads = (tcm_dev->msg_data.predict_reads & 0x01);
+	param->feature.interleave_reports = (tcm_dev->msg_data.interleave_reports & 0x01);
 	param->feature.extra_bytes_to_read = (unsigned char)tcm->cdev_extra_bytes;
 #ifdef ENABLE_EXTERNAL_FRAME_PROCESS
 	param->feature.depth_of_fifo = (tcm->fifo_depth >> 2);
@@ -1349,9 +1737,13 @@ static int syna_cdev_ioctl_set_config(struct syna_tcm *tcm,
 	struct tcm_dev *tcm_dev = tcm->tcm_dev;
 	struct drv_param *param;
 	bool predict_read = false;
+	bool interleave = false;
 	int extra_bytes = 0;
 	struct tcm_buffer *caller;
 	unsigned int max_wr, max_rd;
+#ifdef ENABLE_EXTERNAL_FRAME_PROCESS
+	unsigned int depth;
+#endif
 
 	if (buf_size < 0) {
 		LOGE("Invalid sync data size, out of range\n");
@@ -1402,6 +1794,12 @@ static int syna_cdev_ioctl_set_config(struct syna_tcm *tcm,
 			LOGI("request to %s predict reading\n", (predict_read) ? "enable":"disable");
 			syna_tcm_enable_predict_reading(tcm_dev, predict_read);
 		}
+		/* change the feature of report interleaving */
+		interleave = (param->feature.interleave_reports == 1);
+		if (tcm_dev->msg_data.interleave_reports != interleave) {
+			LOGI("request to %s report interleaving\n", (interleave) ? "enable":"disable");
+			syna_tcm_enable_report_interleaving(tcm_dev, interleave);
+		}
 		/* change the feature of extra bytes reading */
 		extra_bytes = param->feature.extra_bytes_to_read;
 		if (tcm->cdev_extra_bytes != extra_bytes) {
@@ -1410,9 +1808,11 @@ static int syna_cdev_ioctl_set_config(struct syna_tcm *tcm,
 		}
 #ifdef ENABLE_EXTERNAL_FRAME_PROCESS
 		/* change the depth of kernel fifo */
-		tcm->fifo_depth = param->feature.depth_of_fifo << 2;
-		if (tcm->fifo_depth > FIFO_QUEUE_MAX_FRAMES)
-			tcm->fifo_depth = 0;
+		depth = param->feature.depth_of_fifo << 2;
+		if (depth > FIFO_QUEUE_MAX_FRAMES)
+			depth = 0;
+		if ((depth != tcm->fifo_depth) && (syna_cdev_set_fifo_depth(tcm, depth) < 0))
+			LOGE("Fail to size the frame pool for fifo\n");
 		if (tcm->fifo_depth != 0)
 			LOGI("request to adjust kernel fifo size to %d\n", tcm->fifo_depth);
 #endif
@@ -1464,6 +1864,8 @@ static int syna_cdev_ioctl_dispatch(struct syna_tcm *tcm,
 		return syna_cdev_ioctl_application_info(tcm, ubuf_ptr, ubuf_size, *data_size);
 	case STD_DO_HW_RESET_ID:
 		return syna_cdev_ioctl_do_hw_reset(tcm, ubuf_ptr, ubuf_size, *data_size);
+	case STD_SET_TOUCH_ENTITIES_ID:
+		return syna_cdev_ioctl_set_touch_entities(tcm, ubuf_ptr, ubuf_size, *data_size);
 	case STD_DRIVER_CONFIG_ID:
 		return syna_cdev_ioctl_set_config(tcm, ubuf_ptr, ubuf_size, *data_size);
 	case STD_DRIVER_GET_CONFIG_ID:
@@ -1802,7 +2204,7 @@ static int syna_cdev_open(struct inode *inp, struct file *filp)
 
 	tcm->cdev_polling_interval = 0;
 #ifdef ENABLE_EXTERNAL_FRAME_PROCESS
-	tcm->fifo_depth = 0;
+	syna_cdev_set_fifo_depth(tcm, 0);
 #endif
 	tcm->cdev_extra_bytes = 0;
 
@@ -1855,6 +2257,16 @@ static int syna_cdev_release(struct inode *inp, struct file *filp)
 #ifdef ENABLE_EXTERNAL_FRAME_PROCESS
 	syna_cdev_clean_fifo(tcm);
 #endif
+#if defined(ENABLE_FRAME_RING_MMAP)
+	/* the ring is given up once the file mapping it is released */
+	syna_pal_mutex_lock(&tcm->fifo_queue_mutex);
+	if (tcm->frame_ring.owner == filp) {
+		WRITE_ONCE(tcm->frame_ring.mapped, false);
+		tcm->frame_ring.owner = NULL;
+		syna_cdev_reset_ring(&tcm->frame_ring);
+	}
+	syna_pal_mutex_unlock(&tcm->fifo_queue_mutex);
+#endif
 
 	syna_tcm_clear_data_duplicator(tcm->tcm_dev);
 
@@ -1862,9 +2274,13 @@ static int syna_cdev_release(struct inode *inp, struct file *filp)
 
 	tcm->cdev_polling_interval = 0;
 #ifdef ENABLE_EXTERNAL_FRAME_PROCESS
-	tcm->fifo_depth = 0;
+	syna_cdev_set_fifo_depth(tcm, 0);
 #endif
 	tcm->cdev_extra_bytes = 0;
+#if defined(USE_MINIMAL_TOUCH_REPORT_CONFIG)
+	/* the touch report config is reduced again at the next set up */
+	syna_pal_mem_set(tcm->cdev_touch_entities, 0, sizeof(tcm->cdev_touch_entities));
+#endif
 
 	LOGI("CDevice close\n");
 
@@ -1878,6 +2294,124 @@ static int syna_cdev_release(struct inode *inp, struct file *filp)
 }
 
 
+#if defined(ENABLE_FRAME_RING_MMAP)
+/*
+ *  Map the frame ring to the userspace.
+ *  Once mapped, the frames queued are written to the ring instead of
+ *  the kernel fifo, until the device file mapping it is released; the
+ *  other files are not allowed to map the ring in the meantime.
+ *
+ * param
+ *    [ in] filp: represents the file descriptor
+ *    [ in] vma:  the virtual memory area to map
+ *
+ * return
+ *    0 in case of success, a negative value otherwise.
+ */
+static int syna_cdev_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	int retval;
+	struct syna_tcm *tcm = (struct syna_tcm *)filp->private_data;
+	struct syna_frame_ring *ring;
+	unsigned long size = vma->vm_end - vma->vm_start;
+
+	if (!tcm) {
+		LOGE("Invalid tcm handle\n");
+		return -EINVAL;
+	}
+
+	ring = &tcm->frame_ring;
+
+	if (vma->vm_pgoff != 0) {
+		LOGE("Invalid offset of mapping, %lu\n", vma->vm_pgoff);
+		return -EINVAL;
+	}
+
+	/* the frames queued previously are not moved to the ring */
+	if (!READ_ONCE(ring->mapped))
+		syna_cdev_clean_fifo(tcm);
+
+	syna_pal_mutex_lock(&tcm->fifo_queue_mutex);
+
+	if (ring->mapped && (ring->owner != filp)) {
+		LOGE("Frame ring mapped by another file\n");
+		retval = -EBUSY;
+		goto exit;
+	}
+
+	if (!ring->mapped) {
+		retval = syna_cdev_alloc_ring(ring,
+			syna_cdev_get_ring_slot_size(tcm));
+		if (retval < 0)
+			goto exit;
+	}
+
+	if (size > ring->size) {
+		LOGE("Invalid size of mapping, %lu (ring:%d)\n", size, ring->size);
+		retval = -EINVAL;
+		goto exit;
+	}
+
+	retval = remap_vmalloc_range(vma, ring->buf, 0);
+	if (retval < 0) {
+		LOGE("Fail to map the frame ring\n");
+		goto exit;
+	}
+
+	if (!ring->mapped) {
+		syna_cdev_reset_ring(ring);
+		ring->owner = filp;
+		WRITE_ONCE(ring->mapped, true);
+	}
+
+	LOGI("Frame ring mapped, size:%lu\n", size);
+
+exit:
+	syna_pal_mutex_unlock(&tcm->fifo_queue_mutex);
+
+	return retval;
+}
+#endif
+#if defined(ENABLE_EXTERNAL_FRAME_PROCESS)
+/*
+ *  Check whether any frame is available, so the userspace is able to
+ *  wait for the frames without the ioctl being blocked.
+ *
+ * param
+ *    [ in] filp: represents the file descriptor
+ *    [ in] wait: the poll table
+ *
+ * return
+ *    the mask of events available.
+ */
+#if (KERNEL_VERSION(4, 16, 0) <= LINUX_VERSION_CODE)
+static __poll_t syna_cdev_poll(struct file *filp, poll_table *wait)
+#else
+static unsigned int syna_cdev_poll(struct file *filp, poll_table *wait)
+#endif
+{
+	struct syna_tcm *tcm = (struct syna_tcm *)filp->private_data;
+	bool available;
+#if defined(ENABLE_FRAME_RING_MMAP)
+	struct syna_frame_ring *ring;
+#endif
+
+	if (!tcm)
+		return POLLERR;
+
+	poll_wait(filp, &tcm->wait_frame, wait);
+
+	available = (tcm->fifo_remaining_frame > 0);
+#if defined(ENABLE_FRAME_RING_MMAP)
+	ring = &tcm->frame_ring;
+	if (READ_ONCE(ring->mapped))
+		available = (smp_load_acquire(&ring->ctrl->tail) != READ_ONCE(ring->head));
+#endif
+
+	return (available) ? (POLLIN | POLLRDNORM) : 0;
+}
+#endif
+
 /* Definitions of the device file representing for the Touchcomm device driver */
 static const struct file_operations device_fops = {
 	.owner = THIS_MODULE,
@@ -1894,6 +2428,12 @@ static const struct file_operations device_fops = {
 	.write = syna_cdev_write,
 	.open = syna_cdev_open,
 	.release = syna_cdev_release,
+#if defined(ENABLE_EXTERNAL_FRAME_PROCESS)
+	.poll = syna_cdev_poll,
+#endif
+#if defined(ENABLE_FRAME_RING_MMAP)
+	.mmap = syna_cdev_mmap,
+#endif
 };
 
 /*
@@ -1998,11 +2538,25 @@ int syna_cdev_create(struct syna_tcm *tcm)
 #ifdef ENABLE_EXTERNAL_FRAME_PROCESS
 	INIT_LIST_HEAD(&tcm->frame_fifo_queue);
 	init_waitqueue_head(&tcm->wait_frame);
+
+	/* frames come with the entry of fifo, see syna_cdev_update_fifo() */
+	retval = syna_cdev_set_fifo_depth(tcm, 0);
+	if (retval < 0) {
+		LOGE("Fail to set up the frame pool for fifo\n");
+		goto err_set_frame_pool;
+	}
+#endif
+#if defined(ENABLE_FRAME_RING_MMAP)
+	syna_pal_mem_set(&tcm->frame_ring, 0, sizeof(tcm->frame_ring));
 #endif
 
 	LOGD("cdev created\n");
 	return 0;
 
+#ifdef ENABLE_EXTERNAL_FRAME_PROCESS
+err_set_frame_pool:
+	device_destroy(tcm->device_class, tcm->char_dev_num);
+#endif
 err_create_device:
 	class_destroy(tcm->device_class);
 err_create_class:
@@ -2031,6 +2585,9 @@ void syna_cdev_remove(struct syna_tcm *tcm)
 
 #ifdef ENABLE_EXTERNAL_FRAME_PROCESS
 	syna_cdev_clean_fifo(tcm);
+#if defined(ENABLE_FRAME_RING_MMAP)
+	syna_cdev_free_ring(&tcm->frame_ring);
+#endif
 	syna_pal_mutex_free(&tcm->fifo_queue_mutex);
 #endif
 	tcm->char_dev_ref_count = 0;
@@ -65,6 +65,7 @@
 #define STD_CLEAN_OUT_FRAMES_ID     (0x19)
 #define STD_APPLICATION_INFO_ID     (0x1A)
 #define STD_DO_HW_RESET_ID          (0x1B)
+#define STD_SET_TOUCH_ENTITIES_ID   (0x1C)
 
 #define STD_DRIVER_CONFIG_ID        (0x21)
 #define STD_DRIVER_GET_CONFIG_ID    (0x22)
@@ -82,11 +83,64 @@
 #define IOCTL_STD_CLEAN_OUT_FRAMES  _IOWR(IOCTL_MAGIC, STD_CLEAN_OUT_FRAMES_ID, struct syna_ioctl_data *)
 #define IOCTL_STD_APPLICATION_INFO  _IOWR(IOCTL_MAGIC, STD_APPLICATION_INFO_ID, struct syna_ioctl_data *)
 #define IOCTL_STD_DO_HW_RESET       _IOWR(IOCTL_MAGIC, STD_DO_HW_RESET_ID, struct syna_ioctl_data *)
+#define IOCTL_STD_SET_TOUCH_ENTITIES _IOW(IOCTL_MAGIC, STD_SET_TOUCH_ENTITIES_ID, struct syna_ioctl_data *)
 
 #define IOCTL_DRIVER_CONFIG         _IOW(IOCTL_MAGIC, STD_DRIVER_CONFIG_ID, struct syna_ioctl_data *)
 #define IOCTL_DRIVER_GET_CONFIG     _IOR(IOCTL_MAGIC, STD_DRIVER_GET_CONFIG_ID, struct syna_ioctl_data *)
 
 
+/* Layout of the frame ring mapped by mmap()
+ *
+ *    offset 0            : struct syna_frame_ring_ctrl, one page
+ *    offset data_offset  : 'slots' slots of 'slot_size' bytes each
+ *
+ * 'slot_size' is a power of 2 decided by the image size of the device when
+ * the ring is mapped the first time, so the userspace may map the first page
+ * to read 'size', and then map the entire ring through the same file.
+ *
+ * Each slot starts with struct syna_frame_ring_slot, followed by the packet
+ * in the same format as IOCTL_STD_GET_FRAME returns:
+ *            [Bytes]     [ Description         ]
+ *            [   0   ]  report code
+ *            [ 1 - 2 ]  length of payload data
+ *            [ 3 -N+3]  N bytes of payload data
+ *            [ ...   ]  extra bytes, if requested
+ *
+ * 'head' and 'tail' are free-running counters; the slot is indexed by the
+ * counter & (slots - 1). The driver advances 'head' once the slot is
+ * written, and the userspace advances 'tail' once the slot is consumed.
+ * The frames arriving while the ring is full are dropped, and counted.
+ * poll() on the device file is readable while head != tail.
+ */
+#define FRAME_RING_VERSION (1)
+
+struct syna_frame_ring_ctrl {
+	/* geometry and counters, written by the driver */
+	unsigned int version;
+	unsigned int size;
+	unsigned int data_offset;
+	unsigned int slots;
+	unsigned int slot_size;
+	unsigned int dropped;
+	unsigned int oversized;
+	unsigned int reserved0[9];
+	/* producer index, written by the driver only */
+	unsigned int head;
+	unsigned int reserved1[15];
+	/* consumer index, written by the userspace only */
+	unsigned int tail;
+	unsigned int reserved2[15];
+};
+
+struct syna_frame_ring_slot {
+	unsigned int seq;
+	/* size of the packet following */
+	unsigned int length;
+	/* time of the frame in nanoseconds, CLOCK_REALTIME */
+	unsigned long long timestamp_ns;
+};
+
+
 /* Register-like format for the device information
  *
  *       Description       BYTE |    BIT 7    |    BIT 6    |    BIT 5    |    BIT 4    |    BIT 3    |    BIT 2    |    BIT 1    |    BIT 0    |
@@ -129,7 +183,7 @@ struct drv_param_dut {
  *
  *       Description       BYTE |    BIT 7    |    BIT 6    |    BIT 5    |    BIT 4    |    BIT 3    |    BIT 2    |    BIT 1    |    BIT 0    |
  * --------------------------------------------------------------------------------------------------------------------------------------------------
- *      Features           [ 0] |                   reserved                                                                      |Predict Read |
+ *      Features           [ 0] |                   reserved                                                        |Interleave   |Predict Read |
  *                              ---------------------------------------------------------------------------------------------------------------------
  *                         [ 1] |           Extra bytes to read                                                                                 |
  *                              ---------------------------------------------------------------------------------------------------------------------
@@ -159,7 +213,8 @@ struct drv_param_feature {
 		struct {
 			/* features : 12 bytes */
 			unsigned char predict_reads:1;
-			unsigned char reserve_b1__7:7;
+			unsigned char interleave_reports:1;
+			unsigned char reserve_b2__7:6;
 			unsigned char extra_bytes_to_read:8;
 			unsigned char depth_of_fifo:8;
 			unsigned char reserve_b24__31;
@@ -233,6 +288,8 @@ static inline char *syna_cdev_ioctl_get_name(unsigned int code)
 		return "IOCTL_STD_APPLICATION_INFO";
 	case STD_DO_HW_RESET_ID:
 		return "IOCTL_STD_DO_HW_RESET";
+	case STD_SET_TOUCH_ENTITIES_ID:
+		return "IOCTL_STD_SET_TOUCH_ENTITIES";
 	case STD_DRIVER_CONFIG_ID:
 		return "IOCTL_STD_DRIVER_CONFIG";
 	case STD_DRIVER_GET_CONFIG_ID:
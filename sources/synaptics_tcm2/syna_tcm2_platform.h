@@ -73,6 +73,7 @@ struct syna_hw_bus_data {
 	unsigned int spi_mode;
 	unsigned int spi_byte_delay_us;
 	unsigned int spi_block_delay_us;
+	bool spi_async_reads;
 	/* mutex to protect the i/o */
 	syna_pal_mutex_t io_mutex;
 	/* option for io switch */
@@ -88,6 +89,16 @@ struct syna_hw_attn_data {
 	unsigned long irq_flags;
 	int irq_id;
 	bool irq_enabled;
+	/* max. number of reports drained per interrupt, '0' to use default */
+	unsigned int irq_drain_budget;
+	/* rates of report polling if no ATTN is routed, '0' to use default */
+	unsigned int polling_report_hz;
+	unsigned int polling_idle_hz;
+	/* back-to-back reports to switch to polling, '0' to keep the interrupt */
+	unsigned int hybrid_enter_reports;
+	/* rt priority and cpus of the irq thread, '0' to keep the default */
+	unsigned int irq_thread_prio;
+	unsigned int irq_cpus;
 	/* mutex to protect the irq control */
 	syna_pal_mutex_t irq_en_mutex;
 };
@@ -128,8 +139,22 @@ struct syna_hw_pwr_data {
 };
 
 /* Product specific data */
+/* Options of input reporting */
+enum input_option {
+	INPUT_OPT_TYPE_B = 0,
+	INPUT_OPT_SWAP_XY,
+	INPUT_OPT_FLIP_X,
+	INPUT_OPT_FLIP_Y,
+	INPUT_OPT_TOUCH_WIDTH,
+	INPUT_OPT_WAKEUP_GESTURE,
+	INPUT_OPT_MAX,
+};
+
 struct product_specific {
 	struct tcm_timings timings;
+	/* options of input reporting given in dt, and the mask of them */
+	unsigned int input_opts;
+	unsigned int input_opts_mask;
 };
 
 /* Abstractions of hardware-specific interface */
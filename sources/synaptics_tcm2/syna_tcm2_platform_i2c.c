@@ -209,6 +209,50 @@ static struct regulator *syna_i2c_get_regulator(const char *name)
 
 	return reg_dev;
 }
+/*
+ * Parse the options of input reporting from the device tree source file.
+ * Each option is given as an u32 property, '0' to disable; the options not
+ * given keep the default defined in the driver.
+ *
+ * param
+ *    [ in] np:      device node
+ *    [out] product: product specific data to store the options
+ *
+ * return
+ *    void.
+ */
+#ifdef CONFIG_OF
+static void syna_i2c_parse_dt_input_options(struct device_node *np,
+	struct product_specific *product)
+{
+	static const struct {
+		enum input_option opt;
+		const char *name;
+	} props[] = {
+		{ INPUT_OPT_TYPE_B, "synaptics,type-b-protocol" },
+		{ INPUT_OPT_SWAP_XY, "synaptics,swap-xy" },
+		{ INPUT_OPT_FLIP_X, "synaptics,flip-x" },
+		{ INPUT_OPT_FLIP_Y, "synaptics,flip-y" },
+		{ INPUT_OPT_TOUCH_WIDTH, "synaptics,report-touch-width" },
+		{ INPUT_OPT_WAKEUP_GESTURE, "synaptics,wakeup-gesture" },
+	};
+	unsigned int value;
+	unsigned int idx;
+
+	product->input_opts = 0;
+	product->input_opts_mask = 0;
+
+	for (idx = 0; idx < ARRAY_SIZE(props); idx++) {
+		if (of_property_read_u32(np, props[idx].name, &value) < 0)
+			continue;
+
+		product->input_opts_mask |= BIT(props[idx].opt);
+		if (value)
+			product->input_opts |= BIT(props[idx].opt);
+	}
+}
+#endif
+
 /*
  * Parse and obtain board specific data from the device tree source file.
  *
@@ -262,6 +306,37 @@ static int syna_i2c_parse_dt(void)
 		prop = of_find_property(np, "synaptics,irq-on-state", NULL);
 		if (prop && prop->length)
 			of_property_read_u32(np, "synaptics,irq-on-state", &attn->irq_on_state);
+
+		attn->irq_drain_budget = 0;
+		prop = of_find_property(np, "synaptics,irq-drain-budget", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,irq-drain-budget", &attn->irq_drain_budget);
+
+		attn->polling_report_hz = 0;
+		prop = of_find_property(np, "synaptics,polling-report-hz", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,polling-report-hz", &attn->polling_report_hz);
+
+		attn->polling_idle_hz = 0;
+		prop = of_find_property(np, "synaptics,polling-idle-hz", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,polling-idle-hz", &attn->polling_idle_hz);
+
+		attn->hybrid_enter_reports = 0;
+		prop = of_find_property(np, "synaptics,hybrid-enter-reports", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,hybrid-enter-reports",
+				&attn->hybrid_enter_reports);
+
+		attn->irq_thread_prio = 0;
+		prop = of_find_property(np, "synaptics,irq-thread-priority", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,irq-thread-priority", &attn->irq_thread_prio);
+
+		attn->irq_cpus = 0;
+		prop = of_find_property(np, "synaptics,irq-cpus", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,irq-cpus", &attn->irq_cpus);
 	}
 
 	pwr = &p_hw_i2c_if->bdata_pwr;
@@ -419,6 +494,10 @@ static int syna_i2c_parse_dt(void)
 		LOGI("Load from dt: fw switch(%d) flash erase(%d) flash write(%d) flash read(%d)\n",
 			product->timings.fw_switch_delay_ms, product->timings.flash_ops_delay_us[0],
 			product->timings.flash_ops_delay_us[1], product->timings.flash_ops_delay_us[2]);
+
+		syna_i2c_parse_dt_input_options(np, product);
+		LOGI("Load from dt: input options(0x%02x) mask(0x%02x)\n",
+			product->input_opts, product->input_opts_mask);
 	}
 
 	return 0;
@@ -778,6 +857,24 @@ exit:
 
 	return retval;
 }
+/*
+ * Return the current level of ATTN signal.
+ *
+ * param
+ *    [ in] hw:    pointer to the hardware platform
+ *
+ * return
+ *    0 in case of the low level of ATTN pin, 1 otherwise.
+ */
+static unsigned int syna_i2c_get_attn_level(struct tcm_hw_platform *hw)
+{
+	struct syna_hw_interface *hw_if = (struct syna_hw_interface *)hw->device;
+
+	if (!hw_if || (hw_if->bdata_attn.irq_gpio < 0))
+		return !hw->attn_active_level;
+
+	return (gpio_get_value(hw_if->bdata_attn.irq_gpio) == 0) ? 0 : 1;
+}
 /*
  * Toggle the hardware gpio pin to perform the chip reset.
  *
@@ -1145,6 +1242,7 @@ static int syna_i2c_probe(struct i2c_client *i2c,
 	p_hw_i2c_if->hw_platform.ops_read_data = syna_i2c_read;
 	p_hw_i2c_if->hw_platform.ops_write_data = syna_i2c_write;
 	p_hw_i2c_if->hw_platform.ops_enable_attn = syna_i2c_enable_irq;
+	p_hw_i2c_if->hw_platform.ops_get_attn_level = syna_i2c_get_attn_level;
 	p_hw_i2c_if->hw_platform.support_attn = true;
 #ifdef DATA_ALIGNMENT
 	p_hw_i2c_if->hw_platform.alignment_base = ALIGNMENT_BASE;
@@ -1160,7 +1258,12 @@ static int syna_i2c_probe(struct i2c_client *i2c,
 
 #ifdef CONFIG_OF
 	syna_i2c_parse_dt();
+
+	/* no ATTN routed, the reports have to be requested actively */
+	if (p_hw_i2c_if->bdata_attn.irq_gpio < 0)
+		p_hw_i2c_if->hw_platform.support_attn = false;
 #endif
+	p_hw_i2c_if->hw_platform.attn_active_level = (p_hw_i2c_if->bdata_attn.irq_on_state) ? 1 : 0;
 
 	/* initialize resources for the use of power */
 	retval = syna_i2c_request_power_resources();
@@ -54,6 +54,30 @@ static unsigned char *tx_buf;
 static unsigned int buf_size;
 static struct spi_transfer *xfer;
 
+#ifdef TOUCHCOMM_VERSION_2
+/* context of the asynchronous write-then-read transaction */
+struct syna_spi_async_xfer {
+	struct spi_message msg;
+	struct spi_transfer xfer;
+	unsigned char *tx_buf;
+	unsigned char *rx_buf;
+	unsigned int buf_size;
+	unsigned char *rd_data;
+	unsigned int rd_len;
+	unsigned int rd_offset;
+	void (*complete)(void *context, int status);
+	void *context;
+	/* set until the completion callback returns */
+	syna_pal_atomic_t busy;
+	wait_queue_head_t idle;
+};
+
+/* max. time for the callback of previous transaction to return */
+#define ASYNC_XFER_IDLE_WAIT_MS (10)
+
+static struct syna_spi_async_xfer async_xfer;
+#endif
+
 
 /*
  * Request and return the device pointer for managed resources
@@ -217,6 +241,50 @@ static struct regulator *syna_spi_get_regulator(const char *name)
 
 	return reg_dev;
 }
+/*
+ * Parse the options of input reporting from the device tree source file.
+ * Each option is given as an u32 property, '0' to disable; the options not
+ * given keep the default defined in the driver.
+ *
+ * param
+ *    [ in] np:      device node
+ *    [out] product: product specific data to store the options
+ *
+ * return
+ *    void.
+ */
+#ifdef CONFIG_OF
+static void syna_spi_parse_dt_input_options(struct device_node *np,
+	struct product_specific *product)
+{
+	static const struct {
+		enum input_option opt;
+		const char *name;
+	} props[] = {
+		{ INPUT_OPT_TYPE_B, "synaptics,type-b-protocol" },
+		{ INPUT_OPT_SWAP_XY, "synaptics,swap-xy" },
+		{ INPUT_OPT_FLIP_X, "synaptics,flip-x" },
+		{ INPUT_OPT_FLIP_Y, "synaptics,flip-y" },
+		{ INPUT_OPT_TOUCH_WIDTH, "synaptics,report-touch-width" },
+		{ INPUT_OPT_WAKEUP_GESTURE, "synaptics,wakeup-gesture" },
+	};
+	unsigned int value;
+	unsigned int idx;
+
+	product->input_opts = 0;
+	product->input_opts_mask = 0;
+
+	for (idx = 0; idx < ARRAY_SIZE(props); idx++) {
+		if (of_property_read_u32(np, props[idx].name, &value) < 0)
+			continue;
+
+		product->input_opts_mask |= BIT(props[idx].opt);
+		if (value)
+			product->input_opts |= BIT(props[idx].opt);
+	}
+}
+#endif
+
 /*
  * Parse and obtain board specific data from the device tree source file.
  *
@@ -270,6 +338,37 @@ static int syna_spi_parse_dt(void)
 		prop = of_find_property(np, "synaptics,irq-on-state", NULL);
 		if (prop && prop->length)
 			of_property_read_u32(np, "synaptics,irq-on-state", &attn->irq_on_state);
+
+		attn->irq_drain_budget = 0;
+		prop = of_find_property(np, "synaptics,irq-drain-budget", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,irq-drain-budget", &attn->irq_drain_budget);
+
+		attn->polling_report_hz = 0;
+		prop = of_find_property(np, "synaptics,polling-report-hz", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,polling-report-hz", &attn->polling_report_hz);
+
+		attn->polling_idle_hz = 0;
+		prop = of_find_property(np, "synaptics,polling-idle-hz", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,polling-idle-hz", &attn->polling_idle_hz);
+
+		attn->hybrid_enter_reports = 0;
+		prop = of_find_property(np, "synaptics,hybrid-enter-reports", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,hybrid-enter-reports",
+				&attn->hybrid_enter_reports);
+
+		attn->irq_thread_prio = 0;
+		prop = of_find_property(np, "synaptics,irq-thread-priority", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,irq-thread-priority", &attn->irq_thread_prio);
+
+		attn->irq_cpus = 0;
+		prop = of_find_property(np, "synaptics,irq-cpus", NULL);
+		if (prop && prop->length)
+			of_property_read_u32(np, "synaptics,irq-cpus", &attn->irq_cpus);
 	}
 
 	pwr = &p_hw_spi_if->bdata_pwr;
@@ -381,6 +480,8 @@ static int syna_spi_parse_dt(void)
 		prop = of_find_property(np, "synaptics,spi-mode", NULL);
 		if (prop && prop->length)
 			of_property_read_u32(np, "synaptics,spi-mode", &bus->spi_mode);
+
+		bus->spi_async_reads = of_property_read_bool(np, "synaptics,spi-async-reads");
 	}
 
 	prop = of_find_property(np, "synaptics,chunks", NULL);
@@ -442,6 +543,10 @@ static int syna_spi_parse_dt(void)
 		LOGI("Load from dt: fw switch(%d) flash erase(%d) flash write(%d) flash read(%d)\n",
 			product->timings.fw_switch_delay_ms, product->timings.flash_ops_delay_us[0],
 			product->timings.flash_ops_delay_us[1], product->timings.flash_ops_delay_us[2]);
+
+		syna_spi_parse_dt_input_options(np, product);
+		LOGI("Load from dt: input options(0x%02x) mask(0x%02x)\n",
+			product->input_opts, product->input_opts_mask);
 	}
 
 	return 0;
@@ -607,6 +712,19 @@ static int syna_spi_release_bus_resources(void)
 		xfer = NULL;
 	}
 
+#ifdef TOUCHCOMM_VERSION_2
+	if (async_xfer.rx_buf) {
+		syna_pal_mem_free((void *)async_xfer.rx_buf);
+		async_xfer.rx_buf = NULL;
+	}
+
+	if (async_xfer.tx_buf) {
+		syna_pal_mem_free((void *)async_xfer.tx_buf);
+		async_xfer.tx_buf = NULL;
+	}
+	async_xfer.buf_size = 0;
+#endif
+
 	return 0;
 }
 /*
@@ -842,6 +960,24 @@ exit:
 
 	return retval;
 }
+/*
+ * Return the current level of ATTN signal.
+ *
+ * param
+ *    [ in] hw:    pointer to the hardware platform
+ *
+ * return
+ *    0 in case of the low level of ATTN pin, 1 otherwise.
+ */
+static unsigned int syna_spi_get_attn_level(struct tcm_hw_platform *hw)
+{
+	struct syna_hw_interface *hw_if = (struct syna_hw_interface *)hw->device;
+
+	if (!hw_if || (hw_if->bdata_attn.irq_gpio < 0))
+		return !hw->attn_active_level;
+
+	return (gpio_get_value(hw_if->bdata_attn.irq_gpio) == 0) ? 0 : 1;
+}
 /*
  * Toggle the hardware gpio pin to perform the chip reset.
  *
@@ -1188,6 +1324,136 @@ exit:
 
 	return retval;
 }
+/*
+ * Completion callback of the asynchronous SPI transaction.
+ * Copy the data retrieved and notify the caller.
+ *
+ * param
+ *    [ in] arg: pointer to the context of asynchronous transaction
+ *
+ * return
+ *    void.
+ */
+static void syna_spi_async_complete(void *arg)
+{
+	struct syna_spi_async_xfer *async = (struct syna_spi_async_xfer *)arg;
+	void (*complete)(void *context, int status) = async->complete;
+	void *context = async->context;
+	int status = async->msg.status;
+
+	if (status == 0) {
+		memcpy(async->rd_data, &async->rx_buf[async->rd_offset], async->rd_len);
+		status = async->rd_len;
+	}
+
+	if (complete)
+		complete(context, status);
+
+	/* the buffers are no longer touched, allow the next submission */
+	ATOMIC_SET(async->busy, 0);
+	wake_up(&async->idle);
+}
+/*
+ * Implement the SPI write-then-read transaction asynchronously.
+ * Only a single transaction can be in flight at a time.
+ *
+ * param
+ *    [ in] hw:       pointer to the hardware platform
+ *    [ in] wr_data:  written data, consumed before return
+ *    [ in] wr_len:   length of written data in bytes
+ *    [out] rd_data:  buffer for storing data retrieved from device
+ *    [ in] rd_len:   number of bytes retrieved from device
+ *    [ in] turnaround_bytes:  number of bytes for the bus turnaround
+ *    [ in] complete: callback invoked once the transaction is done
+ *    [ in] context:  context passed to the callback
+ *
+ * return
+ *    0 if the transaction is submitted, a negative value otherwise.
+ */
+static int syna_spi_write_then_read_async(struct tcm_hw_platform *hw, unsigned char *wr_data,
+	unsigned int wr_len, unsigned char *rd_data, unsigned int rd_len, unsigned int turnaround_bytes,
+	void (*complete)(void *context, int status), void *context)
+{
+	int retval;
+	struct spi_device *spi;
+	struct syna_hw_bus_data *bus;
+	unsigned int total_length;
+
+	if (!p_hw_spi_if)
+		return -EINVAL;
+
+	spi = p_hw_spi_if->pdev;
+	bus = &p_hw_spi_if->bdata_io;
+	if (!spi || !bus) {
+		LOGE("Invalid bus io device\n");
+		return -ENXIO;
+	}
+
+	/* the caller may be notified before the previous callback returns */
+	wait_event_timeout(async_xfer.idle, (ATOMIC_GET(async_xfer.busy) == 0),
+		msecs_to_jiffies(ASYNC_XFER_IDLE_WAIT_MS));
+
+	if (atomic_cmpxchg(&async_xfer.busy, 0, 1) != 0)
+		return -EBUSY;
+
+	syna_pal_mutex_lock(&bus->io_mutex);
+
+	total_length = wr_len + turnaround_bytes + rd_len;
+
+	if (total_length > async_xfer.buf_size) {
+		syna_pal_mem_free((void *)async_xfer.rx_buf);
+		syna_pal_mem_free((void *)async_xfer.tx_buf);
+		async_xfer.buf_size = 0;
+
+		async_xfer.rx_buf = syna_pal_mem_alloc(total_length, sizeof(unsigned char));
+		async_xfer.tx_buf = syna_pal_mem_alloc(total_length, sizeof(unsigned char));
+		if (!async_xfer.rx_buf || !async_xfer.tx_buf) {
+			LOGE("Fail to allocate memory for async xfer\n");
+			retval = -ENOMEM;
+			goto exit;
+		}
+		async_xfer.buf_size = total_length;
+	}
+
+	syna_pal_mem_set(async_xfer.tx_buf, 0, total_length);
+	retval = syna_pal_mem_cpy(async_xfer.tx_buf, async_xfer.buf_size, wr_data, wr_len, wr_len);
+	if (retval < 0) {
+		LOGE("Fail to copy wr_data to tx_buf\n");
+		goto exit;
+	}
+
+	async_xfer.rd_data = rd_data;
+	async_xfer.rd_len = rd_len;
+	async_xfer.rd_offset = wr_len + turnaround_bytes;
+	async_xfer.complete = complete;
+	async_xfer.context = context;
+
+	syna_pal_mem_set(&async_xfer.xfer, 0, sizeof(async_xfer.xfer));
+	async_xfer.xfer.len = total_length;
+	async_xfer.xfer.tx_buf = async_xfer.tx_buf;
+	async_xfer.xfer.rx_buf = async_xfer.rx_buf;
+#ifdef SPI_HAS_DELAY_USEC
+	if (bus->spi_block_delay_us)
+		async_xfer.xfer.delay_usecs = bus->spi_block_delay_us;
+#endif
+
+	spi_message_init(&async_xfer.msg);
+	spi_message_add_tail(&async_xfer.xfer, &async_xfer.msg);
+	async_xfer.msg.complete = syna_spi_async_complete;
+	async_xfer.msg.context = &async_xfer;
+
+	retval = spi_async(spi, &async_xfer.msg);
+	if (retval != 0)
+		LOGE("Fail to submit SPI transfer, error = %d\n", retval);
+
+exit:
+	if (retval < 0)
+		ATOMIC_SET(async_xfer.busy, 0);
+
+	syna_pal_mutex_unlock(&bus->io_mutex);
+
+	return retval;
+}
 #endif
 
 /*
@@ -1461,6 +1727,7 @@ static int syna_spi_probe(struct spi_device *spi)
 	p_hw_spi_if->hw_platform.ops_write_then_read_data = syna_spi_write_then_read;
 #endif
 	p_hw_spi_if->hw_platform.ops_enable_attn = syna_spi_enable_irq;
+	p_hw_spi_if->hw_platform.ops_get_attn_level = syna_spi_get_attn_level;
 	p_hw_spi_if->hw_platform.support_attn = true;
 #ifdef DATA_ALIGNMENT
 	p_hw_spi_if->hw_platform.alignment_base = ALIGNMENT_BASE;
@@ -1476,6 +1743,19 @@ static int syna_spi_probe(struct spi_device *spi)
 
 #ifdef CONFIG_OF
 	syna_spi_parse_dt();
+
+	/* no ATTN routed, the reports have to be requested actively */
+	if (p_hw_spi_if->bdata_attn.irq_gpio < 0)
+		p_hw_spi_if->hw_platform.support_attn = false;
+#endif
+	p_hw_spi_if->hw_platform.attn_active_level = (p_hw_spi_if->bdata_attn.irq_on_state) ? 1 : 0;
+#ifdef TOUCHCOMM_VERSION_2
+	/* transfers split into bytes are not supported asynchronously */
+	if (p_hw_spi_if->bdata_io.spi_async_reads && (p_hw_spi_if->bdata_io.spi_byte_delay_us == 0)) {
+		ATOMIC_SET(async_xfer.busy, 0);
+		init_waitqueue_head(&async_xfer.idle);
+		p_hw_spi_if->hw_platform.ops_write_then_read_data_async = syna_spi_write_then_read_async;
+	}
 #endif
 
 	/* initialize resources for the use of power */
@@ -41,6 +41,7 @@
 #include <linux/module.h>
 #include <linux/input.h>
 #include <linux/delay.h>
+#include <linux/hrtimer.h>
 #include <linux/gpio.h>
 #include <linux/of_gpio.h>
 #include <linux/interrupt.h>
@@ -59,6 +60,11 @@
 #if defined(CONFIG_DRM_BRIDGE)
 #include <drm/drm_bridge.h>
 #include <drm/drm_bridge_connector.h>
+#include <drm/drm_crtc.h>
+#include <drm/drm_vblank.h>
+#if (KERNEL_VERSION(5, 11, 0) <= LINUX_VERSION_CODE)
+#include <drm/drm_vblank_work.h>
+#endif
 #elif defined(CONFIG_FB)
 #include <linux/fb.h>
 #include <linux/notifier.h>
@@ -66,6 +72,15 @@
 #include <linux/fs.h>
 #include <linux/moduleparam.h>
 #include <linux/kfifo.h>
+#include <linux/jump_label.h>
+#include <linux/seqlock.h>
+#include <linux/pm_qos.h>
+#include <uapi/linux/sched/types.h>
+#if (KERNEL_VERSION(6, 12, 0) <= LINUX_VERSION_CODE)
+#include <linux/unaligned.h>
+#else
+#include <asm/unaligned.h>
+#endif
 
 #if defined(__LP64__) || defined(_LP64)
 #define BUILD_64
@@ -171,6 +186,12 @@ typedef atomic_t syna_pal_atomic_t;
 #define ATOMIC_GET(atomic) \
 	atomic_read(&atomic)
 
+#define ATOMIC_INC(atomic) \
+	atomic_inc_return(&atomic)
+
+#define ATOMIC_DEC(atomic) \
+	atomic_dec_return(&atomic)
+
 
 /*
  * Abstractions of integer calculation
@@ -205,6 +226,20 @@ static inline unsigned int syna_pal_le4_to_uint(const unsigned char *src)
 		(unsigned int)src[2] * 0x10000 +
 		(unsigned int)src[3] * 0x1000000;
 }
+/*
+ * Convert 8-byte data in little-endianness to an unsigned 64-bit integer,
+ * the data is not required to be aligned
+ *
+ * param
+ *    [ in] src: 8-byte data in little-endianness
+ *
+ * return
+ *    an unsigned 64-bit integer being converted
+ */
+static inline unsigned long long syna_pal_le8_to_u64(const unsigned char *src)
+{
+	return (unsigned long long)get_unaligned_le64(src);
+}
 /*
  * Perform the integer division
  *
@@ -413,6 +448,19 @@ static inline void syna_pal_mutex_unlock(syna_pal_mutex_t *ptr)
 {
 	mutex_unlock((struct mutex *)ptr);
 }
+/*
+ * Attempt to lock the mutex without waiting.
+ *
+ * param
+ *    [ in] ptr: a mutex handle
+ *
+ * return
+ *    true if the mutex is acquired, false if it is held by others.
+ */
+static inline bool syna_pal_mutex_trylock(syna_pal_mutex_t *ptr)
+{
+	return (mutex_trylock((struct mutex *)ptr) == 1);
+}
 
 
 /*
@@ -538,6 +586,22 @@ static inline void syna_pal_sleep_us(int time_us)
 {
 	usleep_range(time_us, time_us << 1);
 }
+/*
+ * Busy wait for a fixed amount of time in microseconds
+ *
+ * param
+ *    [ in] time_us: time frame in microseconds
+ *
+ * return
+ *    void.
+ */
+static inline void syna_pal_busy_delay_us(int time_us)
+{
+	if (time_us <= 0)
+		return;
+
+	udelay(time_us);
+}
 /*
  * Busy wait for a fixed amount of time in milliseconds
  *
@@ -556,6 +620,73 @@ static inline void syna_pal_busy_delay_ms(int time_ms)
 }
 
 
+/*
+ * Abstractions of time measurement
+ */
+typedef ktime_t syna_pal_time_t;
+
+/*
+ * Get the current time of a monotonic clock
+ *
+ * param
+ *    void
+ *
+ * return
+ *    the current time.
+ */
+static inline syna_pal_time_t syna_pal_get_time(void)
+{
+	return ktime_get();
+}
+/*
+ * Return the time elapsed since the given time in microseconds
+ *
+ * param
+ *    [ in] since: the time recorded previously
+ *
+ * return
+ *    elapsed time in microseconds.
+ */
+static inline long long syna_pal_time_elapsed_us(syna_pal_time_t since)
+{
+	return (long long)ktime_us_delta(ktime_get(), since);
+}
+/*
+ * Return the time advanced by the given microseconds
+ *
+ * param
+ *    [ in] time:    the base time
+ *    [ in] time_us: time frame in microseconds
+ *
+ * return
+ *    the time advanced.
+ */
+static inline syna_pal_time_t syna_pal_time_add_us(syna_pal_time_t time,
+	unsigned int time_us)
+{
+	return ktime_add_us(time, time_us);
+}
+/*
+ * Sleep until the given absolute time, the wakeup is driven by hrtimer
+ *
+ * param
+ *    [ in] deadline: the absolute time to wake up
+ *    [ in] slack_us: allowed slack of the wakeup in microseconds
+ *
+ * return
+ *    void.
+ */
+static inline void syna_pal_sleep_until(syna_pal_time_t deadline,
+	unsigned int slack_us)
+{
+	ktime_t expires = deadline;
+
+	set_current_state(TASK_UNINTERRUPTIBLE);
+	schedule_hrtimeout_range(&expires, (u64)slack_us * NSEC_PER_USEC,
+		HRTIMER_MODE_ABS);
+}
+
+
 /*
  * Abstractions of string operations
  */
@@ -297,78 +297,143 @@ exit:
 static struct kobj_attribute kobj_attr_pwr =
 	__ATTR(power_state, 0220, NULL, syna_sysfs_pwr_store);
 
-#if defined(HAS_REFLASH_FEATURE)
 /*
- * Debugging attribute to manually do firmware update.
+ * Helper to parse the request to clear the statistics of a *_stats
+ * attribute; only '0' is accepted.
  *
  * param
  *    [ in] kobj:  pointer to kernel object
- *    [ in] attr:  pointer to kernel attribute
  *    [ in] buf:   string buffer input
- *    [ in] count: size of buffer input
  *
  * return
- *    0 or positive value in case of success, a negative value otherwise.
+ *    the driver context whose statistics to clear, or NULL if the input is invalid.
  */
-static ssize_t syna_sysfs_fw_update_store(struct kobject *kobj,
-	struct kobj_attribute *attr, const char *buf, size_t count)
+static struct syna_tcm *syna_sysfs_stats_to_clear(struct kobject *kobj,
+	const char *buf)
+{
+	unsigned int input;
+	struct device *p_dev;
+
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
+
+	if (kstrtouint(buf, 10, &input))
+		return NULL;
+
+	if (input != 0) {
+		LOGW("Unknown option %d (0:clear)\n", input);
+		return NULL;
+	}
+
+	return dev_get_drvdata(p_dev);
+}
+
+/*
+ * Debugging attribute to show the statistics of predict reading.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_predict_stats_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
 {
-	int retval = 0;
 	struct device *p_dev;
 	struct syna_tcm *tcm;
-	unsigned int input;
+	unsigned int hits = 0;
+	unsigned int misses = 0;
 
 	p_dev = container_of(kobj->parent->parent, struct device, kobj);
 	tcm = dev_get_drvdata(p_dev);
 
-	if (!tcm->is_connected) {
-		LOGW("Device is NOT connected\n");
-		return count;
-	}
+	syna_tcm_get_predict_stats(tcm->tcm_dev, &hits, &misses, false);
 
-	if (kstrtouint(buf, 10, &input))
-		return -EINVAL;
+	return scnprintf(buf, PAGE_SIZE,
+			"predict reads: %s\nhits: %u\nmisses: %u\n",
+			(tcm->tcm_dev->msg_data.predict_reads) ? "enabled" : "disabled",
+			hits, misses);
+}
 
-	retval = syna_dev_do_reflash(tcm, true);
-	if (retval < 0) {
-		LOGE("Fail to do reflash\n");
-		goto exit;
-	}
+/*
+ * Debugging attribute to clear the statistics of predict reading,
+ * only '0' is accepted.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_predict_stats_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	struct syna_tcm *tcm;
 
-	/* check the fw setup in case the settings is changed */
-	if (IS_APP_FW_MODE(tcm->tcm_dev->dev_mode))
-		tcm->dev_set_up_app_fw(tcm);
+	tcm = syna_sysfs_stats_to_clear(kobj, buf);
+	if (!tcm)
+		return -EINVAL;
 
-	retval = count;
+	syna_tcm_get_predict_stats(tcm->tcm_dev, NULL, NULL, true);
 
-exit:
-	return retval;
+	return count;
 }
 
-static struct kobj_attribute kobj_attr_fw_update =
-	__ATTR(fw_update, 0220, NULL, syna_sysfs_fw_update_store);
-#endif
+static struct kobj_attribute kobj_attr_predict_stats =
+	__ATTR(predict_stats, 0664, syna_sysfs_predict_stats_show,
+		syna_sysfs_predict_stats_store);
 
-/* Definitions of debugging sysfs attributes */
-static struct attribute *attrs_debug[] = {
-	&kobj_attr_reset.attr,
-	&kobj_attr_irq_en.attr,
-	&kobj_attr_pwr.attr,
-#if defined(HAS_REFLASH_FEATURE)
-	&kobj_attr_fw_update.attr,
-#endif
-#if defined(CONFIG_TOUCHSCREEN_SYNA_TCM2_DEBUG_MSG)
-	&kobj_attr_trace_enable.attr,
-#endif
-	NULL,
-};
+/*
+ * Debugging attribute to show the statistics of interrupt handling.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_irq_stats_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+	struct isr_stats *stats;
+	unsigned int samples = 0;
+	unsigned int idx;
 
-static struct attribute_group attr_debug_group = {
-	.attrs = attrs_debug,
-};
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	stats = &tcm->isr_stats;
+	for (idx = 0; idx < IRQ_LATENCY_BUCKETS; idx++)
+		samples += stats->latency_hist[idx];
+	if (samples == 0)
+		samples = 1;
+
+	return scnprintf(buf, PAGE_SIZE,
+			"wakeups: %u\nreports: %u\nmax reports per wakeup: %u\n"
+			"reports interleaved in writes: %u\n"
+			"wakeup latency: avg %llu us, max %u us\n"
+			"wakeup latency histogram: <50us %u, <100us %u, <200us %u, "
+			"<500us %u, <1ms %u, >=1ms %u\n",
+			stats->wakeups, stats->reports, stats->max_reports,
+			tcm->tcm_dev->msg_data.interleaved_reports,
+			div_u64(stats->latency_us, samples), stats->max_latency_us,
+			stats->latency_hist[0], stats->latency_hist[1],
+			stats->latency_hist[2], stats->latency_hist[3],
+			stats->latency_hist[4], stats->latency_hist[5]);
+}
 
 /*
- * Attribute to enable/disable the debugging attributes.
+ * Debugging attribute to clear the statistics of interrupt handling,
+ * only '0' is accepted.
  *
  * param
  *    [ in] kobj:  pointer to kernel object
@@ -379,263 +444,1648 @@ static struct attribute_group attr_debug_group = {
  * return
  *    0 or positive value in case of success, a negative value otherwise.
  */
-static ssize_t syna_sysfs_debug_store(struct kobject *kobj,
+static ssize_t syna_sysfs_irq_stats_store(struct kobject *kobj,
 	struct kobj_attribute *attr, const char *buf, size_t count)
 {
-	unsigned int input;
+	struct syna_tcm *tcm;
+
+	tcm = syna_sysfs_stats_to_clear(kobj, buf);
+	if (!tcm)
+		return -EINVAL;
+
+	syna_pal_mem_set(&tcm->isr_stats, 0, sizeof(tcm->isr_stats));
+	tcm->tcm_dev->msg_data.interleaved_reports = 0;
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_irq_stats =
+	__ATTR(irq_stats, 0664, syna_sysfs_irq_stats_show,
+		syna_sysfs_irq_stats_store);
+
+#if defined(ENABLE_REPORT_PIPELINE)
+/*
+ * Debugging attribute to show the statistics of report pipeline.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_pipeline_stats_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
 	struct device *p_dev;
 	struct syna_tcm *tcm;
+	struct syna_report_pipeline *pipe;
+	struct report_pipeline_stats stats;
+	unsigned int queued;
 
-	p_dev = container_of(kobj->parent, struct device, kobj);
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
 	tcm = dev_get_drvdata(p_dev);
 
-	if (kstrtouint(buf, 10, &input))
-		return -EINVAL;
+	pipe = &tcm->report_pipe;
+
+	spin_lock(&pipe->lock);
+	stats = pipe->stats;
+	spin_unlock(&pipe->lock);
+
+	queued = (stats.queued > 0) ? stats.queued : 1;
+
+	return scnprintf(buf, PAGE_SIZE,
+			"enabled: %s\nqueued: %u\nqueue depth: %u (max %u)\n"
+			"stalls: %u\nin place: %u\nfetch stage: avg %llu us, max %u us\n"
+			"report stage: avg %llu us, max %u us\n",
+			(pipe->worker) ? "yes" : "no",
+			stats.queued, kfifo_len(&pipe->ring),
+			stats.max_depth, stats.stalls, stats.in_place,
+			div_u64(stats.fetch_us, queued),
+			stats.max_fetch_us,
+			div_u64(stats.report_us, queued),
+			stats.max_report_us);
+}
 
-	if ((input == 1) && (!tcm->sysfs_dbg_dir)) {
-		tcm->sysfs_dbg_dir = kobject_create_and_add(SYSFS_SUB_DIR, tcm->sysfs_dir);
-		if (!tcm->sysfs_dbg_dir) {
-			LOGE("Fail to create sysfs sub directory for debugging\n");
-			return -ENOTDIR;
-		}
+/*
+ * Debugging attribute to clear the statistics of report pipeline,
+ * only '0' is accepted.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_pipeline_stats_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	struct syna_tcm *tcm;
 
-		if (sysfs_create_group(tcm->sysfs_dbg_dir, &attr_debug_group) < 0) {
-			LOGE("Fail to create sysfs debug group\n");
-			kobject_put(tcm->sysfs_dbg_dir);
-			return -ENOTDIR;
-		}
-	} else if (input == 0) {
-		if (tcm->sysfs_dbg_dir) {
-			sysfs_remove_group(tcm->sysfs_dbg_dir, &attr_debug_group);
-			kobject_put(tcm->sysfs_dbg_dir);
-			tcm->sysfs_dbg_dir = NULL;
-		}
-	} else {
-		LOGW("Unknown option %d (0:disable / 1:enable)\n", input);
+	tcm = syna_sysfs_stats_to_clear(kobj, buf);
+	if (!tcm)
 		return -EINVAL;
-	}
+
+	spin_lock(&tcm->report_pipe.lock);
+	syna_pal_mem_set(&tcm->report_pipe.stats, 0,
+		sizeof(tcm->report_pipe.stats));
+	spin_unlock(&tcm->report_pipe.lock);
 
 	return count;
 }
 
-static struct kobj_attribute kobj_attr_debug =
-	__ATTR(debug, 0220, NULL, syna_sysfs_debug_store);
+static struct kobj_attribute kobj_attr_pipeline_stats =
+	__ATTR(pipeline_stats, 0664, syna_sysfs_pipeline_stats_show,
+		syna_sysfs_pipeline_stats_store);
+#endif
 
+#if defined(ENABLE_REPORT_POLLING)
 /*
- * Attribute to show the device and driver information to the console.
+ * Debugging attribute to show the statistics of report polling.
  *
  * param
  *    [ in] kobj:  pointer to kernel object
  *    [ in] attr:  pointer to kernel attribute
- *    [out] buf:  string buffer shown on console
+ *    [out] buf:   string buffer shown on console
  *
  * return
  *    string output in case of success, a negative value otherwise.
  */
-static ssize_t syna_sysfs_info_show(struct kobject *kobj,
+static ssize_t syna_sysfs_polling_stats_show(struct kobject *kobj,
 	struct kobj_attribute *attr, char *buf)
 {
-	int retval;
-	unsigned int count;
 	struct device *p_dev;
 	struct syna_tcm *tcm;
-	struct tcm_dev *tcm_dev;
-	int i;
+	struct syna_report_polling *poll;
 
-	p_dev = container_of(kobj->parent, struct device, kobj);
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
 	tcm = dev_get_drvdata(p_dev);
-	tcm_dev = tcm->tcm_dev;
 
-	count = 0;
+	poll = &tcm->report_poll;
+
+	return scnprintf(buf, PAGE_SIZE,
+			"enabled: %s\nrate: %s, period %lld us\npolls: %u\n"
+			"reports: %u\nskipped: %u\nramp up: %u\nramp down: %u\n",
+			(poll->task) ? "yes" : "no",
+			(poll->active) ? "report" : "idle",
+			ktime_to_us(READ_ONCE(poll->period)),
+			poll->stats.polls, poll->stats.reports,
+			poll->stats.skipped, poll->stats.ramp_up,
+			poll->stats.ramp_down);
+}
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-			"Driver version:     %d.%s\n",
-			SYNAPTICS_TCM_DRIVER_VERSION,
-			SYNAPTICS_TCM_DRIVER_SUBVER);
-	if (retval < 0)
-		goto exit;
+/*
+ * Debugging attribute to clear the statistics of report polling,
+ * only '0' is accepted.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_polling_stats_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	struct syna_tcm *tcm;
 
-	buf += retval;
-	count += retval;
+	tcm = syna_sysfs_stats_to_clear(kobj, buf);
+	if (!tcm)
+		return -EINVAL;
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-			"Core lib version:   %d.%02d\n\n",
-			(unsigned char)(SYNA_TCM_CORE_LIB_VERSION >> 8),
-			(unsigned char)SYNA_TCM_CORE_LIB_VERSION);
-	if (retval < 0)
-		goto exit;
+	syna_pal_mem_set(&tcm->report_poll.stats, 0,
+		sizeof(tcm->report_poll.stats));
 
-	buf += retval;
-	count += retval;
+	return count;
+}
 
-	if ((!tcm->is_connected) && (tcm->pwr_state != BARE_MODE)) {
-		retval = scnprintf(buf, PAGE_SIZE - count,
-				"Device is NOT connected\n");
-		count += retval;
-		retval = count;
-		goto exit;
-	} else if (tcm->pwr_state == BARE_MODE) {
-		retval = scnprintf(buf, PAGE_SIZE - count,
-				"Device in BARE connection\n");
-		count += retval;
-		retval = count;
-		goto exit;
-	}
+static struct kobj_attribute kobj_attr_polling_stats =
+	__ATTR(polling_stats, 0664, syna_sysfs_polling_stats_show,
+		syna_sysfs_polling_stats_store);
+#endif
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-			 "Character Dev. Node: /dev/%s* (ref. count:%d)\n\n",
-			CHAR_DEVICE_NAME, tcm->char_dev_ref_count);
-	if (retval < 0)
-		goto exit;
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+/*
+ * Debugging attribute to show the time spent in the interrupt and
+ * polling mode.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_hybrid_stats_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+	struct syna_hybrid_mode *hybrid;
+	unsigned long long irq_us, poll_us;
+	s64 current_us;
 
-	buf += retval;
-	count += retval;
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-			"TouchComm version:  %d\n", tcm_dev->id_info.version);
-	if (retval < 0)
-		goto exit;
+	hybrid = &tcm->hybrid;
+
+	/* including the time of the current mode */
+	irq_us = hybrid->stats.irq_us;
+	poll_us = hybrid->stats.poll_us;
+	current_us = ktime_us_delta(ktime_get(), hybrid->since);
+	if (tcm->pwr_state == PWR_ON) {
+		if (hybrid->polling)
+			poll_us += current_us;
+		else
+			irq_us += current_us;
+	}
 
-	buf += retval;
-	count += retval;
+	return scnprintf(buf, PAGE_SIZE,
+			"mode: %s
+period: %lld us
+enters: %u
+exits: %u
+"
+			"irq mode: %llu ms
+polling mode: %llu ms
+",
+			(hybrid->polling) ? "polling" : "interrupt",
+			ktime_to_us(hybrid->period),
+			hybrid->stats.enters, hybrid->stats.exits,
+			irq_us / 1000, poll_us / 1000);
+}
+
+/*
+ * Debugging attribute to clear the statistics of hybrid mode,
+ * only '0' is accepted.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_hybrid_stats_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	struct syna_tcm *tcm;
+
+	tcm = syna_sysfs_stats_to_clear(kobj, buf);
+	if (!tcm)
+		return -EINVAL;
+
+	syna_pal_mem_set(&tcm->hybrid.stats, 0, sizeof(tcm->hybrid.stats));
+	tcm->hybrid.since = ktime_get();
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_hybrid_stats =
+	__ATTR(hybrid_stats, 0664, syna_sysfs_hybrid_stats_show,
+		syna_sysfs_hybrid_stats_store);
+#endif
+
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+/*
+ * Debugging attribute to show the statistics of vsync-aligned delivery.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_vsync_stats_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+	struct vsync_delivery_stats *stats;
+	unsigned int phase_avg = 0;
+	unsigned int predict_avg = 0;
+
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	stats = &tcm->vsync.stats;
+
+	if (stats->phase_samples > 0)
+		phase_avg = (unsigned int)div_u64(stats->phase_err_us,
+				stats->phase_samples);
+	if (stats->predict_samples > 0)
+		predict_avg = (unsigned int)div_u64(stats->predict_err_us,
+				stats->predict_samples);
+
+	return scnprintf(buf, PAGE_SIZE,
+			"attached: %s\ntracking: %s\nperiod: %lld us\n"
+			"vblanks: %u\ndelivered: %u\ncoalesced: %u\n"
+			"phase error: avg %u us, max %u us\n"
+			"vblank prediction error: avg %u us, max %u us\n",
+			(tcm->vsync.crtc) ? "yes" : "no",
+			(tcm->vsync.tracking) ? "yes" : "no",
+			ktime_to_us(tcm->vsync.period),
+			stats->vblanks, stats->delivered, stats->coalesced,
+			phase_avg, stats->max_phase_err_us,
+			predict_avg, stats->max_predict_err_us);
+}
+
+/*
+ * Debugging attribute to clear the statistics of vsync-aligned delivery,
+ * only '0' is accepted.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_vsync_stats_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	struct syna_tcm *tcm;
+
+	tcm = syna_sysfs_stats_to_clear(kobj, buf);
+	if (!tcm)
+		return -EINVAL;
+
+	spin_lock_irq(&tcm->vsync.lock);
+	syna_pal_mem_set(&tcm->vsync.stats, 0, sizeof(tcm->vsync.stats));
+	spin_unlock_irq(&tcm->vsync.lock);
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_vsync_stats =
+	__ATTR(vsync_stats, 0664, syna_sysfs_vsync_stats_show,
+		syna_sysfs_vsync_stats_store);
+#endif
+
+#if defined(ENABLE_CLOCK_SYNC)
+/*
+ * Debugging attribute to show the model and residual error of the clock
+ * synchronization.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_clock_sync_stats_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+	struct syna_clock_sync *sync;
+	struct clock_sync_stats stats;
+	bool locked;
+	unsigned int bits;
+	u64 rate_q16;
+	unsigned int residual_avg = 0;
+
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	sync = &tcm->clock_sync;
+
+	spin_lock(&sync->lock);
+	stats = sync->stats;
+	locked = sync->locked;
+	bits = sync->bits;
+	rate_q16 = sync->rate_q16;
+	spin_unlock(&sync->lock);
+
+	if (stats.residual_samples > 0)
+		residual_avg = (unsigned int)div_u64(stats.residual_us,
+				stats.residual_samples);
+
+	return scnprintf(buf, PAGE_SIZE,
+			"locked: %s\ntimestamp bits: %u\nsamples: %u\n"
+			"wraps: %u\nresyncs: %u\ntick: %llu.%03llu ns (nominal %u ns)\n"
+			"drift: %d ppm\nresidual: avg %u us, max %u us\n",
+			(locked) ? "yes" : "no", bits, stats.samples,
+			stats.wraps, stats.resyncs,
+			rate_q16 >> 16, ((rate_q16 & 0xffff) * 1000) >> 16,
+			sync->tick_ns, stats.drift_ppm,
+			residual_avg, stats.max_residual_us);
+}
+
+/*
+ * Debugging attribute to clear the statistics of clock synchronization,
+ * only '0' is accepted.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_clock_sync_stats_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	struct syna_tcm *tcm;
+	int drift_ppm;
+
+	tcm = syna_sysfs_stats_to_clear(kobj, buf);
+	if (!tcm)
+		return -EINVAL;
+
+	/* the drift belongs to the model, rather than the counters */
+	spin_lock(&tcm->clock_sync.lock);
+	drift_ppm = tcm->clock_sync.stats.drift_ppm;
+	syna_pal_mem_set(&tcm->clock_sync.stats, 0,
+		sizeof(tcm->clock_sync.stats));
+	tcm->clock_sync.stats.drift_ppm = drift_ppm;
+	spin_unlock(&tcm->clock_sync.lock);
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_clock_sync_stats =
+	__ATTR(clock_sync_stats, 0664, syna_sysfs_clock_sync_stats_show,
+		syna_sysfs_clock_sync_stats_store);
+#endif
+
+#if defined(ENABLE_TOUCH_BOOST)
+/*
+ * Debugging attribute to show the transitions of touch boost.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_boost_stats_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	return scnprintf(buf, PAGE_SIZE,
+			"active: %s\nboost on: %u\nboost off: %u\n",
+			(READ_ONCE(tcm->boost.active)) ? "yes" : "no",
+			tcm->boost.stats.on, tcm->boost.stats.off);
+}
+
+/*
+ * Debugging attribute to clear the statistics of touch boost,
+ * only '0' is accepted.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_boost_stats_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	struct syna_tcm *tcm;
+
+	tcm = syna_sysfs_stats_to_clear(kobj, buf);
+	if (!tcm)
+		return -EINVAL;
+
+	syna_pal_mutex_lock(&tcm->boost.mutex);
+	syna_pal_mem_set(&tcm->boost.stats, 0, sizeof(tcm->boost.stats));
+	syna_pal_mutex_unlock(&tcm->boost.mutex);
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_boost_stats =
+	__ATTR(boost_stats, 0664, syna_sysfs_boost_stats_show,
+		syna_sysfs_boost_stats_store);
+#endif
+
+/*
+ * Debugging attribute to show the latest touch data parsed.
+ *
+ * The data is read from the snapshot published by the report stage,
+ * so reading the attribute never holds up the touch reporting. The report
+ * stage publishes only while the attribute is being read.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    on success, number of characters being output;
+ *    otherwise, negative value on error.
+ */
+static ssize_t syna_sysfs_touch_data_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	int retval;
+	unsigned int count = 0;
+	unsigned int frames;
+	unsigned int idx;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+	struct tcm_touch_data_blob *touch_data;
+	struct tcm_objects_data_blob *object_data;
+
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	touch_data = syna_pal_mem_alloc(1, sizeof(*touch_data));
+	if (!touch_data) {
+		LOGE("Fail to allocate the buffer for touch data\n");
+		return -ENOMEM;
+	}
+
+	frames = syna_dev_read_touch_data(tcm, touch_data);
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+		"frames: %u\nactive objects: %u (mask 0x%08x)\n"
+		"gesture id: %u\ntimestamp: %u\n",
+		frames, touch_data->num_of_active_objects,
+		touch_data->active_objects_mask, touch_data->gesture_id,
+		touch_data->timestamp);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	for (idx = 0; idx < MAX_NUM_OBJECTS; idx++) {
+		if (!(touch_data->active_objects_mask & (1U << idx)))
+			continue;
+
+		object_data = &touch_data->object_data[idx];
 
-	switch (tcm_dev->id_info.mode) {
-	case MODE_APPLICATION_FIRMWARE:
-		retval = scnprintf(buf, PAGE_SIZE - count,
-				"Firmware mode:      Application Firmware, 0x%02x\n",
-				tcm_dev->id_info.mode);
-		if (retval < 0)
-			goto exit;
-		break;
-	case MODE_BOOTLOADER:
-		retval = scnprintf(buf, PAGE_SIZE - count,
-				"Firmware mode:      Bootloader, 0x%02x\n",
-				tcm_dev->id_info.mode);
-		if (retval < 0)
-			goto exit;
-		break;
-	default:
 		retval = scnprintf(buf, PAGE_SIZE - count,
-				"Firmware mode:      Mode 0x%02x\n",
-				tcm_dev->id_info.mode);
+			"object %u: status %u, x %u, y %u, wx %u, wy %u\n",
+			idx, object_data->status, object_data->x_pos,
+			object_data->y_pos, object_data->x_width,
+			object_data->y_width);
 		if (retval < 0)
 			goto exit;
-		break;
+
+		buf += retval;
+		count += retval;
 	}
-	buf += retval;
-	count += retval;
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-			"Part number:        ");
-	if (retval < 0)
-		goto exit;
+	retval = count;
+
+exit:
+	syna_pal_mem_free(touch_data);
+
+	return retval;
+}
+
+static struct kobj_attribute kobj_attr_touch_data =
+	__ATTR(touch_data, 0444, syna_sysfs_touch_data_show, NULL);
+
+#if defined(HAS_REFLASH_FEATURE)
+/*
+ * Debugging attribute to manually do firmware update.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_fw_update_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	int retval = 0;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+	unsigned int input;
+
+	p_dev = container_of(kobj->parent->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (!tcm->is_connected) {
+		LOGW("Device is NOT connected\n");
+		return count;
+	}
+
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	retval = syna_dev_do_reflash(tcm, true);
+	if (retval < 0) {
+		LOGE("Fail to do reflash\n");
+		goto exit;
+	}
+
+	/* check the fw setup in case the settings is changed */
+	if (IS_APP_FW_MODE(tcm->tcm_dev->dev_mode))
+		tcm->dev_set_up_app_fw(tcm);
+
+	retval = count;
+
+exit:
+	return retval;
+}
+
+static struct kobj_attribute kobj_attr_fw_update =
+	__ATTR(fw_update, 0220, NULL, syna_sysfs_fw_update_store);
+#endif
+
+/* Definitions of debugging sysfs attributes */
+static struct attribute *attrs_debug[] = {
+	&kobj_attr_reset.attr,
+	&kobj_attr_irq_en.attr,
+	&kobj_attr_pwr.attr,
+	&kobj_attr_predict_stats.attr,
+	&kobj_attr_irq_stats.attr,
+	&kobj_attr_touch_data.attr,
+#if defined(ENABLE_TOUCH_BOOST)
+	&kobj_attr_boost_stats.attr,
+#endif
+#if defined(ENABLE_REPORT_POLLING)
+	&kobj_attr_polling_stats.attr,
+#endif
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	&kobj_attr_hybrid_stats.attr,
+#endif
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	&kobj_attr_vsync_stats.attr,
+#endif
+#if defined(ENABLE_CLOCK_SYNC)
+	&kobj_attr_clock_sync_stats.attr,
+#endif
+#if defined(ENABLE_REPORT_PIPELINE)
+	&kobj_attr_pipeline_stats.attr,
+#endif
+#if defined(HAS_REFLASH_FEATURE)
+	&kobj_attr_fw_update.attr,
+#endif
+#if defined(CONFIG_TOUCHSCREEN_SYNA_TCM2_DEBUG_MSG)
+	&kobj_attr_trace_enable.attr,
+#endif
+	NULL,
+};
+
+static struct attribute_group attr_debug_group = {
+	.attrs = attrs_debug,
+};
+
+/*
+ * Attribute to enable/disable the debugging attributes.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_debug_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	if ((input == 1) && (!tcm->sysfs_dbg_dir)) {
+		tcm->sysfs_dbg_dir = kobject_create_and_add(SYSFS_SUB_DIR, tcm->sysfs_dir);
+		if (!tcm->sysfs_dbg_dir) {
+			LOGE("Fail to create sysfs sub directory for debugging\n");
+			return -ENOTDIR;
+		}
+
+		if (sysfs_create_group(tcm->sysfs_dbg_dir, &attr_debug_group) < 0) {
+			LOGE("Fail to create sysfs debug group\n");
+			kobject_put(tcm->sysfs_dbg_dir);
+			return -ENOTDIR;
+		}
+	} else if (input == 0) {
+		if (tcm->sysfs_dbg_dir) {
+			sysfs_remove_group(tcm->sysfs_dbg_dir, &attr_debug_group);
+			kobject_put(tcm->sysfs_dbg_dir);
+			tcm->sysfs_dbg_dir = NULL;
+		}
+	} else {
+		LOGW("Unknown option %d (0:disable / 1:enable)\n", input);
+		return -EINVAL;
+	}
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_debug =
+	__ATTR(debug, 0220, NULL, syna_sysfs_debug_store);
+
+/*
+ * Attribute to show the device and driver information to the console.
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:  string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_info_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	int retval;
+	unsigned int count;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+	struct tcm_dev *tcm_dev;
+	int i;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+	tcm_dev = tcm->tcm_dev;
+
+	count = 0;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+			"Driver version:     %d.%s\n",
+			SYNAPTICS_TCM_DRIVER_VERSION,
+			SYNAPTICS_TCM_DRIVER_SUBVER);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+			"Core lib version:   %d.%02d\n\n",
+			(unsigned char)(SYNA_TCM_CORE_LIB_VERSION >> 8),
+			(unsigned char)SYNA_TCM_CORE_LIB_VERSION);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	if ((!tcm->is_connected) && (tcm->pwr_state != BARE_MODE)) {
+		retval = scnprintf(buf, PAGE_SIZE - count,
+				"Device is NOT connected\n");
+		count += retval;
+		retval = count;
+		goto exit;
+	} else if (tcm->pwr_state == BARE_MODE) {
+		retval = scnprintf(buf, PAGE_SIZE - count,
+				"Device in BARE connection\n");
+		count += retval;
+		retval = count;
+		goto exit;
+	}
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+			 "Character Dev. Node: /dev/%s* (ref. count:%d)\n\n",
+			CHAR_DEVICE_NAME, tcm->char_dev_ref_count);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+			"TouchComm version:  %d\n", tcm_dev->id_info.version);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	switch (tcm_dev->id_info.mode) {
+	case MODE_APPLICATION_FIRMWARE:
+		retval = scnprintf(buf, PAGE_SIZE - count,
+				"Firmware mode:      Application Firmware, 0x%02x\n",
+				tcm_dev->id_info.mode);
+		if (retval < 0)
+			goto exit;
+		break;
+	case MODE_BOOTLOADER:
+		retval = scnprintf(buf, PAGE_SIZE - count,
+				"Firmware mode:      Bootloader, 0x%02x\n",
+				tcm_dev->id_info.mode);
+		if (retval < 0)
+			goto exit;
+		break;
+	default:
+		retval = scnprintf(buf, PAGE_SIZE - count,
+				"Firmware mode:      Mode 0x%02x\n",
+				tcm_dev->id_info.mode);
+		if (retval < 0)
+			goto exit;
+		break;
+	}
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+			"Part number:        ");
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = syna_pal_mem_cpy(buf,
+			PAGE_SIZE - count,
+			tcm_dev->id_info.part_number,
+			sizeof(tcm_dev->id_info.part_number),
+			sizeof(tcm_dev->id_info.part_number));
+	if (retval < 0) {
+		LOGE("Fail to copy part number string\n");
+		goto exit;
+	}
+	buf += sizeof(tcm_dev->id_info.part_number);
+	count += sizeof(tcm_dev->id_info.part_number);
+
+	retval = scnprintf(buf, PAGE_SIZE - count, "\n");
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+			"Packrat number:     %d\n\n", tcm_dev->packrat_number);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	if (tcm_dev->id_info.mode != MODE_APPLICATION_FIRMWARE) {
+		retval = count;
+		goto exit;
+	}
+
+	retval = scnprintf(buf, PAGE_SIZE - count, "Config ID:          ");
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	for (i = 0; i < MAX_SIZE_CONFIG_ID; i++) {
+		retval = scnprintf(buf, PAGE_SIZE - count,
+			"0x%2x ", tcm_dev->config_id[i]);
+		if (retval < 0)
+			goto exit;
+		buf += retval;
+		count += retval;
+	}
+
+	retval = scnprintf(buf, PAGE_SIZE - count, "\n");
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+		"Max X & Y:          %d, %d\n", tcm_dev->max_x, tcm_dev->max_y);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+		"Num of objects:     %d\n", tcm_dev->max_objects);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+		"Num of cols & rows: %d, %d\n", tcm_dev->cols, tcm_dev->rows);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+		"Max. Read Size:     %d bytes\n", tcm_dev->max_rd_size);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+		"Max. Write Size:    %d bytes\n", tcm_dev->max_wr_size);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	retval = count;
+
+exit:
+	return retval;
+}
+
+/*
+ * Attribute to perform the device identification
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_info_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+	int retval;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	retval = syna_tcm_identify(tcm->tcm_dev, NULL,
+		tcm->tcm_dev->msg_data.command_polling_time);
+	if (retval < 0)
+		LOGE("Fail to do identification\n");
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_info =
+	__ATTR(info, 0664, syna_sysfs_info_show, syna_sysfs_info_store);
+
+/* Names of input options, in the order of enum input_option */
+static const char * const input_option_names[INPUT_OPT_MAX] = {
+	"type-b-protocol",
+	"swap-xy",
+	"flip-x",
+	"flip-y",
+	"report-touch-width",
+	"wakeup-gesture",
+};
+
+/*
+ * Attribute to show the options of input reporting
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    on success, number of characters being output;
+ *    otherwise, negative value on error.
+ */
+static ssize_t syna_sysfs_input_options_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	int retval;
+	unsigned int count = 0;
+	unsigned int idx;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	retval = scnprintf(buf, PAGE_SIZE - count,
+		"Input options:      0x%02x\n", tcm->input_opts);
+	if (retval < 0)
+		goto exit;
+
+	buf += retval;
+	count += retval;
+
+	for (idx = 0; idx < INPUT_OPT_MAX; idx++) {
+		retval = scnprintf(buf, PAGE_SIZE - count,
+			"    [%d] %-20s %s\n", idx, input_option_names[idx],
+			(tcm->input_opts & BIT(idx)) ? "on" : "off");
+		if (retval < 0)
+			goto exit;
+
+		buf += retval;
+		count += retval;
+	}
+
+	retval = count;
+
+exit:
+	return retval;
+}
+
+/*
+ * Attribute to change the options of input reporting.
+ * Input: bitmask of options listed by the show function
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_input_options_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	int retval;
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (kstrtouint(buf, 0, &input))
+		return -EINVAL;
+
+	if (input & ~(BIT(INPUT_OPT_MAX) - 1))
+		return -EINVAL;
+
+	retval = syna_dev_set_input_options(tcm, input);
+	if (retval < 0) {
+		LOGE("Fail to set input options 0x%02x\n", input);
+		return retval;
+	}
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_input_options =
+	__ATTR(input_options, 0664, syna_sysfs_input_options_show,
+		syna_sysfs_input_options_store);
+
+/*
+ * Attribute to show the rt priority of the irq thread, '0' for the default
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_irq_thread_priority_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->irq_sched.prio);
+}
+
+/*
+ * Attribute to change the rt priority of the irq thread
+ * Input: 1 ~ 99, or '0' to use the default
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_irq_thread_priority_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	int retval;
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	retval = syna_dev_set_irq_thread_priority(tcm, input);
+	if (retval < 0)
+		return retval;
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_irq_thread_priority =
+	__ATTR(irq_thread_priority, 0664, syna_sysfs_irq_thread_priority_show,
+		syna_sysfs_irq_thread_priority_store);
+
+/*
+ * Attribute to show the cpus running the irq thread, empty for the default
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_irq_cpus_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%*pbl\n",
+			cpumask_pr_args(&tcm->irq_sched.cpus));
+}
+
+/*
+ * Attribute to change the cpus running the irq thread
+ * Input: cpu list, such as "4-5"; or, an empty string to use the default
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_irq_cpus_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	int retval;
+	cpumask_var_t cpus;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (!zalloc_cpumask_var(&cpus, GFP_KERNEL))
+		return -ENOMEM;
+
+	retval = cpulist_parse(buf, cpus);
+	if (retval < 0) {
+		LOGE("Invalid cpu list\n");
+		goto exit;
+	}
+
+	retval = syna_dev_set_irq_cpus(tcm, cpus);
+	if (retval < 0)
+		goto exit;
+
+	retval = count;
+
+exit:
+	free_cpumask_var(cpus);
+
+	return retval;
+}
+
+static struct kobj_attribute kobj_attr_irq_cpus =
+	__ATTR(irq_cpus, 0664, syna_sysfs_irq_cpus_show,
+		syna_sysfs_irq_cpus_store);
+
+#if defined(ENABLE_TOUCH_BOOST)
+/*
+ * Attribute to show the cpu latency requested while boosting
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_boost_latency_us_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->boost.latency_us);
+}
+
+/*
+ * Attribute to change the cpu latency requested while boosting
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_boost_latency_us_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	syna_dev_set_touch_boost(tcm, input, tcm->boost.idle_ms,
+		tcm->boost.uclamp_min);
+
+	return count;
+}
+
+/*
+ * Attribute to show the idle time to release the touch boost
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_boost_idle_ms_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->boost.idle_ms);
+}
+
+/*
+ * Attribute to change the idle time to release the touch boost, 0 to disable
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_boost_idle_ms_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	syna_dev_set_touch_boost(tcm, tcm->boost.latency_us, input,
+		tcm->boost.uclamp_min);
+
+	return count;
+}
+
+/*
+ * Attribute to show the minimum utilization of the threads while boosting
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_boost_uclamp_min_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->boost.uclamp_min);
+}
+
+/*
+ * Attribute to change the minimum utilization of the threads while boosting
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_boost_uclamp_min_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	if (input > SCHED_CAPACITY_SCALE) {
+		LOGW("Invalid utilization %d (0 ~ %d)\n", input,
+			(int)SCHED_CAPACITY_SCALE);
+		return -EINVAL;
+	}
+
+	syna_dev_set_touch_boost(tcm, tcm->boost.latency_us, tcm->boost.idle_ms,
+		input);
+
+	return count;
+}
+
+static struct kobj_attribute kobj_attr_boost_latency_us =
+	__ATTR(boost_latency_us, 0664, syna_sysfs_boost_latency_us_show,
+		syna_sysfs_boost_latency_us_store);
+static struct kobj_attribute kobj_attr_boost_idle_ms =
+	__ATTR(boost_idle_ms, 0664, syna_sysfs_boost_idle_ms_show,
+		syna_sysfs_boost_idle_ms_store);
+static struct kobj_attribute kobj_attr_boost_uclamp_min =
+	__ATTR(boost_uclamp_min, 0664, syna_sysfs_boost_uclamp_min_show,
+		syna_sysfs_boost_uclamp_min_store);
+#endif
+
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+/*
+ * Attribute to show the back-to-back reports to start polling
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_hybrid_enter_reports_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->hybrid.enter_reports);
+}
+
+/*
+ * Attribute to change the back-to-back reports to start polling, '0' to disable
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_hybrid_enter_reports_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
 
-	buf += retval;
-	count += retval;
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
 
-	retval = syna_pal_mem_cpy(buf,
-			PAGE_SIZE - count,
-			tcm_dev->id_info.part_number,
-			sizeof(tcm_dev->id_info.part_number),
-			sizeof(tcm_dev->id_info.part_number));
-	if (retval < 0) {
-		LOGE("Fail to copy part number string\n");
-		goto exit;
-	}
-	buf += sizeof(tcm_dev->id_info.part_number);
-	count += sizeof(tcm_dev->id_info.part_number);
+	syna_dev_set_hybrid_mode(tcm, input, tcm->hybrid.exit_polls);
 
-	retval = scnprintf(buf, PAGE_SIZE - count, "\n");
-	if (retval < 0)
-		goto exit;
+	return count;
+}
 
-	buf += retval;
-	count += retval;
+/*
+ * Attribute to show the polls without report to return to interrupts
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_hybrid_exit_polls_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-			"Packrat number:     %d\n\n", tcm_dev->packrat_number);
-	if (retval < 0)
-		goto exit;
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
 
-	buf += retval;
-	count += retval;
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->hybrid.exit_polls);
+}
 
-	if (tcm_dev->id_info.mode != MODE_APPLICATION_FIRMWARE) {
-		retval = count;
-		goto exit;
+/*
+ * Attribute to change the polls without report to return to interrupts
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_hybrid_exit_polls_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	if (input == 0) {
+		LOGW("Invalid number of polls %d (1 ~ )\n", input);
+		return -EINVAL;
 	}
 
-	retval = scnprintf(buf, PAGE_SIZE - count, "Config ID:          ");
-	if (retval < 0)
-		goto exit;
+	syna_dev_set_hybrid_mode(tcm, tcm->hybrid.enter_reports, input);
 
-	buf += retval;
-	count += retval;
+	return count;
+}
 
-	for (i = 0; i < MAX_SIZE_CONFIG_ID; i++) {
-		retval = scnprintf(buf, PAGE_SIZE - count,
-			"0x%2x ", tcm_dev->config_id[i]);
-		if (retval < 0)
-			goto exit;
-		buf += retval;
-		count += retval;
+static struct kobj_attribute kobj_attr_hybrid_enter_reports =
+	__ATTR(hybrid_enter_reports, 0664, syna_sysfs_hybrid_enter_reports_show,
+		syna_sysfs_hybrid_enter_reports_store);
+static struct kobj_attribute kobj_attr_hybrid_exit_polls =
+	__ATTR(hybrid_exit_polls, 0664, syna_sysfs_hybrid_exit_polls_show,
+		syna_sysfs_hybrid_exit_polls_store);
+#endif
+
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+/*
+ * Attribute to show the mode of vsync-aligned delivery
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_vsync_delivery_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->vsync.mode);
+}
+
+/*
+ * Attribute to change the mode of vsync-aligned delivery
+ * 0 - off, 1 - latest frame, 2 - extrapolated to the vblank
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_vsync_delivery_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
+
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
+
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	if (input > VSYNC_DELIVERY_EXTRAPOLATED) {
+		LOGW("Unknown mode %d (0:off, 1:latest, 2:extrapolated)\n",
+			input);
+		return -EINVAL;
 	}
 
-	retval = scnprintf(buf, PAGE_SIZE - count, "\n");
-	if (retval < 0)
-		goto exit;
+	syna_dev_set_vsync_delivery(tcm, input, tcm->vsync.lead_us);
 
-	buf += retval;
-	count += retval;
+	return count;
+}
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-		"Max X & Y:          %d, %d\n", tcm_dev->max_x, tcm_dev->max_y);
-	if (retval < 0)
-		goto exit;
+/*
+ * Attribute to show the time to deliver ahead of the vblank
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_vsync_lead_us_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
 
-	buf += retval;
-	count += retval;
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-		"Num of objects:     %d\n", tcm_dev->max_objects);
-	if (retval < 0)
-		goto exit;
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->vsync.lead_us);
+}
 
-	buf += retval;
-	count += retval;
+/*
+ * Attribute to change the time to deliver ahead of the vblank
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [ in] buf:   string buffer input
+ *    [ in] count: size of buffer input
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_vsync_lead_us_store(struct kobject *kobj,
+	struct kobj_attribute *attr, const char *buf, size_t count)
+{
+	unsigned int input;
+	struct device *p_dev;
+	struct syna_tcm *tcm;
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-		"Num of cols & rows: %d, %d\n", tcm_dev->cols, tcm_dev->rows);
-	if (retval < 0)
-		goto exit;
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
 
-	buf += retval;
-	count += retval;
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-		"Max. Read Size:     %d bytes\n", tcm_dev->max_rd_size);
-	if (retval < 0)
-		goto exit;
+	syna_dev_set_vsync_delivery(tcm, tcm->vsync.mode, input);
 
-	buf += retval;
-	count += retval;
+	return count;
+}
 
-	retval = scnprintf(buf, PAGE_SIZE - count,
-		"Max. Write Size:    %d bytes\n", tcm_dev->max_wr_size);
-	if (retval < 0)
-		goto exit;
+static struct kobj_attribute kobj_attr_vsync_delivery =
+	__ATTR(vsync_delivery, 0664, syna_sysfs_vsync_delivery_show,
+		syna_sysfs_vsync_delivery_store);
+static struct kobj_attribute kobj_attr_vsync_lead_us =
+	__ATTR(vsync_lead_us, 0664, syna_sysfs_vsync_lead_us_show,
+		syna_sysfs_vsync_lead_us_store);
+#endif
 
-	buf += retval;
-	count += retval;
+#if defined(ENABLE_CLOCK_SYNC)
+/*
+ * Attribute to show the nominal period of a firmware tick in nanoseconds
+ *
+ * param
+ *    [ in] kobj:  pointer to kernel object
+ *    [ in] attr:  pointer to kernel attribute
+ *    [out] buf:   string buffer shown on console
+ *
+ * return
+ *    string output in case of success, a negative value otherwise.
+ */
+static ssize_t syna_sysfs_clock_sync_tick_ns_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct device *p_dev;
+	struct syna_tcm *tcm;
 
-	retval = count;
+	p_dev = container_of(kobj->parent, struct device, kobj);
+	tcm = dev_get_drvdata(p_dev);
 
-exit:
-	return retval;
+	return scnprintf(buf, PAGE_SIZE, "%u\n", tcm->clock_sync.tick_ns);
 }
 
 /*
- * Attribute to perform the device identification
+ * Attribute to change the nominal period of a firmware tick, which the
+ * drift is measured against
+ * Input: 1 ~ 1000000 ns
  *
  * param
  *    [ in] kobj:  pointer to kernel object
@@ -646,30 +2096,58 @@ exit:
  * return
  *    0 or positive value in case of success, a negative value otherwise.
  */
-static ssize_t syna_sysfs_info_store(struct kobject *kobj,
+static ssize_t syna_sysfs_clock_sync_tick_ns_store(struct kobject *kobj,
 	struct kobj_attribute *attr, const char *buf, size_t count)
 {
+	unsigned int input;
 	struct device *p_dev;
 	struct syna_tcm *tcm;
-	int retval;
 
 	p_dev = container_of(kobj->parent, struct device, kobj);
 	tcm = dev_get_drvdata(p_dev);
 
-	retval = syna_tcm_identify(tcm->tcm_dev, NULL,
-		tcm->tcm_dev->msg_data.command_polling_time);
-	if (retval < 0)
-		LOGE("Fail to do identification\n");
+	if (kstrtouint(buf, 10, &input))
+		return -EINVAL;
+
+	if ((input == 0) || (input > NSEC_PER_MSEC)) {
+		LOGW("Invalid tick period %d (1 ~ %d)\n", input, (int)NSEC_PER_MSEC);
+		return -EINVAL;
+	}
+
+	spin_lock(&tcm->clock_sync.lock);
+	tcm->clock_sync.tick_ns = input;
+	spin_unlock(&tcm->clock_sync.lock);
 
 	return count;
 }
 
-static struct kobj_attribute kobj_attr_info =
-	__ATTR(info, 0664, syna_sysfs_info_show, syna_sysfs_info_store);
+static struct kobj_attribute kobj_attr_clock_sync_tick_ns =
+	__ATTR(clock_sync_tick_ns, 0664, syna_sysfs_clock_sync_tick_ns_show,
+		syna_sysfs_clock_sync_tick_ns_store);
+#endif
 
 /* Definitions of sysfs attributes */
 static struct attribute *attrs[] = {
 	&kobj_attr_info.attr,
+	&kobj_attr_input_options.attr,
+	&kobj_attr_irq_thread_priority.attr,
+	&kobj_attr_irq_cpus.attr,
+#if defined(ENABLE_TOUCH_BOOST)
+	&kobj_attr_boost_latency_us.attr,
+	&kobj_attr_boost_idle_ms.attr,
+	&kobj_attr_boost_uclamp_min.attr,
+#endif
+#if defined(ENABLE_HYBRID_REPORT_MODE)
+	&kobj_attr_hybrid_enter_reports.attr,
+	&kobj_attr_hybrid_exit_polls.attr,
+#endif
+#if defined(ENABLE_VSYNC_ALIGNED_REPORT)
+	&kobj_attr_vsync_delivery.attr,
+	&kobj_attr_vsync_lead_us.attr,
+#endif
+#if defined(ENABLE_CLOCK_SYNC)
+	&kobj_attr_clock_sync_tick_ns.attr,
+#endif
 	&kobj_attr_debug.attr,
 	NULL,
 };
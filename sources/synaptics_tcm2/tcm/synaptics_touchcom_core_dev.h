@@ -84,6 +84,10 @@ extern "C" {
 
 #define MAX_REPORT_TYPES (256)
 
+#define MAX_NUM_IDLE_FRAMES (4)
+
+#define MAX_NUM_PREDICT_SLOTS (4)
+
 #ifdef TOUCHCOMM_TDDI
 #define MAX_NUM_KNOB_OBJECTS (2)
 #endif
@@ -348,6 +352,69 @@ struct tcm_buffer {
 	unsigned char ref_cnt;
 };
 
+/* Structure of Reference-Counted Frame Buffer
+ *
+ * The frame buffer stores an entire message packet retrieved from the bus,
+ * including the message header, so the payload starts at MESSAGE_HEADER_SIZE.
+ *
+ * A frame is shared with the consumers rather than being copied. Each of them
+ * shall hold a reference by syna_tcm_frame_get() and drop it by
+ * syna_tcm_frame_put(); the frame returns to the pool after the last put.
+ *
+ * The private area is allocated along with the frame, the consumer queuing
+ * the frame can keep its own bookkeeping there instead of allocating it per
+ * frame. The area is not cleared when the frame is recycled.
+ */
+struct tcm_frame_buffer {
+	unsigned char *buf;
+	unsigned int buf_size;
+	unsigned int data_length;
+	syna_pal_atomic_t ref_cnt;
+	struct tcm_frame_pool *pool;
+	struct tcm_frame_buffer *next;
+	void *priv;
+	unsigned int priv_size;
+};
+
+/* Structure of the Pool recycling the Frame Buffers
+ *
+ * At most max_idle frames are kept for reuse, and each frame allocated comes
+ * with a private area of priv_size bytes.
+ */
+struct tcm_frame_pool {
+	struct tcm_frame_buffer *idle;
+	unsigned int num_idle;
+	unsigned int max_idle;
+	unsigned int priv_size;
+	syna_pal_mutex_t pool_mutex;
+};
+
+/* Structure of Predicted Length for a Particular Code
+ *
+ * Each slot records one payload length observed recently together with its
+ * weight. The weight is raised once the length is seen again and decays
+ * otherwise, so the slots form a running histogram of the observed lengths.
+ *
+ * The predicted length is the largest length whose weight is significant
+ * within the histogram, so that packets of the common lengths can be fetched
+ * in one bus transaction.
+ *
+ * Each report entry also votes for the code of the report following it, so
+ * the length of the next report is taken from the code expected, rather than
+ * from the code of the latest report, when several reports are interleaved.
+ */
+struct tcm_predict_slot {
+	unsigned short length;
+	unsigned short weight;
+};
+
+struct tcm_predict_entry {
+	struct tcm_predict_slot slot[MAX_NUM_PREDICT_SLOTS];
+	unsigned int predict_length;
+	unsigned char next_code;
+	unsigned char next_votes;
+};
+
 /* Structure of TouchComm Identify Info Packet
  *
  * The identify packet provides the basic TouchComm information and indicate
@@ -449,13 +516,19 @@ struct tcm_features_info {
 	unsigned char byte[16];
 };
 
-/* A Single Data Object used in Finger Reporting */
+/* A Single Data Object used in Finger Reporting
+ * only the fields read by the input reporting are kept here, so the data of
+ * all objects stays compact; the others go to tcm_objects_ext_data_blob
+ */
 struct tcm_objects_data_blob {
 	unsigned char status;
 	unsigned int x_pos;
 	unsigned int y_pos;
 	unsigned int x_width;
 	unsigned int y_width;
+};
+/* Extended Data of a Single Object, rarely used */
+struct tcm_objects_ext_data_blob {
 	unsigned int z;
 	unsigned int tx_pos;
 	unsigned int rx_pos;
@@ -493,6 +566,13 @@ struct tcm_touch_data_blob {
 	unsigned int obji;
 	unsigned int num_of_active_objects;
 	struct tcm_objects_data_blob object_data[MAX_NUM_OBJECTS];
+	struct tcm_objects_ext_data_blob object_ext_data[MAX_NUM_OBJECTS];
+	/* bitmasks of the object slots, one bit per slot
+	 *   active: slots carrying data in the latest report
+	 *   dirty : slots whose status, position or width changed
+	 */
+	unsigned int active_objects_mask;
+	unsigned int dirty_objects_mask;
 
 	/* for gesture */
 	unsigned int gesture_id;
@@ -518,6 +598,55 @@ struct tcm_touch_data_blob {
 #endif
 };
 
+/* Types of operation in the compiled touch report parse plan */
+enum tcm_touch_parse_op_type {
+	TOUCH_PARSE_OP_END = 0,
+	TOUCH_PARSE_OP_LOOP_BEGIN,
+	TOUCH_PARSE_OP_LOOP_END,
+	TOUCH_PARSE_OP_PAD,
+	TOUCH_PARSE_OP_SKIP,
+	TOUCH_PARSE_OP_FIELD,
+	TOUCH_PARSE_OP_OBJ_FIELD,
+	TOUCH_PARSE_OP_OBJ_EXT_FIELD,
+	TOUCH_PARSE_OP_OBJ_STATUS,
+	TOUCH_PARSE_OP_OBJ_INDEX,
+	TOUCH_PARSE_OP_NUM_ACTIVE,
+	TOUCH_PARSE_OP_GESTURE_DATA,
+	TOUCH_PARSE_OP_KNOB_DATA,
+};
+/* A Single Operation of the compiled touch report parse plan */
+struct tcm_touch_parse_op {
+	unsigned char type;
+	unsigned char code;
+	unsigned char bits;
+	/* byte offset of the destination field in the touch or object data */
+	unsigned short dest;
+	/* bit offset from the start of an object, valid in the fixed-layout loop */
+	unsigned short rel_offset;
+};
+/* Touch report parse plan compiled from the touch report configuration
+ * with the loop structure resolved ahead of time
+ */
+struct tcm_touch_parse_plan {
+	bool valid;
+	struct tcm_touch_parse_op *ops;
+	unsigned int num_ops;
+	unsigned int ops_size;
+	/* index of the first op in the loop body, and the op next to the loop */
+	unsigned int loop_body;
+	unsigned int loop_exit;
+	bool loop_active_only;
+	/* the loop body consists of the object entities only, so each of them
+	 * is located at a fixed offset from the start of the object
+	 */
+	bool loop_fixed;
+	bool loop_has_pad;
+	unsigned int loop_stride;
+	/* entities relying on the custom callbacks if registered */
+	bool has_gesture;
+	bool has_custom;
+};
+
 /* Post-reset callback
  * Called after device reset completes.
  *
@@ -588,6 +717,52 @@ struct tcm_custom_gesture_callback {
 	tcm_custom_touch_callback_t cb;
 };
 
+/* Asynchronous command completion callback
+ * Called once the response to an asynchronous command is retrieved,
+ * or the command fails to be issued.
+ *
+ * The callback is invoked in the context processing the ATTN events, so
+ * it must not block on another command; submitting another asynchronous
+ * command is allowed.
+ *
+ * Definitions of callback function
+ * param
+ *    [ in] command:       the completed command
+ *    [ in] callback_data: private data to callback function;
+ *
+ * return
+ *    void.
+ */
+struct tcm_async_command;
+
+typedef void (*tcm_async_command_callback_t) (struct tcm_async_command *command,
+	void *callback_data);
+
+/* Context of an Asynchronous Command
+ *
+ * The context is owned by the caller, and shall remain valid until the
+ * completion callback is invoked.
+ */
+struct tcm_async_command {
+	/* command and data payload to send */
+	unsigned char command;
+	unsigned char *payload;
+	unsigned int payload_length;
+	/* buffer to store the response data, optional */
+	struct tcm_buffer *resp;
+	/* result of the command
+	 *   resp_code: response code returned from device
+	 *   status   : 0 in case of success, a negative value otherwise
+	 */
+	unsigned char resp_code;
+	int status;
+	/* callback invoked at the completion */
+	void *private_data;
+	tcm_async_command_callback_t cb;
+	/* link to the next command in the submission list */
+	struct tcm_async_command *next;
+};
+
 /*
  * Structures used in the TouchComm Command Processing
  *
@@ -608,20 +783,26 @@ struct tcm_message_data_blob {
 	unsigned int command_polling_time;
 	unsigned int turnaround_time;
 	unsigned int command_retry_time;
+	/* time of the last bus transaction for the turnaround tracking */
+	syna_pal_time_t last_xfer_time;
+	bool turnaround_pending;
 	unsigned int retry_resp_cnt;
 	unsigned int retry_cmd_cnt;
 
 	/* completion event for command processing */
 	syna_pal_completion_t cmd_completion;
+	/* completion event of the asynchronous command in flight */
+	syna_pal_completion_t async_completion;
 
 	/* internal buffers
-	 *   in  : buffer storing the data being read 'in'
-	 *   out : buffer storing the data being sent 'out'
-	 *   temp: 'temp' buffer used for continued read operation
+	 *   rx_frame: frame buffer where the data being read 'in' lands
+	 *   out     : buffer storing the data being sent 'out'
 	 */
-	struct tcm_buffer in;
+	struct tcm_frame_buffer *rx_frame;
 	struct tcm_buffer out;
-	struct tcm_buffer temp;
+
+	/* pool of frame buffers for the data retrieved */
+	struct tcm_frame_pool frame_pool;
 
 	/* mutex to protect the command processing */
 	syna_pal_mutex_t cmd_mutex;
@@ -633,12 +814,44 @@ struct tcm_message_data_blob {
 	bool write_then_read_support;
 	unsigned char write_then_read_turnaround_bytes;
 
+	/* double buffers for the pipelined continued reads
+	 * one chunk is verified while the next one is in flight
+	 */
+	struct tcm_buffer chunk_buf[2];
+	syna_pal_completion_t chunk_completion;
+	int chunk_status;
+
 	/* flag for the enabling of predict reading
 	 * predict reading aims to retrieve all data in one transfer;
 	 * otherwise, separately reads the header and payload data
 	 */
 	bool predict_reads;
-	unsigned int predict_length;
+
+	/* flag for the enabling of report interleaving
+	 * a report pending during a long write is retrieved between
+	 * the CONTINUE_WRITE chunks rather than after the entire write
+	 */
+	bool interleave_reports;
+	unsigned int interleaved_reports;
+
+	/* lengths predicted for the reports, indexed by the report code,
+	 * and for the responses, indexed by the command code
+	 */
+	struct tcm_predict_entry predict_report[MAX_REPORT_TYPES];
+	struct tcm_predict_entry predict_resp[MAX_REPORT_TYPES];
+	unsigned char predict_last_report;
+
+	/* statistics of predict reading
+	 *   hits  : packets retrieved entirely in one transaction
+	 *   misses: packets requiring an additional transaction
+	 */
+	unsigned int predict_hits;
+	unsigned int predict_misses;
+
+	/* latency of the command responses in microseconds, indexed by
+	 * the command code, the starting point of the response polling
+	 */
+	unsigned int resp_latency_us[MAX_REPORT_TYPES];
 
 	/* variables for crc info */
 	bool has_crc;
@@ -689,10 +902,10 @@ struct tcm_dev {
 	struct tcm_boot_info boot_info;
 
 	/* internal buffers
-	 *   report: record the TouchComm report to caller
+	 *   report: frame of the latest TouchComm report, shared to caller
 	 *   resp  : record the command response to caller
 	 */
-	struct tcm_buffer report_buf;
+	struct tcm_frame_buffer *report_frame;
 	struct tcm_buffer resp_buf;
 
 	/* touch report configuration */
@@ -701,6 +914,7 @@ struct tcm_dev {
 	unsigned int bits_config_loop;
 	unsigned int bits_config_heading;
 	unsigned int bits_config_tailing;
+	struct tcm_touch_parse_plan touch_plan;
 
 	/* time settings for the certain scenarios */
 	unsigned int fw_mode_switching_time;
@@ -719,6 +933,22 @@ struct tcm_dev {
 	/* flag to indicate an on-going process of touch format update */
 	syna_pal_atomic_t touch_config_update;
 
+	/* submission list of the asynchronous commands
+	 *   async_head/tail: commands waiting to be issued
+	 *   async_inflight : command issued and waiting for the response
+	 *   async_issued   : time the command in flight was issued, its
+	 *                    deadline is the command_timeout_time from then
+	 */
+	struct tcm_async_command *async_head;
+	struct tcm_async_command *async_tail;
+	struct tcm_async_command *async_inflight;
+	syna_pal_time_t async_issued;
+	syna_pal_mutex_t async_mutex;
+	/* number of the commands submitted but not yet completed,
+	 * so the message processing skips the list while it is empty
+	 */
+	syna_pal_atomic_t async_pending;
+
 	/* virtual function to read in a TouchComm message from device
 	 *
 	 * param
@@ -759,6 +989,19 @@ struct tcm_dev {
 	 */
 	void (*terminate)(struct tcm_dev *tcm_dev);
 
+	/* virtual function to progress the asynchronous commands
+	 * complete the command in flight if its response was retrieved or
+	 * its deadline has passed, and then issue the next command in the
+	 * submission list
+	 *
+	 * param
+	 *    [ in] tcm_dev: pointer to TouchComm device
+	 *
+	 * return
+	 *    void.
+	 */
+	void (*process_async)(struct tcm_dev *tcm_dev);
+
 	/* callback to process the custom touch entity */
 	struct tcm_custom_touch_entity_callback cb_custom_touch_entity_handler;
 	/* callback to process the custom gesture definition */
@@ -910,6 +1153,62 @@ static inline int syna_tcm_buf_realloc(struct tcm_buffer *pbuf,
 
 	return 0;
 }
+/*
+ *  Ensure the capacity of buffer for the hot path.
+ *
+ *  Unlike syna_tcm_buf_alloc(), the content is neither cleared nor dropped,
+ *  and nothing is done if the current size is enough. Only the valid data
+ *  is moved in case the buffer has to be extended.
+ *
+ * param
+ *    [ in] pbuf: pointer to a buffer
+ *    [ in] size: required size
+ *
+ * return
+ *     0 or positive value in case of success, a negative value otherwise.
+ */
+static inline int syna_tcm_buf_reserve(struct tcm_buffer *pbuf,
+	unsigned int size)
+{
+	int retval;
+	unsigned char *buf;
+
+	if (!pbuf) {
+		LOGE("Invalid buffer structure\n");
+		return -ERR_INVAL;
+	}
+
+	if (size <= pbuf->buf_size)
+		return 0;
+
+	buf = (unsigned char *)syna_pal_mem_alloc(size, sizeof(unsigned char));
+	if (!buf) {
+		LOGE("Fail to allocate memory (size = %d)\n",
+			(int)(size * sizeof(unsigned char)));
+		return -ERR_NOMEM;
+	}
+
+	if (pbuf->buf) {
+		if (pbuf->data_length > 0) {
+			retval = syna_pal_mem_cpy(buf,
+					size,
+					pbuf->buf,
+					pbuf->buf_size,
+					MIN(pbuf->data_length, pbuf->buf_size));
+			if (retval < 0) {
+				LOGE("Fail to copy data\n");
+				syna_pal_mem_free((void *)buf);
+				return retval;
+			}
+		}
+		syna_pal_mem_free((void *)pbuf->buf);
+	}
+
+	pbuf->buf = buf;
+	pbuf->buf_size = size;
+
+	return 0;
+}
 /*
  *  Initialize the buffer.
  *
@@ -1059,10 +1358,276 @@ static inline int syna_tcm_buf_copy(struct tcm_buffer *dest,
 }
 
 
+/*
+ * Helpers for Frame Buffer Management
+ */
+
+/*
+ *  Initialize the pool of frame buffers.
+ *
+ * param
+ *    [ in] pool: pointer to a frame pool
+ *
+ * return
+ *     0 or positive value in case of success, a negative value otherwise.
+ */
+static inline int syna_tcm_frame_pool_init(struct tcm_frame_pool *pool)
+{
+	pool->idle = NULL;
+	pool->num_idle = 0;
+	pool->max_idle = MAX_NUM_IDLE_FRAMES;
+	pool->priv_size = 0;
+
+	return syna_pal_mutex_alloc(&pool->pool_mutex);
+}
+/*
+ *  Release the pool as well as the idle frame buffers.
+ *  All frames in use shall be put back before calling this function.
+ *
+ * param
+ *    [ in] pool: pointer to a frame pool
+ *
+ * return
+ *     none
+ */
+static inline void syna_tcm_frame_pool_release(struct tcm_frame_pool *pool)
+{
+	struct tcm_frame_buffer *frame;
+
+	syna_pal_mutex_lock(&pool->pool_mutex);
+
+	while (pool->idle) {
+		frame = pool->idle;
+		pool->idle = frame->next;
+
+		syna_pal_mem_free((void *)frame->buf);
+		syna_pal_mem_free((void *)frame);
+	}
+	pool->num_idle = 0;
+
+	syna_pal_mutex_unlock(&pool->pool_mutex);
+
+	syna_pal_mutex_free(&pool->pool_mutex);
+}
+/*
+ *  Take a frame buffer from the pool, a new one is allocated if no idle frame.
+ *  The returned frame holds one reference.
+ *
+ * param
+ *    [ in] pool: pointer to a frame pool
+ *
+ * return
+ *     pointer to the frame buffer in case of success, NULL otherwise.
+ */
+static inline struct tcm_frame_buffer *syna_tcm_frame_alloc(struct tcm_frame_pool *pool)
+{
+	struct tcm_frame_buffer *frame;
+	unsigned int priv_size;
+
+	syna_pal_mutex_lock(&pool->pool_mutex);
+
+	frame = pool->idle;
+	if (frame) {
+		pool->idle = frame->next;
+		pool->num_idle--;
+	}
+	priv_size = pool->priv_size;
+
+	syna_pal_mutex_unlock(&pool->pool_mutex);
+
+	if (!frame) {
+		/* the private area is placed right behind the frame */
+		frame = (struct tcm_frame_buffer *)syna_pal_mem_alloc(1,
+			sizeof(struct tcm_frame_buffer) + priv_size);
+		if (!frame) {
+			LOGE("Fail to allocate frame buffer\n");
+			return NULL;
+		}
+		frame->buf = NULL;
+		frame->buf_size = 0;
+		frame->priv = (priv_size > 0) ? (void *)(frame + 1) : NULL;
+		frame->priv_size = priv_size;
+	}
+
+	frame->pool = pool;
+	frame->next = NULL;
+	frame->data_length = 0;
+	ATOMIC_SET(frame->ref_cnt, 1);
+
+	return frame;
+}
+/*
+ *  Hold a reference to the frame buffer.
+ *
+ * param
+ *    [ in] frame: pointer to a frame buffer
+ *
+ * return
+ *     the given frame buffer.
+ */
+static inline struct tcm_frame_buffer *syna_tcm_frame_get(struct tcm_frame_buffer *frame)
+{
+	if (frame)
+		ATOMIC_INC(frame->ref_cnt);
+
+	return frame;
+}
+/*
+ *  Drop a reference to the frame buffer.
+ *  Once the last reference is dropped, the frame goes back to the pool.
+ *
+ * param
+ *    [ in] frame: pointer to a frame buffer
+ *
+ * return
+ *     none
+ */
+static inline void syna_tcm_frame_put(struct tcm_frame_buffer *frame)
+{
+	struct tcm_frame_pool *pool;
+
+	if (!frame)
+		return;
+
+	if (ATOMIC_DEC(frame->ref_cnt) > 0)
+		return;
+
+	pool = frame->pool;
+
+	syna_pal_mutex_lock(&pool->pool_mutex);
+
+	/* frames without enough private area are not reused */
+	if ((pool->num_idle < pool->max_idle) &&
+		(frame->priv_size >= pool->priv_size)) {
+		frame->next = pool->idle;
+		pool->idle = frame;
+		pool->num_idle++;
+		frame = NULL;
+	}
+
+	syna_pal_mutex_unlock(&pool->pool_mutex);
+
+	if (frame) {
+		syna_pal_mem_free((void *)frame->buf);
+		syna_pal_mem_free((void *)frame);
+	}
+}
+/*
+ *  Extend the frame buffer if the current size is less than the requirement.
+ *  Data already stored in the frame is preserved.
+ *
+ * param
+ *    [ in] frame: pointer to a frame buffer
+ *    [ in] size:  required size
+ *
+ * return
+ *     0 or positive value in case of success, a negative value otherwise.
+ */
+static inline int syna_tcm_frame_reserve(struct tcm_frame_buffer *frame,
+	unsigned int size)
+{
+	unsigned char *buf;
+
+	if (size <= frame->buf_size)
+		return 0;
+
+	buf = (unsigned char *)syna_pal_mem_alloc(size, sizeof(unsigned char));
+	if (!buf) {
+		LOGE("Fail to allocate memory (size = %d)\n", size);
+		return -ERR_NOMEM;
+	}
+
+	if (frame->buf) {
+		syna_pal_mem_cpy(buf, size, frame->buf, frame->buf_size, frame->buf_size);
+		syna_pal_mem_free((void *)frame->buf);
+	}
+
+	frame->buf = buf;
+	frame->buf_size = size;
+
+	return 0;
+}
+
+/*
+ * Helpers for Predict Reading
+ */
+
+/*
+ *  Clear all lengths predicted as well as the statistics.
+ *
+ * param
+ *    [ in] tcm_msg: message wrapper structure
+ *
+ * return
+ *     none
+ */
+static inline void syna_tcm_reset_predict_table(struct tcm_message_data_blob *tcm_msg)
+{
+	syna_pal_mem_set(tcm_msg->predict_report, 0, sizeof(tcm_msg->predict_report));
+	syna_pal_mem_set(tcm_msg->predict_resp, 0, sizeof(tcm_msg->predict_resp));
+	tcm_msg->predict_last_report = 0;
+	tcm_msg->predict_hits = 0;
+	tcm_msg->predict_misses = 0;
+}
+
+
 /*
  * Abstractions to Hardware Operation
  */
 
+/* remaining turnaround time shorter than this is waited by busy delay */
+#define TURNAROUND_BUSY_WAIT_US (20)
+
+/*
+ *  Wait for the remaining bus turnaround time since the last transaction.
+ *  The time already spent after the last transaction is deducted, so the
+ *  delay is applied only if the next transaction comes too early.
+ *
+ * param
+ *    [ in] tcm_dev:  pointer to TouchComm device
+ *
+ * return
+ *    void.
+ */
+static inline void syna_tcm_wait_for_turnaround(struct tcm_dev *tcm_dev)
+{
+#ifndef OS_WIN
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
+	long long remaining;
+
+	if (!tcm_msg->turnaround_pending)
+		return;
+
+	tcm_msg->turnaround_pending = false;
+
+	remaining = (long long)tcm_msg->turnaround_time -
+		syna_pal_time_elapsed_us(tcm_msg->last_xfer_time);
+	if (remaining <= 0)
+		return;
+
+	if (remaining < TURNAROUND_BUSY_WAIT_US)
+		syna_pal_busy_delay_us((int)remaining);
+	else
+		syna_pal_sleep_us((int)remaining);
+#endif
+}
+/*
+ *  Record the completion time of a bus transaction.
+ *
+ * param
+ *    [ in] tcm_dev:  pointer to TouchComm device
+ *
+ * return
+ *    void.
+ */
+static inline void syna_tcm_mark_turnaround(struct tcm_dev *tcm_dev)
+{
+#ifndef OS_WIN
+	tcm_dev->msg_data.last_xfer_time = syna_pal_get_time();
+	tcm_dev->msg_data.turnaround_pending = true;
+#endif
+}
+
  /*
   *  Abstract the operation of data reading regardless the type of bus.
   *
@@ -1077,6 +1642,7 @@ static inline int syna_tcm_buf_copy(struct tcm_buffer *dest,
 static inline int syna_tcm_read(struct tcm_dev *tcm_dev,
 	unsigned char *rd_data, unsigned int rd_len)
 {
+	int retval;
 	struct tcm_hw_platform *hw;
 
 	if (!tcm_dev) {
@@ -1095,7 +1661,13 @@ static inline int syna_tcm_read(struct tcm_dev *tcm_dev,
 		return -ERR_NODEV;
 	}
 
-	return hw->ops_read_data(hw, rd_data, rd_len);
+	syna_tcm_wait_for_turnaround(tcm_dev);
+
+	retval = hw->ops_read_data(hw, rd_data, rd_len);
+
+	syna_tcm_mark_turnaround(tcm_dev);
+
+	return retval;
 }
 
 /*
@@ -1112,6 +1684,7 @@ static inline int syna_tcm_read(struct tcm_dev *tcm_dev,
 static inline int syna_tcm_write(struct tcm_dev *tcm_dev,
 	unsigned char *wr_data, unsigned int wr_len)
 {
+	int retval;
 	struct tcm_hw_platform *hw;
 
 	if (!tcm_dev) {
@@ -1130,7 +1703,13 @@ static inline int syna_tcm_write(struct tcm_dev *tcm_dev,
 		return -ERR_NODEV;
 	}
 
-	return hw->ops_write_data(hw, wr_data, wr_len);
+	syna_tcm_wait_for_turnaround(tcm_dev);
+
+	retval = hw->ops_write_data(hw, wr_data, wr_len);
+
+	syna_tcm_mark_turnaround(tcm_dev);
+
+	return retval;
 }
 
 /*
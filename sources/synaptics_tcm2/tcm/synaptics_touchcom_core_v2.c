@@ -56,6 +56,19 @@
 
 #define RESP_RETRY_DELAY (100)
 
+#define PREDICT_WEIGHT_STEP (64)
+#define PREDICT_WEIGHT_MAX (1024)
+#define PREDICT_WEIGHT_DECAY_SHIFT (3)
+#define PREDICT_NEXT_VOTES_MAX (3)
+
+#define POLLING_INITIAL_INTERVAL_US (1000)
+#define POLLING_MIN_INTERVAL_US (250)
+#define POLLING_SLACK_SHIFT (3)
+#define RESP_LATENCY_EWMA_SHIFT (3)
+#define RESP_LATENCY_MARGIN_SHIFT (2)
+
+#define CHUNK_XFER_TIMEOUT_MS (100)
+
 /* Header of TouchComm v2 Message Packet */
 struct tcm_v2_message_header {
 	union {
@@ -74,6 +87,97 @@ static int syna_tcm_v2_process_command(struct tcm_dev *, unsigned char, unsigned
 static int syna_tcm_v2_process_command_write_then_read(struct tcm_dev*, unsigned char, unsigned char*, unsigned int, unsigned int, bool);
 
 
+/* Tables of CRC-16 (polynomial 0x1021) processing 8 bytes in a step
+ *
+ * crc16_slice_table[0] is the standard table of one byte, and each of the
+ * following table gives the contribution of a byte followed by 'n' bytes.
+ */
+static unsigned short crc16_slice_table[8][256];
+static bool crc16_slice_table_ready;
+
+/*
+ *  Build the tables for the slice-by-8 CRC-16 calculation.
+ *
+ * param
+ *    void
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_crc16_init_table(void)
+{
+	unsigned short r;
+	int i, k;
+
+	if (crc16_slice_table_ready)
+		return;
+
+	for (i = 0; i < 256; i++) {
+		r = (unsigned short)(i << 8);
+		for (k = 0; k < 8; k++)
+			r = (r & 0x8000) ? ((r << 1) ^ 0x1021) : (r << 1);
+		crc16_slice_table[0][i] = r;
+	}
+
+	for (k = 1; k < 8; k++) {
+		for (i = 0; i < 256; i++) {
+			r = crc16_slice_table[k - 1][i];
+			crc16_slice_table[k][i] = (unsigned short)(r << 8) ^ crc16_slice_table[0][r >> 8];
+		}
+	}
+
+	crc16_slice_table_ready = true;
+}
+
+/*
+ *  Calculate the CRC-16 by processing 8 bytes in a step.
+ *  If a destination is given, the data is copied at the same time, so
+ *  the data is traversed only once.
+ *
+ * param
+ *    [out] dst: buffer to copy the data to; or, NULL for calculation only
+ *    [ in] src: byte array for the calculation
+ *    [ in] len: length in bytes
+ *    [ in] val: the initial value given
+ *
+ * return
+ *    the crc-16 value
+ */
+static unsigned short syna_tcm_v2_crc16_copy(unsigned char *dst,
+	const unsigned char *src, unsigned int len, unsigned short val)
+{
+	unsigned short (*t)[256] = crc16_slice_table;
+	unsigned short r = val;
+	unsigned int i;
+
+	if (!crc16_slice_table_ready) {
+		if (dst)
+			syna_pal_mem_cpy(dst, len, src, len, len);
+		return syna_tcm_crc16((unsigned char *)src, len, val);
+	}
+
+	for (; len >= 8; len -= 8) {
+		if (dst) {
+			for (i = 0; i < 8; i++)
+				dst[i] = src[i];
+			dst += 8;
+		}
+
+		r = t[7][src[0] ^ (r >> 8)] ^ t[6][src[1] ^ (r & 0xFF)] ^
+			t[5][src[2]] ^ t[4][src[3]] ^ t[3][src[4]] ^
+			t[2][src[5]] ^ t[1][src[6]] ^ t[0][src[7]];
+		src += 8;
+	}
+
+	while (len--) {
+		if (dst)
+			*dst++ = *src;
+		r = (r << 8) ^ t[0][(r >> 8) ^ *src++];
+	}
+
+	return r;
+}
+
 /*
  *  Helper to determine whether the fw mode switching could be triggered
  *
@@ -349,9 +453,61 @@ static int syna_tcm_v2_parse_idinfo(struct tcm_dev *tcm_dev,
 	return 0;
 }
 
+/*
+ *  Prepare the frame buffer to receive the next message packet.
+ *  The current frame is reused unless it is still referenced by the others.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_v2_prepare_rx_frame(struct tcm_dev *tcm_dev)
+{
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
+
+	if (tcm_msg->rx_frame && (ATOMIC_GET(tcm_msg->rx_frame->ref_cnt) == 1))
+		return 0;
+
+	syna_tcm_frame_put(tcm_msg->rx_frame);
+
+	tcm_msg->rx_frame = syna_tcm_frame_alloc(&tcm_msg->frame_pool);
+	if (!tcm_msg->rx_frame) {
+		LOGE("Fail to get a frame buffer to receive\n");
+		return -ERR_NOMEM;
+	}
+
+	return 0;
+}
+
+/*
+ *  Replace the frame of latest report.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *    [ in] frame:   frame of the new report; or, NULL to clear
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_update_report_frame(struct tcm_dev *tcm_dev,
+	struct tcm_frame_buffer *frame)
+{
+	struct tcm_frame_pool *pool = &tcm_dev->msg_data.frame_pool;
+	struct tcm_frame_buffer *old;
+
+	syna_pal_mutex_lock(&pool->pool_mutex);
+	old = tcm_dev->report_frame;
+	tcm_dev->report_frame = syna_tcm_frame_get(frame);
+	syna_pal_mutex_unlock(&pool->pool_mutex);
+
+	syna_tcm_frame_put(old);
+}
+
 /*
  *  Process the TouchComm report read in by the read_message(),
- *  and copy the data from internal buffer.in to internal buffer.report.
+ *  and share the received frame as the latest report without copying.
  *
  *  If dispatch function is registered, call the corresponding callback functions then.
  *
@@ -366,7 +522,9 @@ static void syna_tcm_v2_dispatch_report(struct tcm_dev *tcm_dev)
 	int retval;
 	struct tcm_message_data_blob *tcm_msg = NULL;
 	syna_pal_completion_t *cmd_completion = NULL;
+	struct tcm_frame_buffer *frame = NULL;
 	unsigned char report_code;
+	unsigned int report_size;
 
 	if (!tcm_dev) {
 		LOGE("Invalid tcm device handle\n");
@@ -377,50 +535,29 @@ static void syna_tcm_v2_dispatch_report(struct tcm_dev *tcm_dev)
 	cmd_completion = &tcm_msg->cmd_completion;
 
 	report_code = tcm_msg->status_report_code;
+	report_size = tcm_msg->payload_length;
 
-	if (tcm_msg->payload_length == 0) {
-		tcm_dev->report_buf.data_length = 0;
-		goto exit;
-	}
-
-	/* store the received report into the internal buffer.report */
-	syna_tcm_buf_lock(&tcm_dev->report_buf);
-
-	retval = syna_tcm_buf_alloc(&tcm_dev->report_buf, tcm_msg->payload_length);
-	if (retval < 0) {
-		LOGE("Fail to allocate memory for internal buf.report\n");
-		syna_tcm_buf_unlock(&tcm_dev->report_buf);
-		goto exit;
-	}
-
-	syna_tcm_buf_lock(&tcm_msg->in);
-
-	retval = syna_pal_mem_cpy(tcm_dev->report_buf.buf,
-			tcm_dev->report_buf.buf_size,
-			&tcm_msg->in.buf[MESSAGE_HEADER_SIZE],
-			tcm_msg->in.buf_size - MESSAGE_HEADER_SIZE,
-			tcm_msg->payload_length);
-	if (retval < 0) {
-		LOGE("Fail to copy payload to buf_report\n");
-		syna_tcm_buf_unlock(&tcm_msg->in);
-		syna_tcm_buf_unlock(&tcm_dev->report_buf);
+	if (report_size == 0) {
+		syna_tcm_v2_update_report_frame(tcm_dev, NULL);
 		goto exit;
 	}
 
-	tcm_dev->report_buf.data_length = tcm_msg->payload_length;
+	/* hold the received frame because it may be replaced by the
+	 * following commands, such as the setup of read/write size
+	 */
+	frame = syna_tcm_frame_get(tcm_msg->rx_frame);
 
-	syna_tcm_buf_unlock(&tcm_msg->in);
-	syna_tcm_buf_unlock(&tcm_dev->report_buf);
+	syna_tcm_v2_update_report_frame(tcm_dev, frame);
 
 	if (report_code == REPORT_IDENTIFY) {
 		/* parse the identify report */
 		retval = syna_tcm_v2_parse_idinfo(tcm_dev,
-				&tcm_msg->in.buf[MESSAGE_HEADER_SIZE],
-				tcm_msg->in.buf_size - MESSAGE_HEADER_SIZE,
-				tcm_msg->payload_length);
+				&frame->buf[MESSAGE_HEADER_SIZE],
+				frame->buf_size - MESSAGE_HEADER_SIZE,
+				report_size);
 		if (retval < 0) {
 			LOGE("Fail to parse identification data\n");
-			return;
+			goto exit;
 		}
 		/* recover the status and report code because it may be overridden by setting the rw size */
 		if (tcm_msg->status_report_code != REPORT_IDENTIFY)
@@ -464,21 +601,19 @@ static void syna_tcm_v2_dispatch_report(struct tcm_dev *tcm_dev)
 
 	/* dispatch the report to the proper callbacks if registered */
 	if (tcm_dev->cb_report_dispatcher[report_code].cb) {
-		syna_tcm_buf_lock(&tcm_dev->report_buf);
 		tcm_dev->cb_report_dispatcher[report_code].cb(
 				report_code,
-				tcm_dev->report_buf.buf,
-				tcm_dev->report_buf.data_length,
+				&frame->buf[MESSAGE_HEADER_SIZE],
+				report_size,
 				tcm_dev->cb_report_dispatcher[report_code].private_data);
-		syna_tcm_buf_unlock(&tcm_dev->report_buf);
 	}
 exit:
-	return;
+	syna_tcm_frame_put(frame);
 }
 
 /*
  *  Process the response packet read in by the read_message(),
- *  and copy the data from internal buffer.in to internal buffer.resp.
+ *  and copy the data from the received frame to internal buffer.resp.
  *
  *  Complete the command processing at the end of function.
  *
@@ -520,7 +655,7 @@ static void syna_tcm_v2_dispatch_response(struct tcm_dev *tcm_dev, bool store_re
 	/* copy the received resp data into the internal buffer.resp */
 	syna_tcm_buf_lock(&tcm_dev->resp_buf);
 
-	retval = syna_tcm_buf_alloc(&tcm_dev->resp_buf, tcm_msg->payload_length);
+	retval = syna_tcm_buf_reserve(&tcm_dev->resp_buf, tcm_msg->payload_length);
 	if (retval < 0) {
 		LOGE("Fail to allocate memory for internal buf.resp\n");
 		syna_tcm_buf_unlock(&tcm_dev->resp_buf);
@@ -528,23 +663,18 @@ static void syna_tcm_v2_dispatch_response(struct tcm_dev *tcm_dev, bool store_re
 		goto exit;
 	}
 
-	syna_tcm_buf_lock(&tcm_msg->in);
-
 	retval = syna_pal_mem_cpy(tcm_dev->resp_buf.buf,
 			tcm_dev->resp_buf.buf_size,
-			&tcm_msg->in.buf[MESSAGE_HEADER_SIZE],
-			tcm_msg->in.buf_size - MESSAGE_HEADER_SIZE,
+			&tcm_msg->rx_frame->buf[MESSAGE_HEADER_SIZE],
+			tcm_msg->rx_frame->buf_size - MESSAGE_HEADER_SIZE,
 			tcm_msg->payload_length);
 	if (retval < 0) {
 		LOGE("Fail to copy payload to internal resp_buf\n");
-		syna_tcm_buf_unlock(&tcm_msg->in);
 		syna_tcm_buf_unlock(&tcm_dev->resp_buf);
 		ATOMIC_SET(tcm_msg->command_status, CMD_STATE_ERROR);
 		goto exit;
 	}
 
-	syna_tcm_buf_unlock(&tcm_msg->in);
-
 	tcm_dev->resp_buf.data_length = tcm_msg->payload_length;
 
 dispatch:
@@ -674,7 +804,7 @@ static int syna_tcm_v2_check_packet(struct tcm_dev *tcm_dev, unsigned char *buf,
 	/* check payload crc */
 	if ((length > 0) && (packet_size > MESSAGE_HEADER_SIZE)) {
 		crc16 = (unsigned short)syna_pal_le2_to_uint(&buf[packet_size - TCM_MSG_CRC_LENGTH]);
-		if (syna_tcm_crc16(buf, packet_size, 0xFFFF) != 0) {
+		if (syna_tcm_v2_crc16_copy(NULL, buf, packet_size, 0xFFFF) != 0) {
 			LOGW("Incorrect payload crc16: 0x%02x\n", crc16);
 			return -PACKET_CRC_FAILURE;
 		}
@@ -760,16 +890,27 @@ static int syna_tcm_v2_create_packet(struct tcm_dev *tcm_dev, unsigned char comm
 	*packet_size = MESSAGE_HEADER_SIZE;
 
 	if (payload_size > 0) {
-		retval = syna_pal_mem_cpy(&buf[MESSAGE_HEADER_SIZE], buf_size - MESSAGE_HEADER_SIZE,
-			payload, payload_size, payload_size);
-		if (retval < 0) {
-			LOGE("Fail to copy payload data\n");
-			return retval;
+		if (!payload) {
+			LOGE("Invalid payload data\n");
+			return -ERR_INVAL;
+		}
+
+		/* copy the payload while calculating the payload crc */
+		if (tcm_msg->has_crc) {
+			crc16 = syna_tcm_v2_crc16_copy(NULL, buf, MESSAGE_HEADER_SIZE, 0xFFFF);
+			crc16 = syna_tcm_v2_crc16_copy(&buf[MESSAGE_HEADER_SIZE], payload, payload_size, crc16);
+		} else {
+			retval = syna_pal_mem_cpy(&buf[MESSAGE_HEADER_SIZE], buf_size - MESSAGE_HEADER_SIZE,
+				payload, payload_size, payload_size);
+			if (retval < 0) {
+				LOGE("Fail to copy payload data\n");
+				return retval;
+			}
+			crc16 = 0xA5A5;
 		}
 
 		/* append payload crc */
 		*packet_size += payload_size;
-		crc16 = (tcm_msg->has_crc) ? syna_tcm_crc16(buf, *packet_size, 0xFFFF) : 0xA5A5;
 		buf[*packet_size] = (unsigned char)((crc16 >> 8) & 0xFF);
 		buf[*packet_size + 1] = (unsigned char)(crc16 & 0xFF);
 		*packet_size += TCM_MSG_CRC_LENGTH;
@@ -829,8 +970,8 @@ static int syna_tcm_v2_write(struct tcm_dev *tcm_dev, unsigned char command,
 
 	syna_tcm_buf_lock(&tcm_msg->out);
 
-	/* allocate the internal out buffer */
-	retval = syna_tcm_buf_alloc(&tcm_msg->out, total_xfer_size);
+	/* ensure the size of internal out buffer, the packet overwrites it entirely */
+	retval = syna_tcm_buf_reserve(&tcm_msg->out, total_xfer_size);
 	if (retval < 0) {
 		LOGE("Fail to allocate memory for internal buf.out\n");
 		goto exit;
@@ -855,17 +996,15 @@ static int syna_tcm_v2_write(struct tcm_dev *tcm_dev, unsigned char command,
 
 exit:
 	syna_tcm_buf_unlock(&tcm_msg->out);
-#ifndef OS_WIN
-	/* delay for the bus turnaround time */
-	syna_pal_sleep_us(tcm_msg->turnaround_time);
-#endif
 	return retval;
 }
 /*
  *  Read in a TouchComm packet from device.
+ *  The packet lands in the receiving frame buffer at the given offset directly.
  *
  * param
  *    [ in] tcm_dev:    pointer to TouchComm device
+ *    [ in] rd_offset:  offset in the receiving frame to store the packet
  *    [ in] rd_length:  number of reading bytes;
  *                      '0' means to read the message header only
  *    [ in] ignore_corrupt_read:   flag to ignore the corrupt read when the fw mode switched
@@ -873,11 +1012,13 @@ exit:
  * return
  *    0 or positive value in case of success, a negative value otherwise.
  */
-static int syna_tcm_v2_read(struct tcm_dev *tcm_dev, unsigned int rd_length, bool ignore_corrupt_read)
+static int syna_tcm_v2_read(struct tcm_dev *tcm_dev, unsigned int rd_offset,
+	unsigned int rd_length, bool ignore_corrupt_read)
 {
 	int retval;
 	struct tcm_v2_message_header *header;
 	struct tcm_message_data_blob *tcm_msg = NULL;
+	struct tcm_frame_buffer *frame;
 	unsigned int max_rd_size;
 	unsigned int size = MESSAGE_HEADER_SIZE;
 	unsigned int xfer_len = (unsigned int)sizeof(struct tcm_v2_message_header);
@@ -895,6 +1036,12 @@ static int syna_tcm_v2_read(struct tcm_dev *tcm_dev, unsigned int rd_length, boo
 		return -ERR_INVAL;
 	}
 
+	frame = tcm_msg->rx_frame;
+	if (!frame) {
+		LOGE("Invalid frame buffer to receive\n");
+		return -ERR_INVAL;
+	}
+
 	max_rd_size = tcm_dev->max_rd_size;
 
 	if (rd_length > 0)
@@ -907,26 +1054,22 @@ static int syna_tcm_v2_read(struct tcm_dev *tcm_dev, unsigned int rd_length, boo
 		return -ERR_INVAL;
 	}
 
-	syna_tcm_buf_lock(&tcm_msg->temp);
-
-	/* allocate the internal temp buffer */
-	retval = syna_tcm_buf_alloc(&tcm_msg->temp, xfer_len);
+	/* extend the frame buffer if needed, the data received is preserved */
+	retval = syna_tcm_frame_reserve(frame, rd_offset + xfer_len);
 	if (retval < 0) {
-		LOGE("Fail to allocate memory for internal buf.temp\n");
+		LOGE("Fail to allocate memory for the frame buffer\n");
 		goto exit;
 	}
 	/* read data from the bus */
 	do {
-		retval = syna_tcm_read(tcm_dev, tcm_msg->temp.buf, xfer_len);
+		retval = syna_tcm_read(tcm_dev, &frame->buf[rd_offset], xfer_len);
 		if (retval < 0) {
 			LOGE("Fail to read %d bytes from device, do retry %d\n", xfer_len, ++retry);
 			syna_pal_sleep_ms(WR_RD_RETRY_DELAY);
 			continue;
 		}
 
-		tcm_msg->temp.data_length = xfer_len;
-
-		header = (struct tcm_v2_message_header *)tcm_msg->temp.buf;
+		header = (struct tcm_v2_message_header *)&frame->buf[rd_offset];
 
 		if (tcm_msg->has_crc) {
 			LOGD("Data %02X %02X %02X %02X (seq:%d, crc6:%02X) (rd_length:%d)\n",
@@ -937,13 +1080,14 @@ static int syna_tcm_v2_read(struct tcm_dev *tcm_dev, unsigned int rd_length, boo
 				header->data[0], header->data[1], header->data[2], header->data[3], rd_length);
 		}
 
-		size += syna_pal_le2_to_uint(header->length);
+		size = MESSAGE_HEADER_SIZE + syna_pal_le2_to_uint(header->length);
 		if (size > MESSAGE_HEADER_SIZE)
 			size += TCM_MSG_CRC_LENGTH;
-		if (size > tcm_msg->temp.data_length)
-			size = tcm_msg->temp.data_length;
+		if (size > xfer_len)
+			size = xfer_len;
 
-		retval = syna_tcm_v2_check_packet(tcm_dev, tcm_msg->temp.buf, tcm_msg->temp.buf_size, size, ignore_corrupt_read);
+		retval = syna_tcm_v2_check_packet(tcm_dev, &frame->buf[rd_offset],
+				frame->buf_size - rd_offset, size, ignore_corrupt_read);
 		if (retval < 0) {
 			switch (retval) {
 			case -PACKET_MISMATCHED_CRC_SETUP:
@@ -960,11 +1104,6 @@ static int syna_tcm_v2_read(struct tcm_dev *tcm_dev, unsigned int rd_length, boo
 	} while ((retval < 0) && (retry < WR_RD_RETRY_TIMES));
 
 exit:
-	syna_tcm_buf_unlock(&tcm_msg->temp);
-#ifndef OS_WIN
-	/* delay for the bus turnaround time */
-	syna_pal_sleep_us(tcm_msg->turnaround_time);
-#endif
 	return retval;
 }
 
@@ -977,6 +1116,7 @@ exit:
  *    [ in] payload:       data payload if any
  *    [ in] size:          size of given payload
  *    [ in] header_length: length being filled into the header
+ *    [ in] rd_offset:     offset in the receiving frame to store the packet
  *    [ in] rd_length:     number of reading bytes;
  *                         '0' means to read the message header only
  *    [ in] resend:        flag for re-sending the packet
@@ -986,12 +1126,13 @@ exit:
  */
 static int syna_tcm_v2_write_then_read(struct tcm_dev *tcm_dev, unsigned char command,
 	unsigned char *payload, unsigned int size, unsigned int header_length,
-	unsigned int rd_length, bool resend)
+	unsigned int rd_offset, unsigned int rd_length, bool resend)
 {
 	int retval;
 	struct tcm_hw_platform *hw;
 	struct tcm_v2_message_header *header;
 	struct tcm_message_data_blob *tcm_msg = NULL;
+	struct tcm_frame_buffer *frame;
 	unsigned int wr_size;
 	unsigned int valid_length;
 	int retry = 0;
@@ -1014,24 +1155,27 @@ static int syna_tcm_v2_write_then_read(struct tcm_dev *tcm_dev, unsigned char co
 		return -ERR_INVAL;
 	}
 
+	frame = tcm_msg->rx_frame;
+	if (!frame) {
+		LOGE("Invalid frame buffer to receive\n");
+		return -ERR_INVAL;
+	}
+
 	wr_size = size + sizeof(struct tcm_v2_message_header);
 	if (size > 0)
 		wr_size += TCM_MSG_CRC_LENGTH;
 
-	syna_tcm_buf_lock(&tcm_msg->temp);
-
-	/* allocate the internal temp buffer */
-	retval = syna_tcm_buf_alloc(&tcm_msg->temp, rd_length);
+	/* extend the frame buffer if needed, the data received is preserved */
+	retval = syna_tcm_frame_reserve(frame, rd_offset + rd_length);
 	if (retval < 0) {
-		LOGE("Fail to allocate memory for internal buf.temp\n");
-		syna_tcm_buf_unlock(&tcm_msg->temp);
+		LOGE("Fail to allocate memory for the frame buffer\n");
 		return retval;
 	}
 
 	syna_tcm_buf_lock(&tcm_msg->out);
 
-	/* allocate the internal out buffer */
-	retval = syna_tcm_buf_alloc(&tcm_msg->out, wr_size);
+	/* ensure the size of internal out buffer, the packet overwrites it entirely */
+	retval = syna_tcm_buf_reserve(&tcm_msg->out, wr_size);
 	if (retval < 0) {
 		LOGE("Fail to allocate memory for internal buf.out\n");
 		goto exit;
@@ -1044,9 +1188,14 @@ static int syna_tcm_v2_write_then_read(struct tcm_dev *tcm_dev, unsigned char co
 	}
 
 	do {
+		syna_tcm_wait_for_turnaround(tcm_dev);
+
 		retval = hw->ops_write_then_read_data(hw, tcm_msg->out.buf,
-			tcm_msg->out.data_length, tcm_msg->temp.buf, rd_length,
+			tcm_msg->out.data_length, &frame->buf[rd_offset], rd_length,
 			tcm_msg->write_then_read_turnaround_bytes);
+
+		syna_tcm_mark_turnaround(tcm_dev);
+
 		if (retval < 0) {
 			LOGE("Fail to do write and read for command 0x%02X, do retry %d\n",
 				command, ++retry);
@@ -1054,9 +1203,7 @@ static int syna_tcm_v2_write_then_read(struct tcm_dev *tcm_dev, unsigned char co
 			continue;
 		}
 
-		tcm_msg->temp.data_length = rd_length;
-
-		header = (struct tcm_v2_message_header *)tcm_msg->temp.buf;
+		header = (struct tcm_v2_message_header *)&frame->buf[rd_offset];
 		valid_length = syna_pal_le2_to_uint(header->length);
 
 		if (tcm_msg->has_crc) {
@@ -1070,9 +1217,11 @@ static int syna_tcm_v2_write_then_read(struct tcm_dev *tcm_dev, unsigned char co
 
 		if (valid_length > MESSAGE_HEADER_SIZE)
 			valid_length += TCM_MSG_CRC_LENGTH;
+		if (valid_length + MESSAGE_HEADER_SIZE > rd_length)
+			valid_length = rd_length - MESSAGE_HEADER_SIZE;
 
-		retval = syna_tcm_v2_check_packet(tcm_dev, tcm_msg->temp.buf,
-				tcm_msg->temp.buf_size, valid_length + MESSAGE_HEADER_SIZE, false);
+		retval = syna_tcm_v2_check_packet(tcm_dev, &frame->buf[rd_offset],
+				frame->buf_size - rd_offset, valid_length + MESSAGE_HEADER_SIZE, false);
 		if (retval < 0) {
 			switch (retval) {
 			case -PACKET_MISMATCHED_CRC_SETUP:
@@ -1091,123 +1240,382 @@ static int syna_tcm_v2_write_then_read(struct tcm_dev *tcm_dev, unsigned char co
 
 exit:
 	syna_tcm_buf_unlock(&tcm_msg->out);
-	syna_tcm_buf_unlock(&tcm_msg->temp);
-#ifndef OS_WIN
-	/* delay for the bus turnaround time */
-	syna_pal_sleep_us(tcm_msg->turnaround_time);
-#endif
 	return retval;
 }
 
 /*
- *  Continuously read in the remaining payload of data from device.
+ *  Callback of the asynchronous chunk transfer, which is invoked by the
+ *  hardware platform once the transfer is done.
+ *
+ * param
+ *    [ in] context: pointer to the message wrapper
+ *    [ in] status:  status of the transfer
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_chunk_complete(void *context, int status)
+{
+	struct tcm_message_data_blob *tcm_msg = (struct tcm_message_data_blob *)context;
+
+	tcm_msg->chunk_status = status;
+	syna_pal_completion_complete(&tcm_msg->chunk_completion);
+}
+
+/*
+ *  Send an ACK to retrieve the next chunk of continued read, the transfer
+ *  is submitted asynchronously and the chunk lands in the given buffer.
  *
  * param
  *    [ in] tcm_dev:  pointer to TouchComm device
- *    [ in] payload_length: requested length of remaining payload
- *    [ in] has_first_chunk: flag to determine whether the first chunk is required to read
+ *    [ in] ack:      buffer to assemble the ACK packet
+ *    [ in] ack_size: size of the ACK buffer
+ *    [out] chunk:    buffer for storing the chunk packet
+ *    [ in] xfer_len: length of payload in the chunk
  *
  * return
  *    0 or positive value in case of success, a negative value otherwise.
  */
-static int syna_tcm_v2_continued_read(struct tcm_dev *tcm_dev, unsigned int payload_length,
-	bool has_first_chunk)
+static int syna_tcm_v2_submit_chunk(struct tcm_dev *tcm_dev, unsigned char *ack,
+	unsigned int ack_size, struct tcm_buffer *chunk, unsigned int xfer_len)
 {
-	int retval = 0;
+	int retval;
+	struct tcm_hw_platform *hw;
 	struct tcm_message_data_blob *tcm_msg = NULL;
-	unsigned int iterations = 0, offset = 0;
-	unsigned int chunks;
-	unsigned int chunk_space;
-	unsigned int total_length;
-	unsigned int remaining_length;
-	unsigned int xfer_len;
-	unsigned int valid_len;
-	bool resend = false;
-	int retry = 0;
+	unsigned int packet_size;
 
 	if (!tcm_dev) {
 		LOGE("Invalid tcm device handle\n");
 		return -ERR_INVAL;
 	}
 
+	hw = tcm_dev->hw;
 	tcm_msg = &tcm_dev->msg_data;
 
-	if (!tcm_msg) {
-		LOGE("Invalid tcm message blob\n");
-		return -ERR_INVAL;
+	retval = syna_tcm_buf_reserve(chunk, xfer_len + EXTRA_PACKET_BYTES);
+	if (retval < 0) {
+		LOGE("Fail to allocate memory for the chunk buffer\n");
+		return retval;
 	}
 
-	if ((payload_length == 0) || (tcm_msg->payload_length == 0))
-		return 0;
+	retval = syna_tcm_v2_create_packet(tcm_dev, CMD_ACK, NULL, 0, 0, false,
+		ack, ack_size, &packet_size);
+	if (retval < 0) {
+		LOGE("Fail to create ACK packet for continued read\n");
+		return retval;
+	}
 
-	if ((payload_length & 0xffff) == 0xffff)
+	syna_pal_completion_reset(&tcm_msg->chunk_completion);
+
+	syna_tcm_wait_for_turnaround(tcm_dev);
+
+	retval = hw->ops_write_then_read_data_async(hw, ack, packet_size, chunk->buf,
+		xfer_len + EXTRA_PACKET_BYTES, tcm_msg->write_then_read_turnaround_bytes,
+		syna_tcm_v2_chunk_complete, tcm_msg);
+	if (retval < 0) {
+		LOGD("Fail to submit the chunk transfer, retval:%d\n", retval);
+		return retval;
+	}
+
+	return 0;
+}
+
+/*
+ *  Wait for the chunk transfer submitted previously.
+ *
+ * param
+ *    [ in] tcm_dev:  pointer to TouchComm device
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_v2_wait_for_chunk(struct tcm_dev *tcm_dev)
+{
+	int retval;
+	struct tcm_message_data_blob *tcm_msg = NULL;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
 		return -ERR_INVAL;
+	}
 
-	/* continued read packet contains the header, payload, and crc16 */
-	total_length = tcm_msg->payload_length + EXTRA_PACKET_BYTES;
-	/* length to read, remember a padding at the end */
-	remaining_length = payload_length;
+	tcm_msg = &tcm_dev->msg_data;
+
+	retval = syna_pal_completion_wait_for(&tcm_msg->chunk_completion,
+		CHUNK_XFER_TIMEOUT_MS);
 
-	syna_tcm_buf_lock(&tcm_msg->in);
+	syna_tcm_mark_turnaround(tcm_dev);
 
-	/* extend the internal buf_in if needed */
-	retval = syna_tcm_buf_realloc(&tcm_msg->in, total_length);
 	if (retval < 0) {
-		LOGE("Fail to allocate memory for internal buf_in\n");
-		syna_tcm_buf_unlock(&tcm_msg->in);
-		return -ERR_NOMEM;
+		LOGE("Timeout waiting for the chunk transfer\n");
+		return -ERR_TIMEDOUT;
 	}
 
-	/* available chunk space for payload =
-	 *     total chunk size - (header + crc16)
-	 */
-	chunk_space = tcm_dev->max_rd_size;
-	if (tcm_dev->max_rd_size == 0) {
-		chunk_space = remaining_length;
-		if ((tcm_dev->hw->alignment_enabled) && (remaining_length > tcm_dev->hw->alignment_boundary))
-			chunk_space = syna_pal_int_alignment(remaining_length, tcm_dev->hw->alignment_base, false);
+	if (tcm_msg->chunk_status < 0) {
+		LOGE("Fail to transfer the chunk, status:%d\n", tcm_msg->chunk_status);
+		return -ERR_TCMMSG;
 	}
-	chunk_space -= EXTRA_PACKET_BYTES;
 
-	chunks = syna_pal_int_division(remaining_length, chunk_space, true);
-	chunks = chunks == 0 ? 1 : chunks;
+	return 0;
+}
 
-	offset = MESSAGE_HEADER_SIZE + (tcm_msg->payload_length - payload_length);
+/*
+ *  Wait until the chunk transfer in flight is really done, even if it runs
+ *  beyond the timeout, because the transfer writes to the chunk buffer and
+ *  signals the completion event when it is done.
+ *
+ * param
+ *    [ in] tcm_dev:  pointer to TouchComm device
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_drain_chunk(struct tcm_dev *tcm_dev)
+{
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
 
-	if (has_first_chunk) {
-		xfer_len = (remaining_length > chunk_space) ? chunk_space : remaining_length;
-		valid_len = xfer_len;
+	while (syna_pal_completion_wait_for(&tcm_msg->chunk_completion,
+			CHUNK_XFER_TIMEOUT_MS) < 0)
+		LOGE("Chunk transfer still in flight, keep waiting\n");
 
-		/* ensure the remaining length to transfer is still aligned */
-		if (tcm_dev->hw->alignment_enabled) {
-			if ((xfer_len > tcm_dev->hw->alignment_boundary) && (xfer_len == remaining_length)) {
-				xfer_len = syna_pal_int_alignment(xfer_len + EXTRA_PACKET_BYTES, tcm_dev->hw->alignment_base, true);
-				xfer_len -= EXTRA_PACKET_BYTES;
+	syna_tcm_mark_turnaround(tcm_dev);
+}
+
+/*
+ *  Read in the remaining chunks of continued read in a pipelined manner.
+ *
+ *  The chunks are retrieved into two buffers alternately. Once a chunk is
+ *  received, the ACK for the next chunk is submitted right away, so the
+ *  transfer of chunk N+1 is in flight while chunk N is verified and placed
+ *  into the receiving frame.
+ *
+ *  Because the next chunk is already requested, a chunk failing to verify
+ *  cannot be re-read by resending its ACK; the read is then failed.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] offset:      offset in the receiving frame to place the payload
+ *    [ in] length:      length of remaining payload
+ *    [ in] chunk_space: available payload space in a chunk
+ *
+ * return
+ *    number of payload bytes placed in case of success, '0' if the pipelined
+ *    read is unavailable at this moment, a negative value otherwise.
+ */
+static int syna_tcm_v2_pipelined_read(struct tcm_dev *tcm_dev, unsigned int offset,
+	unsigned int length, unsigned int chunk_space)
+{
+	int retval;
+	struct tcm_message_data_blob *tcm_msg = NULL;
+	struct tcm_frame_buffer *frame;
+	struct tcm_buffer *chunk;
+	struct tcm_v2_message_header *header;
+	unsigned char ack[2][MESSAGE_HEADER_SIZE];
+	unsigned char seq[2];
+	unsigned int xfer_len[2];
+	unsigned int remaining_length = length;
+	unsigned int placed = 0;
+	unsigned int size;
+	unsigned char seq_toggle;
+	int slot = 0, cur;
+	bool in_flight;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	tcm_msg = &tcm_dev->msg_data;
+	frame = tcm_msg->rx_frame;
+
+	/* issue the first chunk */
+	seq_toggle = tcm_msg->seq_toggle;
+	xfer_len[slot] = MIN(remaining_length, chunk_space);
+	retval = syna_tcm_v2_submit_chunk(tcm_dev, ack[slot], sizeof(ack[slot]),
+		&tcm_msg->chunk_buf[slot], xfer_len[slot]);
+	if (retval < 0) {
+		/* nothing is sent, leave the chunks to be read one by one */
+		tcm_msg->seq_toggle = seq_toggle;
+		return 0;
+	}
+	seq[slot] = tcm_msg->seq_toggle;
+	remaining_length -= xfer_len[slot];
+	in_flight = true;
+
+	while (in_flight) {
+		retval = syna_tcm_v2_wait_for_chunk(tcm_dev);
+		if (retval == -ERR_TIMEDOUT)
+			goto exit;
+
+		/* the transfer is done, no matter whether it succeeded */
+		in_flight = false;
+		if (retval < 0)
+			goto exit;
+
+		cur = slot;
+		chunk = &tcm_msg->chunk_buf[cur];
+
+		/* keep the bus busy with the next chunk during the verification */
+		if (remaining_length > 0) {
+			slot ^= 1;
+			xfer_len[slot] = MIN(remaining_length, chunk_space);
+			retval = syna_tcm_v2_submit_chunk(tcm_dev, ack[slot], sizeof(ack[slot]),
+				&tcm_msg->chunk_buf[slot], xfer_len[slot]);
+			if (retval < 0) {
+				LOGE("Fail to submit the chunk transfer\n");
+				goto exit;
 			}
+			seq[slot] = tcm_msg->seq_toggle;
+			remaining_length -= xfer_len[slot];
+			in_flight = true;
 		}
 
-		/* the first continued read operation can be retrieved directly */
-		retval = syna_tcm_v2_read(tcm_dev, xfer_len, false);
+		header = (struct tcm_v2_message_header *)chunk->buf;
+		size = syna_pal_le2_to_uint(header->length);
+		if (size > 0)
+			size += TCM_MSG_CRC_LENGTH;
+		size = MIN(size, xfer_len[cur] + TCM_MSG_CRC_LENGTH) + MESSAGE_HEADER_SIZE;
+
+		/* verify the chunk against the sequence bit of its own ACK */
+		seq_toggle = tcm_msg->seq_toggle;
+		tcm_msg->seq_toggle = seq[cur];
+		retval = syna_tcm_v2_check_packet(tcm_dev, chunk->buf, chunk->buf_size,
+			size, false);
+		tcm_msg->seq_toggle = seq_toggle;
 		if (retval < 0) {
-			LOGE("Fail to continued read %d bytes from device\n", xfer_len);
-			retval = -ERR_TCMMSG;
+			LOGE("Invalid chunk of continued read, retval:%d\n", retval);
 			goto exit;
 		}
 
-		/* copy data from internal buffer.temp to buffer.in */
-		syna_tcm_buf_lock(&tcm_msg->temp);
-		retval = syna_pal_mem_cpy(&tcm_msg->in.buf[offset],
-			tcm_msg->in.buf_size - offset,
-			&tcm_msg->temp.buf[MESSAGE_HEADER_SIZE],
-			tcm_msg->temp.buf_size - MESSAGE_HEADER_SIZE,
-			valid_len);
+		retval = syna_pal_mem_cpy(&frame->buf[offset + placed], frame->buf_size - offset - placed,
+			&chunk->buf[MESSAGE_HEADER_SIZE], chunk->buf_size - MESSAGE_HEADER_SIZE,
+			xfer_len[cur]);
 		if (retval < 0) {
-			LOGE("Fail to copy payload\n");
-			syna_tcm_buf_unlock(&tcm_msg->temp);
+			LOGE("Fail to place the chunk into the frame\n");
 			goto exit;
 		}
 
-		syna_tcm_buf_unlock(&tcm_msg->temp);
+		placed += xfer_len[cur];
+	}
+
+	return (int)placed;
+
+exit:
+	/* buffers must be kept intact until the transfer in flight is done */
+	if (in_flight)
+		syna_tcm_v2_drain_chunk(tcm_dev);
+
+	return retval;
+}
+
+/*
+ *  Continuously read in the remaining payload of data from device.
+ *
+ *  Each chunk is read into the receiving frame right at the position where its
+ *  payload belongs to, so the header of chunk temporarily overlaps the tail of
+ *  the data received previously. Those bytes are restored after the reading.
+ *
+ * param
+ *    [ in] tcm_dev:  pointer to TouchComm device
+ *    [ in] payload_length: requested length of remaining payload
+ *    [ in] has_first_chunk: flag to determine whether the first chunk is required to read
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_v2_continued_read(struct tcm_dev *tcm_dev, unsigned int payload_length,
+	bool has_first_chunk)
+{
+	int retval = 0;
+	struct tcm_message_data_blob *tcm_msg = NULL;
+	struct tcm_frame_buffer *frame;
+	unsigned char overlapped[MESSAGE_HEADER_SIZE];
+	unsigned int iterations = 0, offset = 0;
+	unsigned int chunks;
+	unsigned int chunk_space;
+	unsigned int total_length;
+	unsigned int remaining_length;
+	unsigned int xfer_len;
+	unsigned int valid_len;
+	unsigned int pos;
+	bool resend = false;
+	int retry = 0;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	tcm_msg = &tcm_dev->msg_data;
+
+	if (!tcm_msg) {
+		LOGE("Invalid tcm message blob\n");
+		return -ERR_INVAL;
+	}
+
+	if ((payload_length == 0) || (tcm_msg->payload_length == 0))
+		return 0;
+
+	if ((payload_length & 0xffff) == 0xffff)
+		return -ERR_INVAL;
+
+	frame = tcm_msg->rx_frame;
+
+	/* continued read packet contains the header, payload, and crc16 */
+	total_length = tcm_msg->payload_length + EXTRA_PACKET_BYTES;
+	/* length to read, remember a padding at the end */
+	remaining_length = payload_length;
+
+	/* extend the frame buffer if needed */
+	retval = syna_tcm_frame_reserve(frame, total_length);
+	if (retval < 0) {
+		LOGE("Fail to allocate memory for the frame buffer\n");
+		return -ERR_NOMEM;
+	}
+
+	/* available chunk space for payload =
+	 *     total chunk size - (header + crc16)
+	 */
+	chunk_space = tcm_dev->max_rd_size;
+	if (tcm_dev->max_rd_size == 0) {
+		chunk_space = remaining_length;
+		if ((tcm_dev->hw->alignment_enabled) && (remaining_length > tcm_dev->hw->alignment_boundary))
+			chunk_space = syna_pal_int_alignment(remaining_length, tcm_dev->hw->alignment_base, false);
+	}
+	chunk_space -= EXTRA_PACKET_BYTES;
+
+	chunks = syna_pal_int_division(remaining_length, chunk_space, true);
+	chunks = chunks == 0 ? 1 : chunks;
+
+	offset = MESSAGE_HEADER_SIZE + (tcm_msg->payload_length - payload_length);
+
+	if (has_first_chunk) {
+		xfer_len = (remaining_length > chunk_space) ? chunk_space : remaining_length;
+		valid_len = xfer_len;
+
+		/* ensure the remaining length to transfer is still aligned */
+		if (tcm_dev->hw->alignment_enabled) {
+			if ((xfer_len > tcm_dev->hw->alignment_boundary) && (xfer_len == remaining_length)) {
+				xfer_len = syna_pal_int_alignment(xfer_len + EXTRA_PACKET_BYTES, tcm_dev->hw->alignment_base, true);
+				xfer_len -= EXTRA_PACKET_BYTES;
+			}
+		}
+
+		pos = offset - MESSAGE_HEADER_SIZE;
+		syna_pal_mem_cpy(overlapped, sizeof(overlapped), &frame->buf[pos],
+			frame->buf_size - pos, sizeof(overlapped));
+
+		/* the first continued read operation can be retrieved directly */
+		retval = syna_tcm_v2_read(tcm_dev, pos, xfer_len, false);
+
+		syna_pal_mem_cpy(&frame->buf[pos], frame->buf_size - pos,
+			overlapped, sizeof(overlapped), sizeof(overlapped));
+
+		if (retval < 0) {
+			LOGE("Fail to continued read %d bytes from device\n", xfer_len);
+			retval = -ERR_TCMMSG;
+			goto exit;
+		}
 
 		offset += valid_len;
 		remaining_length -= valid_len;
@@ -1216,10 +1624,29 @@ static int syna_tcm_v2_continued_read(struct tcm_dev *tcm_dev, unsigned int payl
 	if (!has_first_chunk)
 		chunks += 1;
 
+	/* overlap the chunk transfers with the verification if the platform can */
+	if ((chunks > 2) && (tcm_msg->write_then_read_support) &&
+		(tcm_dev->hw->ops_write_then_read_data_async) && (!tcm_dev->hw->alignment_enabled)) {
+		retval = syna_tcm_v2_pipelined_read(tcm_dev, offset, remaining_length, chunk_space);
+		if (retval < 0) {
+			LOGE("Fail to continued read %d bytes in pipeline\n", remaining_length);
+			retval = -ERR_TCMMSG;
+			goto exit;
+		}
+
+		offset += retval;
+		remaining_length -= retval;
+	}
+
 	/* if still having remaining data, read in through ACK command */
-	for (iterations = 1; iterations < chunks; iterations++) {
+	for (iterations = 1; (iterations < chunks) && (remaining_length > 0); iterations++) {
 		retry = 0;
 		resend = false;
+
+		pos = offset - MESSAGE_HEADER_SIZE;
+		syna_pal_mem_cpy(overlapped, sizeof(overlapped), &frame->buf[pos],
+			frame->buf_size - pos, sizeof(overlapped));
+
 		do {
 			xfer_len = (remaining_length > chunk_space) ? chunk_space : remaining_length;
 			valid_len = xfer_len;
@@ -1233,7 +1660,7 @@ static int syna_tcm_v2_continued_read(struct tcm_dev *tcm_dev, unsigned int payl
 
 			if (tcm_msg->write_then_read_support) {
 				retval = syna_tcm_v2_write_then_read(tcm_dev, CMD_ACK, NULL, 0, 0,
-						xfer_len + EXTRA_PACKET_BYTES, resend);
+						pos, xfer_len + EXTRA_PACKET_BYTES, resend);
 			} else {
 				retval = syna_tcm_v2_write(tcm_dev, CMD_ACK, NULL, 0, 0, resend);
 				if (retval < 0) {
@@ -1242,7 +1669,7 @@ static int syna_tcm_v2_continued_read(struct tcm_dev *tcm_dev, unsigned int payl
 					continue;
 				}
 
-				retval = syna_tcm_v2_read(tcm_dev, xfer_len, false);
+				retval = syna_tcm_v2_read(tcm_dev, pos, xfer_len, false);
 			}
 
 			if (retval < 0) {
@@ -1256,39 +1683,150 @@ static int syna_tcm_v2_continued_read(struct tcm_dev *tcm_dev, unsigned int payl
 				LOGE("Fail to continued read %d bytes from device at chunk %d/%d\n",
 					xfer_len, iterations, chunks);
 				retval = -ERR_TCMMSG;
-				goto exit;
+				break;
 			}
 		} while ((retval < 0) && (retry < (int)tcm_msg->retry_cmd_cnt));
 
-		/* append data from temporary buffer to in_buf */
-		syna_tcm_buf_lock(&tcm_msg->temp);
+		/* recover the data overlapped by the header of chunk */
+		syna_pal_mem_cpy(&frame->buf[pos], frame->buf_size - pos,
+			overlapped, sizeof(overlapped), sizeof(overlapped));
 
-		/* copy data from internal buffer.temp to buffer.in */
-		retval = syna_pal_mem_cpy(&tcm_msg->in.buf[offset],
-			tcm_msg->in.buf_size - offset,
-			&tcm_msg->temp.buf[MESSAGE_HEADER_SIZE],
-			tcm_msg->temp.buf_size - MESSAGE_HEADER_SIZE,
-			valid_len);
-		if (retval < 0) {
-			LOGE("Fail to copy payload to internal buf_in\n");
-			syna_tcm_buf_unlock(&tcm_msg->temp);
+		if (retval < 0)
 			goto exit;
-		}
-
-		syna_tcm_buf_unlock(&tcm_msg->temp);
 
 		offset += valid_len;
 		remaining_length -= valid_len;
 	}
 
-	tcm_msg->in.data_length = offset;
+	frame->data_length = offset;
 
 exit:
-	syna_tcm_buf_unlock(&tcm_msg->in);
-
 	return retval;
 }
 
+/*
+ *  Determine the payload length to read along with the header when
+ *  processing the GET_REPORT command.
+ *
+ *  The length is taken from the code expected to follow the latest report;
+ *  in case a command is being processed, the length of its expected response
+ *  is also considered.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    the predicted length of payload.
+ */
+static unsigned int syna_tcm_v2_get_predict_length(struct tcm_dev *tcm_dev)
+{
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
+	struct tcm_predict_entry *entry;
+	unsigned char code = tcm_msg->predict_last_report;
+	unsigned int length;
+
+	/* the code seen after the latest report, if ever learned */
+	if (tcm_msg->predict_report[code].next_votes > 0)
+		code = tcm_msg->predict_report[code].next_code;
+
+	length = tcm_msg->predict_report[code].predict_length;
+
+	if (ATOMIC_GET(tcm_msg->command_status) == CMD_STATE_BUSY) {
+		/* the identify report is expected if the fw mode switched */
+		if (syna_tcm_v2_is_mode_switching(tcm_dev, tcm_msg->command))
+			entry = &tcm_msg->predict_report[REPORT_IDENTIFY];
+		else
+			entry = &tcm_msg->predict_resp[tcm_msg->command];
+
+		length = MAX(length, entry->predict_length);
+	}
+
+	if (tcm_dev->max_rd_size != 0)
+		length = MIN(length, tcm_dev->max_rd_size - EXTRA_PACKET_BYTES);
+
+	return length;
+}
+
+/*
+ *  Record the payload length of the packet retrieved by GET_REPORT command,
+ *  and then update the predicted length of the corresponding code, as well
+ *  as the code expected after the previous report.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_update_predict_length(struct tcm_dev *tcm_dev)
+{
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
+	struct tcm_predict_entry *entry;
+	struct tcm_predict_slot *slot;
+	unsigned char code = tcm_msg->status_report_code;
+	unsigned int length = tcm_msg->payload_length;
+	unsigned int total = 0;
+	int idx, target = -1, weakest = 0;
+
+	if (code >= REPORT_IDENTIFY) {
+		entry = &tcm_msg->predict_report[tcm_msg->predict_last_report];
+		/* vote for the transition from the previous report */
+		if (tcm_msg->predict_last_report >= REPORT_IDENTIFY) {
+			if (entry->next_code == code) {
+				entry->next_votes = MIN(entry->next_votes + 1,
+					PREDICT_NEXT_VOTES_MAX);
+			} else if (entry->next_votes > 0) {
+				entry->next_votes--;
+			} else {
+				entry->next_code = code;
+				entry->next_votes = 1;
+			}
+		}
+
+		entry = &tcm_msg->predict_report[code];
+		tcm_msg->predict_last_report = code;
+	} else if (ATOMIC_GET(tcm_msg->command_status) == CMD_STATE_BUSY) {
+		entry = &tcm_msg->predict_resp[tcm_msg->command];
+	} else {
+		return;
+	}
+
+	/* age the histogram and look for the slot of this length,
+	 * rounding the decay up so a stale length fades out entirely
+	 */
+	for (idx = 0; idx < MAX_NUM_PREDICT_SLOTS; idx++) {
+		slot = &entry->slot[idx];
+		slot->weight -= (slot->weight + (1 << PREDICT_WEIGHT_DECAY_SHIFT) - 1)
+			>> PREDICT_WEIGHT_DECAY_SHIFT;
+
+		if ((slot->weight > 0) && (slot->length == length))
+			target = idx;
+		if (slot->weight < entry->slot[weakest].weight)
+			weakest = idx;
+	}
+
+	/* replace the weakest slot if the length is not recorded */
+	if (target < 0) {
+		target = weakest;
+		entry->slot[target].length = (unsigned short)length;
+		entry->slot[target].weight = 0;
+	}
+
+	slot = &entry->slot[target];
+	slot->weight = MIN(slot->weight + PREDICT_WEIGHT_STEP, PREDICT_WEIGHT_MAX);
+
+	for (idx = 0; idx < MAX_NUM_PREDICT_SLOTS; idx++)
+		total += entry->slot[idx].weight;
+
+	/* take the largest length appearing in a quarter of packets at least */
+	entry->predict_length = 0;
+	for (idx = 0; idx < MAX_NUM_PREDICT_SLOTS; idx++) {
+		slot = &entry->slot[idx];
+		if ((slot->weight << 2) >= total)
+			entry->predict_length = MAX(entry->predict_length, slot->length);
+	}
+}
+
 /*
  *  Process the message and retrieve the response through the write-then-read operation.
  *
@@ -1311,8 +1849,8 @@ static int syna_tcm_v2_process_command_write_then_read(struct tcm_dev *tcm_dev,
 	struct tcm_message_data_blob *tcm_msg = NULL;
 	bool resend = false;
 	bool do_predict = false;
+	bool mispredicted = false;
 	unsigned int len = 0;
-	int len_copy = 0;
 	int remaining_len = 0;
 	int retry = 0;
 
@@ -1328,21 +1866,26 @@ static int syna_tcm_v2_process_command_write_then_read(struct tcm_dev *tcm_dev,
 		return -ERR_INVAL;
 	}
 
+	retval = syna_tcm_v2_prepare_rx_frame(tcm_dev);
+	if (retval < 0)
+		return retval;
+
 	/* predict reading is applied only when processing GET_REPORT command */
 	do_predict = (tcm_msg->predict_reads) && (command == CMD_GET_REPORT);
 
 	retry = 0;
 	resend = false;
-	do {
-		if (do_predict && (tcm_msg->predict_length > 0))
-			len = tcm_msg->predict_length;
+	if (do_predict)
+		len = syna_tcm_v2_get_predict_length(tcm_dev);
 
+	do {
 		retval = syna_tcm_v2_write_then_read(tcm_dev, command, payload, payload_length,
-				header_length, MESSAGE_HEADER_SIZE + len, resend);
+				header_length, 0, MESSAGE_HEADER_SIZE + len, resend);
 		if (retval < 0) {
 			if ((retval == -PACKET_INVALID_PREDICT) && (tcm_msg->predict_reads)) {
-				len = syna_pal_le2_to_uint(&tcm_msg->temp.buf[1]);
+				len = syna_pal_le2_to_uint(&tcm_msg->rx_frame->buf[1]);
 				resend = true;
+				mispredicted = true;
 				continue;
 			}
 
@@ -1361,9 +1904,7 @@ static int syna_tcm_v2_process_command_write_then_read(struct tcm_dev *tcm_dev,
 		goto exit;
 	}
 
-	syna_tcm_buf_lock(&tcm_msg->temp);
-
-	header = (struct tcm_v2_message_header *)tcm_msg->temp.buf;
+	header = (struct tcm_v2_message_header *)tcm_msg->rx_frame->buf;
 
 	tcm_msg->status_report_code = header->code;
 	tcm_msg->payload_length = syna_pal_le2_to_uint(header->length);
@@ -1371,48 +1912,6 @@ static int syna_tcm_v2_process_command_write_then_read(struct tcm_dev *tcm_dev,
 	LOGD("Status code: 0x%02X, payload length: %d\n",
 		tcm_msg->status_report_code, tcm_msg->payload_length);
 
-	syna_tcm_buf_lock(&tcm_msg->in);
-
-	/* extend the internal buffer.in if needed */
-	retval = syna_tcm_buf_realloc(&tcm_msg->in, tcm_msg->payload_length + MESSAGE_HEADER_SIZE);
-	if (retval < 0) {
-		LOGE("Fail to allocate memory for internal buf_in\n");
-		syna_tcm_buf_unlock(&tcm_msg->in);
-		syna_tcm_buf_unlock(&tcm_msg->temp);
-		goto exit;
-	}
-
-	/* copy data from internal buffer.temp to buffer.in */
-	len_copy = 0;
-	if (tcm_msg->temp.data_length > MESSAGE_HEADER_SIZE) {
-		len_copy = (tcm_msg->payload_length > tcm_msg->temp.data_length) ?
-			tcm_msg->temp.data_length - TCM_MSG_CRC_LENGTH : tcm_msg->payload_length;
-
-		retval = syna_pal_mem_cpy(tcm_msg->in.buf, tcm_msg->in.buf_size,
-				tcm_msg->temp.buf, tcm_msg->temp.buf_size, len_copy);
-		if (retval < 0) {
-			LOGE("Fail to copy payload to internal buf_in\n");
-			syna_tcm_buf_unlock(&tcm_msg->in);
-			syna_tcm_buf_unlock(&tcm_msg->temp);
-			goto exit;
-		}
-		tcm_msg->in.data_length = len_copy;
-	} else {
-		retval = syna_pal_mem_cpy(tcm_msg->in.buf, tcm_msg->in.buf_size,
-				tcm_msg->temp.buf, tcm_msg->temp.buf_size, tcm_msg->temp.buf_size);
-		if (retval < 0) {
-			LOGE("Fail to copy payload to internal buf_in\n");
-			syna_tcm_buf_unlock(&tcm_msg->in);
-			syna_tcm_buf_unlock(&tcm_msg->temp);
-			goto exit;
-		}
-		tcm_msg->in.data_length = tcm_msg->temp.buf_size;
-	}
-
-	syna_tcm_buf_unlock(&tcm_msg->in);
-	syna_tcm_buf_unlock(&tcm_msg->temp);
-
-
 	/* read in remaining payload */
 	remaining_len = tcm_msg->payload_length - len;
 	if (remaining_len > 0) {
@@ -1424,15 +1923,25 @@ static int syna_tcm_v2_process_command_write_then_read(struct tcm_dev *tcm_dev,
 		}
 	}
 
-	/* duplicate the data to the external buffer */
+	tcm_msg->rx_frame->data_length = MESSAGE_HEADER_SIZE + tcm_msg->payload_length;
+
+	/* update the length for the predict reading */
+	if (do_predict) {
+		if ((remaining_len > 0) || (mispredicted))
+			tcm_msg->predict_misses++;
+		else if (tcm_msg->payload_length > 0)
+			tcm_msg->predict_hits++;
+
+		syna_tcm_v2_update_predict_length(tcm_dev);
+	}
+
+	/* share the data to the external consumer */
 	if (tcm_dev->cb_data_duplicator[tcm_msg->status_report_code].cb) {
-		syna_tcm_buf_lock(&tcm_msg->in);
 		tcm_dev->cb_data_duplicator[tcm_msg->status_report_code].cb(
 			tcm_msg->status_report_code,
-			&tcm_msg->in.buf[MESSAGE_HEADER_SIZE],
+			&tcm_msg->rx_frame->buf[MESSAGE_HEADER_SIZE],
 			tcm_msg->payload_length,
 			tcm_dev->cb_data_duplicator[tcm_msg->status_report_code].private_data);
-		syna_tcm_buf_unlock(&tcm_msg->in);
 	}
 
 	/* process the retrieved packet */
@@ -1441,17 +1950,6 @@ static int syna_tcm_v2_process_command_write_then_read(struct tcm_dev *tcm_dev,
 	else
 		syna_tcm_v2_dispatch_response(tcm_dev, store_resp);
 
-	/* update the length for the predict reading */
-	if (do_predict) {
-		if (tcm_dev->max_rd_size == 0)
-			tcm_msg->predict_length = tcm_msg->payload_length;
-		else
-			tcm_msg->predict_length = MIN(tcm_msg->payload_length,
-				tcm_dev->max_rd_size - EXTRA_PACKET_BYTES);
-
-		if (tcm_msg->status_report_code <= REPORT_TOUCH)
-			tcm_msg->predict_length = 0;
-	}
 exit:
 	return retval;
 }
@@ -1478,8 +1976,8 @@ static int syna_tcm_v2_process_command(struct tcm_dev *tcm_dev, unsigned char co
 	struct tcm_message_data_blob *tcm_msg = NULL;
 	bool resend = false;
 	bool do_predict = false;
+	bool mispredicted = false;
 	unsigned int len = 0;
-	int len_copy;
 	int remaining_len = 0;
 	int retry = 0;
 	int timeout = 0;
@@ -1496,6 +1994,10 @@ static int syna_tcm_v2_process_command(struct tcm_dev *tcm_dev, unsigned char co
 		return -ERR_INVAL;
 	}
 
+	retval = syna_tcm_v2_prepare_rx_frame(tcm_dev);
+	if (retval < 0)
+		return retval;
+
 	/* predict reading is applied only when processing GET_REPORT command */
 	do_predict = (tcm_msg->predict_reads) && (command == CMD_GET_REPORT);
 
@@ -1515,8 +2017,8 @@ static int syna_tcm_v2_process_command(struct tcm_dev *tcm_dev, unsigned char co
 			goto exit;
 		}
 
-		if (do_predict && (tcm_msg->predict_length > 0))
-			len = tcm_msg->predict_length;
+		if (do_predict && !mispredicted)
+			len = syna_tcm_v2_get_predict_length(tcm_dev);
 
 		/* read in the immediate response */
 		timeout = 0;
@@ -1534,10 +2036,11 @@ static int syna_tcm_v2_process_command(struct tcm_dev *tcm_dev, unsigned char co
 			if ((timeout > 1) && (IS_BOOTLOADER_MODE(tcm_dev->dev_mode)))
 				syna_pal_sleep_ms(RESP_RETRY_DELAY);
 
-			retval = syna_tcm_v2_read(tcm_dev, len, syna_tcm_v2_is_mode_switching(tcm_dev, command));
+			retval = syna_tcm_v2_read(tcm_dev, 0, len, syna_tcm_v2_is_mode_switching(tcm_dev, command));
 			if (retval < 0) {
 				if ((retval == -PACKET_INVALID_PREDICT) && (tcm_msg->predict_reads)) {
-					len = syna_pal_le2_to_uint(&tcm_msg->temp.buf[1]);
+					len = syna_pal_le2_to_uint(&tcm_msg->rx_frame->buf[1]);
+					mispredicted = true;
 					continue;
 				}
 
@@ -1566,9 +2069,7 @@ static int syna_tcm_v2_process_command(struct tcm_dev *tcm_dev, unsigned char co
 		goto exit;
 	}
 
-	syna_tcm_buf_lock(&tcm_msg->temp);
-
-	header = (struct tcm_v2_message_header *)tcm_msg->temp.buf;
+	header = (struct tcm_v2_message_header *)tcm_msg->rx_frame->buf;
 
 	tcm_msg->status_report_code = header->code;
 	tcm_msg->payload_length = syna_pal_le2_to_uint(header->length);
@@ -1576,37 +2077,6 @@ static int syna_tcm_v2_process_command(struct tcm_dev *tcm_dev, unsigned char co
 	LOGD("Status code: 0x%02X, payload length: %d\n",
 		tcm_msg->status_report_code, tcm_msg->payload_length);
 
-	syna_tcm_buf_lock(&tcm_msg->in);
-
-	/* extend the internal buffer.in if needed */
-	retval = syna_tcm_buf_realloc(&tcm_msg->in, tcm_msg->payload_length + MESSAGE_HEADER_SIZE);
-	if (retval < 0) {
-		LOGE("Fail to allocate memory for internal buf_in\n");
-		syna_tcm_buf_unlock(&tcm_msg->in);
-		syna_tcm_buf_unlock(&tcm_msg->temp);
-		goto exit;
-	}
-
-	len_copy = tcm_msg->temp.data_length;
-	if (len > 0)
-		len_copy -= TCM_MSG_CRC_LENGTH;
-
-	/* copy data from internal buffer.temp to buffer.in */
-	retval = syna_pal_mem_cpy(tcm_msg->in.buf, tcm_msg->in.buf_size,
-			tcm_msg->temp.buf, tcm_msg->temp.buf_size, len_copy);
-	if (retval < 0) {
-		LOGE("Fail to copy payload to internal buf_in\n");
-		syna_tcm_buf_unlock(&tcm_msg->in);
-		syna_tcm_buf_unlock(&tcm_msg->temp);
-		goto exit;
-	}
-
-	tcm_msg->in.data_length = len_copy;
-
-	syna_tcm_buf_unlock(&tcm_msg->in);
-	syna_tcm_buf_unlock(&tcm_msg->temp);
-
-
 	remaining_len = tcm_msg->payload_length - len;
 
 	/* read in remaining payload */
@@ -1619,15 +2089,25 @@ static int syna_tcm_v2_process_command(struct tcm_dev *tcm_dev, unsigned char co
 		}
 	}
 
-	/* duplicate the data to the external buffer */
+	tcm_msg->rx_frame->data_length = MESSAGE_HEADER_SIZE + tcm_msg->payload_length;
+
+	/* update the length for the predict reading */
+	if (do_predict) {
+		if ((remaining_len > 0) || (mispredicted))
+			tcm_msg->predict_misses++;
+		else if (tcm_msg->payload_length > 0)
+			tcm_msg->predict_hits++;
+
+		syna_tcm_v2_update_predict_length(tcm_dev);
+	}
+
+	/* share the data to the external consumer */
 	if (tcm_dev->cb_data_duplicator[tcm_msg->status_report_code].cb) {
-		syna_tcm_buf_lock(&tcm_msg->in);
 		tcm_dev->cb_data_duplicator[tcm_msg->status_report_code].cb(
 			tcm_msg->status_report_code,
-			&tcm_msg->in.buf[MESSAGE_HEADER_SIZE],
+			&tcm_msg->rx_frame->buf[MESSAGE_HEADER_SIZE],
 			tcm_msg->payload_length,
 			tcm_dev->cb_data_duplicator[tcm_msg->status_report_code].private_data);
-		syna_tcm_buf_unlock(&tcm_msg->in);
 	}
 
 	/* process the retrieved packet */
@@ -1636,17 +2116,6 @@ static int syna_tcm_v2_process_command(struct tcm_dev *tcm_dev, unsigned char co
 	else
 		syna_tcm_v2_dispatch_response(tcm_dev, store_resp);
 
-	/* update the length for the predict reading */
-	if (do_predict) {
-		if (tcm_dev->max_rd_size == 0)
-			tcm_msg->predict_length = tcm_msg->payload_length;
-		else
-			tcm_msg->predict_length = MIN(tcm_msg->payload_length,
-				tcm_dev->max_rd_size - EXTRA_PACKET_BYTES);
-
-		if (tcm_msg->status_report_code <= REPORT_TOUCH)
-			tcm_msg->predict_length = 0;
-	}
 exit:
 	return retval;
 }
@@ -1705,6 +2174,63 @@ exit:
 
 	return retval;
 }
+/*
+ *  Return the time interval to poll the response of the given command.
+ *
+ *  The first poll is issued ahead of the latency learned from the previous
+ *  completions of the same command, so a faster response is observed and the
+ *  estimate is able to come down; the following polls back off from there.
+ *
+ * param
+ *    [ in] tcm_dev:         pointer to TouchComm device
+ *    [ in] command:         TouchComm command
+ *    [ in] max_interval_us: the max. time interval of polling in microseconds
+ *
+ * return
+ *    the time interval in microseconds.
+ */
+static unsigned int syna_tcm_v2_get_polling_interval(struct tcm_dev *tcm_dev,
+	unsigned char command, unsigned int max_interval_us)
+{
+	unsigned int interval_us = tcm_dev->msg_data.resp_latency_us[command];
+
+	if (interval_us == 0)
+		interval_us = POLLING_INITIAL_INTERVAL_US;
+	else
+		interval_us -= (interval_us >> RESP_LATENCY_MARGIN_SHIFT);
+
+	interval_us = MAX(interval_us, (unsigned int)POLLING_MIN_INTERVAL_US);
+
+	return MIN(interval_us, max_interval_us);
+}
+/*
+ *  Learn the latency of the given command from its completion.
+ *  The latency is tracked as an exponentially weighted moving average.
+ *
+ * param
+ *    [ in] tcm_dev:    pointer to TouchComm device
+ *    [ in] command:    TouchComm command
+ *    [ in] latency_us: time taken to retrieve the response
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_update_resp_latency(struct tcm_dev *tcm_dev,
+	unsigned char command, long long latency_us)
+{
+	unsigned int *avg_us = &tcm_dev->msg_data.resp_latency_us[command];
+
+	if (latency_us <= 0)
+		return;
+
+	if (*avg_us == 0) {
+		*avg_us = (unsigned int)latency_us;
+		return;
+	}
+
+	*avg_us = (unsigned int)((long long)*avg_us +
+		((latency_us - (long long)*avg_us) >> RESP_LATENCY_EWMA_SHIFT));
+}
 /*
  *  A block function to wait for the ATTN assertion.
  *
@@ -1730,77 +2256,92 @@ static void syna_tcm_v2_wait_for_attn(struct tcm_dev *tcm_dev, int timeout)
 		syna_pal_completion_wait_for(&tcm_dev->msg_data.cmd_completion, timeout);
 }
 /*
- *  The entry of the command processing, that includes sending a command message
- *  to device and then read in the response to the command.
+ *  Retrieve the report pending during a chunked write.
+ *
+ *  If the report interleaving is enabled and ATTN is asserted between the
+ *  CONTINUE_WRITE chunks, request the report before writing the next chunk.
+ *  Because the report is requested through the regular command flow, the
+ *  sequence bit stays in step with the device.
+ *
+ *  The caller must hold the rw_mutex.
  *
  * param
- *    [ in] tcm_dev:        pointer to TouchComm device
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_v2_interleave_report(struct tcm_dev *tcm_dev)
+{
+	int retval;
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
+	struct tcm_hw_platform *hw = tcm_dev->hw;
+	unsigned char response_code;
+
+	if (!tcm_msg->interleave_reports || !hw->ops_get_attn_level)
+		return 0;
+
+	if (hw->ops_get_attn_level(hw) != hw->attn_active_level)
+		return 0;
+
+	/* keep the response to the chunk written */
+	response_code = tcm_msg->response_code;
+
+	tcm_msg->crc_bytes = 0;
+
+	if (tcm_msg->write_then_read_support)
+		retval = syna_tcm_v2_process_command_write_then_read(tcm_dev, CMD_GET_REPORT, NULL, 0, 0, true);
+	else
+		retval = syna_tcm_v2_process_command(tcm_dev, CMD_GET_REPORT, NULL, 0, 0, true);
+	if (retval < 0) {
+		LOGE("Fail to send command CMD_GET_REPORT\n");
+		return retval;
+	}
+
+	/* the command being written shall be still in progress */
+	if (ATOMIC_GET(tcm_msg->command_status) != CMD_STATE_BUSY) {
+		LOGE("Unexpected code 0x%02X retrieved between the chunks\n",
+			tcm_msg->status_report_code);
+		return -ERR_TCMMSG;
+	}
+
+	if (IS_A_REPORT(tcm_msg->status_report_code))
+		tcm_msg->interleaved_reports++;
+
+	tcm_msg->response_code = response_code;
+
+	return 0;
+}
+/*
+ *  Send a command message to device, and separate the data payload into
+ *  several CONTINUE_WRITE transfers if the overall size is over than the
+ *  maximum write size.
+ *
+ *  The caller must hold the rw_mutex. The response to the command, except
+ *  the one returned along with the write, is not retrieved here.
+ *
+ * param
+ *    [ in] tcm_dev:        pointer to TouchComm device
  *    [ in] command:        TouchComm command
  *    [ in] payload:        data payload, if any
  *    [ in] payload_length: length of data payload, if any
- *    [out] resp_code:      response code returned
- *    [ in] resp_reading:   method to read in the response
- *                          a positive value presents the ms time delay for polling;
- *                          or, set '0' or 'RESP_IN_ATTN' for ATTN driven
+ *
  * return
  *    0 or positive value in case of success, a negative value otherwise.
  */
-static int syna_tcm_v2_write_message(struct tcm_dev *tcm_dev,
+static int syna_tcm_v2_send_message(struct tcm_dev *tcm_dev,
 	unsigned char command, unsigned char *payload,
-	unsigned int payload_length, unsigned char *resp_code,
-	unsigned int resp_reading)
+	unsigned int payload_length)
 {
-	int retval;
-	struct tcm_message_data_blob *tcm_msg = NULL;
-	syna_pal_mutex_t *cmd_mutex = NULL;
-	syna_pal_mutex_t *rw_mutex = NULL;
-	syna_pal_completion_t *cmd_completion = NULL;
-	bool in_polling = false;
-	bool irq_disabled = false;
+	int retval = 0;
 	unsigned int total_length;
 	unsigned int remaining_length;
 	unsigned int chunks;
 	unsigned int chunk_space;
 	unsigned int xfer_length;
 	unsigned int iterations = 0, offset = 0;
-	unsigned int timeout = 0;
 	bool last = false;
 
-	if (!tcm_dev) {
-		LOGE("Invalid tcm device handle\n");
-		return -ERR_INVAL;
-	}
-
-	tcm_msg = &tcm_dev->msg_data;
-	cmd_mutex = &tcm_msg->cmd_mutex;
-	rw_mutex = &tcm_msg->rw_mutex;
-	cmd_completion = &tcm_msg->cmd_completion;
-
-	if (resp_code)
-		*resp_code = STATUS_INVALID;
-
-	/* indicate which mode is used */
-	in_polling = (resp_reading != CMD_RESPONSE_IN_ATTN);
-
-	syna_pal_mutex_lock(cmd_mutex);
-
-	syna_pal_mutex_lock(rw_mutex);
-
-	ATOMIC_SET(tcm_dev->command_processing, 1);
-	ATOMIC_SET(tcm_msg->command_status, CMD_STATE_BUSY);
-
-	/* reset the command completion */
-	syna_pal_completion_reset(cmd_completion);
-
-	tcm_msg->command = command;
-
-	LOGD("Command: 0x%02x, payload size: %d  %s\n",
-		command, payload_length, (in_polling) ? "(by polling)" : "");
-
-	/* disable irq in case of polling mode */
-	if (in_polling)
-		irq_disabled = (syna_tcm_enable_irq(tcm_dev, false) > 0);
-
 	/* include the header and two bytes of CRC */
 	total_length = payload_length + MESSAGE_HEADER_SIZE;
 	if (payload_length > 0)
@@ -1845,19 +2386,329 @@ static int syna_tcm_v2_write_message(struct tcm_dev *tcm_dev,
 			}
 		}
 
+		/* retrieve the report pending between the chunks, if allowed */
+		if (iterations > 0) {
+			retval = syna_tcm_v2_interleave_report(tcm_dev);
+			if (retval < 0) {
+				LOGE("Fail to retrieve the report during command 0x%02X\n", command);
+				return retval;
+			}
+		}
+
 		retval = syna_tcm_v2_process_command(tcm_dev,
 			(iterations == 0) ? command : CMD_CONTINUE_WRITE,
 			&payload[offset], xfer_length, remaining_length, true);
 		if (retval < 0) {
 			LOGE("Fail to send command 0x%02X to device\n", command);
-			syna_pal_mutex_unlock(rw_mutex);
-			goto exit;
+			return retval;
 		}
 
 		offset += xfer_length;
 		remaining_length -= xfer_length;
 	}
 
+	return retval;
+}
+/*
+ *  Issue an asynchronous command to device.
+ *
+ *  The caller must hold the cmd_mutex, and have marked the command busy as
+ *  the one in flight. Its response will be retrieved by the ATTN-driven
+ *  read_message.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *    [ in] cmd:     the asynchronous command to issue
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_issue_async_command(struct tcm_dev *tcm_dev,
+	struct tcm_async_command *cmd)
+{
+	int retval;
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
+
+	syna_pal_mutex_lock(&tcm_msg->rw_mutex);
+
+	ATOMIC_SET(tcm_dev->command_processing, 1);
+
+	syna_pal_completion_reset(&tcm_msg->cmd_completion);
+	syna_pal_completion_reset(&tcm_msg->async_completion);
+
+	tcm_msg->command = cmd->command;
+
+	LOGD("Command: 0x%02x, payload size: %d  (async)\n",
+		cmd->command, cmd->payload_length);
+
+	retval = syna_tcm_v2_send_message(tcm_dev, cmd->command,
+			cmd->payload, cmd->payload_length);
+	if (retval < 0) {
+		cmd->status = retval;
+		ATOMIC_SET(tcm_msg->command_status, CMD_STATE_ERROR);
+		goto exit;
+	}
+
+	/* disable write-then-read operation when running bootloader command */
+	if ((cmd->command == CMD_RUN_BOOTLOADER_FIRMWARE) && (tcm_msg->response_code == STATUS_ACK))
+		tcm_msg->write_then_read_support = false;
+
+exit:
+	syna_pal_mutex_unlock(&tcm_msg->rw_mutex);
+}
+/*
+ *  Complete the asynchronous command in flight, and then restore the
+ *  state of command processing.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *    [ in] cmd:     the asynchronous command in flight
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_finish_async_command(struct tcm_dev *tcm_dev,
+	struct tcm_async_command *cmd)
+{
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
+	int state = ATOMIC_GET(tcm_msg->command_status);
+
+	cmd->resp_code = tcm_msg->response_code;
+
+	if (state == CMD_STATE_IDLE) {
+		cmd->resp_code = tcm_msg->status_report_code;
+		cmd->status = 0;
+	} else if (cmd->status == 0) {
+		if (state == CMD_STATE_TERMINATED) {
+			LOGE("Timed out wait for response of command 0x%02X\n", cmd->command);
+			cmd->status = -ERR_TIMEDOUT;
+		} else {
+			LOGE("Fail to get valid response 0x%02X of command 0x%02X\n",
+				tcm_msg->status_report_code, cmd->command);
+			cmd->status = -ERR_TCMMSG;
+		}
+	}
+
+	/* copy the response data to the caller */
+	if ((cmd->status == 0) && (cmd->resp) && IS_A_RESPONSE(cmd->resp_code)) {
+		cmd->resp->data_length = 0;
+		if (tcm_dev->resp_buf.data_length > 0) {
+			if (syna_tcm_buf_copy(cmd->resp, &tcm_dev->resp_buf) < 0) {
+				LOGE("Fail to copy resp data, status code: %x\n", cmd->resp_code);
+				cmd->status = -ERR_NOMEM;
+			}
+		}
+	}
+
+	tcm_msg->command = CMD_NONE;
+
+	ATOMIC_SET(tcm_msg->command_status, CMD_STATE_IDLE);
+	ATOMIC_SET(tcm_dev->command_processing, 0);
+}
+/*
+ *  Progress the asynchronous commands.
+ *
+ *  Complete the command in flight once its response has been retrieved, or
+ *  with a timeout status once no response arrives within the command timeout
+ *  since it was issued. Then issue the next command in the submission list.
+ *  The next command is issued only if no other command is being processed;
+ *  otherwise, it will be issued at the end of that command.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_process_async_commands(struct tcm_dev *tcm_dev)
+{
+	struct tcm_message_data_blob *tcm_msg = NULL;
+	struct tcm_async_command *cmd = NULL;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return;
+	}
+
+	tcm_msg = &tcm_dev->msg_data;
+
+	/* nothing submitted, the common case of every message read */
+	if (ATOMIC_GET(tcm_dev->async_pending) == 0)
+		return;
+
+	for (;;) {
+		/* complete the command in flight if its response was retrieved */
+		syna_pal_mutex_lock(&tcm_dev->async_mutex);
+
+		cmd = tcm_dev->async_inflight;
+		if (cmd) {
+			if (ATOMIC_GET(tcm_msg->command_status) == CMD_STATE_BUSY) {
+				if (syna_pal_time_elapsed_us(tcm_dev->async_issued) <
+					(long long)tcm_msg->command_timeout_time * 1000) {
+					syna_pal_mutex_unlock(&tcm_dev->async_mutex);
+					return;
+				}
+				/* give up the command, no response within its deadline */
+				ATOMIC_SET(tcm_msg->command_status, CMD_STATE_TERMINATED);
+			}
+			syna_tcm_v2_finish_async_command(tcm_dev, cmd);
+			tcm_dev->async_inflight = NULL;
+			ATOMIC_DEC(tcm_dev->async_pending);
+		}
+
+		syna_pal_mutex_unlock(&tcm_dev->async_mutex);
+
+		if (cmd) {
+			syna_pal_completion_complete(&tcm_msg->async_completion);
+			if (cmd->cb)
+				cmd->cb(cmd, cmd->private_data);
+		}
+
+		/* issue the next command unless another command is being processed */
+		if (!syna_pal_mutex_trylock(&tcm_msg->cmd_mutex))
+			return;
+
+		syna_pal_mutex_lock(&tcm_dev->async_mutex);
+
+		cmd = NULL;
+		if (!tcm_dev->async_inflight && tcm_dev->async_head) {
+			cmd = tcm_dev->async_head;
+			tcm_dev->async_head = cmd->next;
+			if (!tcm_dev->async_head)
+				tcm_dev->async_tail = NULL;
+			cmd->next = NULL;
+
+			/* busy from now on, so it is not taken as completed before issuing */
+			ATOMIC_SET(tcm_msg->command_status, CMD_STATE_BUSY);
+			tcm_dev->async_issued = syna_pal_get_time();
+			tcm_dev->async_inflight = cmd;
+		}
+
+		syna_pal_mutex_unlock(&tcm_dev->async_mutex);
+
+		if (cmd)
+			syna_tcm_v2_issue_async_command(tcm_dev, cmd);
+
+		syna_pal_mutex_unlock(&tcm_msg->cmd_mutex);
+
+		/* wait for the response unless the command has been completed already */
+		if (!cmd || (ATOMIC_GET(tcm_msg->command_status) == CMD_STATE_BUSY))
+			return;
+	}
+}
+/*
+ *  Wait for the completion of the asynchronous command in flight, if any.
+ *  The caller must hold the cmd_mutex, so no other command can be issued.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    void.
+ */
+static void syna_tcm_v2_wait_for_async_command(struct tcm_dev *tcm_dev)
+{
+	struct tcm_message_data_blob *tcm_msg = &tcm_dev->msg_data;
+	bool inflight;
+
+	if (ATOMIC_GET(tcm_dev->async_pending) == 0)
+		return;
+
+	syna_pal_mutex_lock(&tcm_dev->async_mutex);
+	inflight = (tcm_dev->async_inflight != NULL);
+	syna_pal_mutex_unlock(&tcm_dev->async_mutex);
+
+	if (!inflight)
+		return;
+
+	if (syna_pal_completion_wait_for(&tcm_msg->async_completion,
+		tcm_msg->command_timeout_time) == 0)
+		return;
+
+	/* give up the command in flight, and then complete it */
+	ATOMIC_SET(tcm_msg->command_status, CMD_STATE_TERMINATED);
+	syna_tcm_v2_process_async_commands(tcm_dev);
+}
+/*
+ *  The entry of the command processing, that includes sending a command message
+ *  to device and then read in the response to the command.
+ *
+ * param
+ *    [ in] tcm_dev:        pointer to TouchComm device
+ *    [ in] command:        TouchComm command
+ *    [ in] payload:        data payload, if any
+ *    [ in] payload_length: length of data payload, if any
+ *    [out] resp_code:      response code returned
+ *    [ in] resp_reading:   method to read in the response
+ *                          a positive value presents the ms time delay for polling;
+ *                          or, set '0' or 'RESP_IN_ATTN' for ATTN driven
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_v2_write_message(struct tcm_dev *tcm_dev,
+	unsigned char command, unsigned char *payload,
+	unsigned int payload_length, unsigned char *resp_code,
+	unsigned int resp_reading)
+{
+	int retval;
+	struct tcm_message_data_blob *tcm_msg = NULL;
+	syna_pal_mutex_t *cmd_mutex = NULL;
+	syna_pal_mutex_t *rw_mutex = NULL;
+	syna_pal_completion_t *cmd_completion = NULL;
+	bool in_polling = false;
+	bool irq_disabled = false;
+	syna_pal_time_t start;
+	long long elapsed_us = 0;
+	long long timeout_us;
+	long long latency_us;
+	long long missed_us = 0;
+	unsigned int interval_us = 0;
+	unsigned int max_interval_us = 0;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	tcm_msg = &tcm_dev->msg_data;
+	cmd_mutex = &tcm_msg->cmd_mutex;
+	rw_mutex = &tcm_msg->rw_mutex;
+	cmd_completion = &tcm_msg->cmd_completion;
+
+	if (resp_code)
+		*resp_code = STATUS_INVALID;
+
+	/* indicate which mode is used */
+	in_polling = (resp_reading != CMD_RESPONSE_IN_ATTN);
+
+	syna_pal_mutex_lock(cmd_mutex);
+
+	/* the asynchronous command in flight has to be completed at first */
+	syna_tcm_v2_wait_for_async_command(tcm_dev);
+
+	syna_pal_mutex_lock(rw_mutex);
+
+	ATOMIC_SET(tcm_dev->command_processing, 1);
+	ATOMIC_SET(tcm_msg->command_status, CMD_STATE_BUSY);
+
+	/* reset the command completion */
+	syna_pal_completion_reset(cmd_completion);
+
+	tcm_msg->command = command;
+
+	LOGD("Command: 0x%02x, payload size: %d  %s\n",
+		command, payload_length, (in_polling) ? "(by polling)" : "");
+
+	/* disable irq in case of polling mode */
+	if (in_polling)
+		irq_disabled = (syna_tcm_enable_irq(tcm_dev, false) > 0);
+
+	retval = syna_tcm_v2_send_message(tcm_dev, command, payload, payload_length);
+	if (retval < 0) {
+		syna_pal_mutex_unlock(rw_mutex);
+		goto exit;
+	}
+
 	syna_pal_mutex_unlock(rw_mutex);
 
 	if (tcm_msg->response_code != STATUS_ACK)
@@ -1870,14 +2721,24 @@ static int syna_tcm_v2_write_message(struct tcm_dev *tcm_dev,
 	}
 
 	/* process the command response either in polling or by ATTN */
-	timeout = 0;
+	start = syna_pal_get_time();
+	timeout_us = (long long)tcm_msg->command_timeout_time * 1000;
+
+	if (in_polling) {
+		max_interval_us = resp_reading * 1000;
+		interval_us = syna_tcm_v2_get_polling_interval(tcm_dev, command, max_interval_us);
+	}
+
 	do {
 		if (in_polling) {
-			timeout += resp_reading;
-			syna_pal_sleep_ms(resp_reading);
+			syna_pal_sleep_until(syna_pal_time_add_us(start,
+				(unsigned int)MIN(elapsed_us + interval_us, timeout_us)),
+				interval_us >> POLLING_SLACK_SHIFT);
+			/* back off exponentially if the response is not ready yet */
+			interval_us = MIN(interval_us << 1, max_interval_us);
 		} else {
-			timeout += tcm_msg->command_timeout_time >> 2;
-			syna_tcm_v2_wait_for_attn(tcm_dev, tcm_msg->command_timeout_time);
+			syna_tcm_v2_wait_for_attn(tcm_dev,
+				(int)MAX((timeout_us - elapsed_us) / 1000, 1LL));
 		}
 
 		/* stop the processing if terminated */
@@ -1889,19 +2750,26 @@ static int syna_tcm_v2_write_message(struct tcm_dev *tcm_dev,
 		/* whatever the way of processing, attempt to read in a message if not completed */
 		if (ATOMIC_GET(tcm_msg->command_status) == CMD_STATE_BUSY) {
 			retval = syna_tcm_v2_read_message(tcm_dev, NULL);
-			if (retval < 0)
+			if (retval < 0) {
+				/* a failed read counts against the deadline as well */
+				elapsed_us = syna_pal_time_elapsed_us(start);
+				missed_us = elapsed_us;
 				continue;
+			}
 		}
 
 		/* break the loop if the valid response was retrieved */
 		if (ATOMIC_GET(tcm_msg->command_status) != CMD_STATE_BUSY)
 			break;
 
-	} while (timeout < tcm_msg->command_timeout_time);
+		elapsed_us = syna_pal_time_elapsed_us(start);
+		missed_us = elapsed_us;
+
+	} while (elapsed_us < timeout_us);
 
 
 	if (ATOMIC_GET(tcm_msg->command_status) != CMD_STATE_IDLE) {
-		if (timeout >= tcm_msg->command_timeout_time) {
+		if (elapsed_us >= timeout_us) {
 			LOGE("Timed out wait for response of command 0x%02X (%dms)\n",
 				command, tcm_msg->command_timeout_time);
 			retval = -ERR_TIMEDOUT;
@@ -1913,6 +2781,13 @@ static int syna_tcm_v2_write_message(struct tcm_dev *tcm_dev,
 		goto exit;
 	}
 
+	latency_us = syna_pal_time_elapsed_us(start);
+	/* the response got ready between the last missed poll and this one */
+	if (in_polling && (missed_us > 0))
+		latency_us = (missed_us + latency_us) >> 1;
+
+	syna_tcm_v2_update_resp_latency(tcm_dev, command, latency_us);
+
 	tcm_msg->response_code = tcm_msg->status_report_code;
 	retval = 0;
 
@@ -1934,6 +2809,9 @@ exit:
 
 	syna_pal_mutex_unlock(cmd_mutex);
 
+	/* issue the asynchronous commands submitted in the meantime */
+	syna_tcm_v2_process_async_commands(tcm_dev);
+
 	return retval;
 }
 /*
@@ -1954,9 +2832,9 @@ exit:
 int syna_tcm_v2_detect(struct tcm_dev *tcm_dev, bool bypass, bool do_reset)
 {
 	int retval;
-	unsigned char *data;
 	unsigned int info_size = (unsigned int)sizeof(struct tcm_identification_info);
 	struct tcm_message_data_blob *tcm_msg = NULL;
+	struct tcm_frame_buffer *frame;
 	unsigned char resp_code = 0;
 	unsigned char command;
 
@@ -1968,25 +2846,25 @@ int syna_tcm_v2_detect(struct tcm_dev *tcm_dev, bool bypass, bool do_reset)
 	tcm_dev->msg_data.has_crc = true;
 	tcm_dev->msg_data.has_extra_rc = false;
 
+	/* prepare the tables for the crc calculation of packets */
+	syna_tcm_v2_crc16_init_table();
+
 	if (bypass)
 		goto set_ops;
 
 	tcm_msg = &tcm_dev->msg_data;
 
 	syna_pal_mutex_lock(&tcm_msg->rw_mutex);
-	syna_tcm_buf_lock(&tcm_msg->in);
 
-	retval = syna_tcm_buf_alloc(&tcm_msg->in, info_size + MESSAGE_HEADER_SIZE);
+	retval = syna_tcm_v2_prepare_rx_frame(tcm_dev);
+	if (retval >= 0)
+		retval = syna_tcm_frame_reserve(tcm_msg->rx_frame, info_size + MESSAGE_HEADER_SIZE);
 	if (retval < 0) {
-		LOGE("Fail to allocate memory for buf_in\n");
-		syna_tcm_buf_unlock(&tcm_msg->in);
+		LOGE("Fail to allocate memory for the frame buffer\n");
 		syna_pal_mutex_unlock(&tcm_msg->rw_mutex);
 		return retval;
 	}
 
-	data = tcm_msg->in.buf;
-
-	syna_tcm_buf_unlock(&tcm_msg->in);
 	syna_pal_mutex_unlock(&tcm_msg->rw_mutex);
 
 	tcm_dev->msg_data.retry_cmd_cnt = COMMAND_V2_RETRY_TIMES;
@@ -1997,7 +2875,7 @@ int syna_tcm_v2_detect(struct tcm_dev *tcm_dev, bool bypass, bool do_reset)
 	 * otherwise, send the command to identify
 	 */
 	retval = syna_tcm_v2_read_message(tcm_dev, &resp_code);
-	if ((retval < 0) || ((resp_code == STATUS_ERROR) && (tcm_msg->in.buf[3] == 0x5A))) {
+	if ((retval < 0) || ((resp_code == STATUS_ERROR) && (tcm_msg->rx_frame->buf[3] == 0x5A))) {
 		/* perhaps, the returned packet is not crc-enabled, resend the command to try */
 		tcm_dev->msg_data.has_crc = false;
 		retval = syna_tcm_v2_read_message(tcm_dev, &resp_code);
@@ -2013,11 +2891,12 @@ int syna_tcm_v2_detect(struct tcm_dev *tcm_dev, bool bypass, bool do_reset)
 
 	/* parse the identify info packet if needed */
 	if (tcm_dev->dev_mode == MODE_UNKNOWN) {
-		syna_tcm_buf_lock(&tcm_msg->in);
+		syna_pal_mutex_lock(&tcm_msg->rw_mutex);
+		frame = tcm_msg->rx_frame;
 		retval = syna_tcm_v2_parse_idinfo(tcm_dev,
-			(unsigned char *)&data[MESSAGE_HEADER_SIZE],
-			tcm_msg->in.buf_size, info_size);
-		syna_tcm_buf_unlock(&tcm_msg->in);
+			&frame->buf[MESSAGE_HEADER_SIZE],
+			frame->buf_size - MESSAGE_HEADER_SIZE, info_size);
+		syna_pal_mutex_unlock(&tcm_msg->rw_mutex);
 		if (retval < 0) {
 			LOGE("Fail to parse identify report at startup\n");
 			return -ERR_TCMMSG;
@@ -2031,10 +2910,11 @@ set_ops:
 	tcm_dev->read_message = syna_tcm_v2_read_message;
 	tcm_dev->write_message = syna_tcm_v2_write_message;
 	tcm_dev->terminate = syna_tcm_v2_terminate;
+	tcm_dev->process_async = syna_tcm_v2_process_async_commands;
 
 	tcm_dev->msg_data.retry_resp_cnt = RESPONSE_V2_RETRY_TIMES;
 
-	tcm_dev->msg_data.predict_length = 0;
+	syna_tcm_reset_predict_table(&tcm_dev->msg_data);
 	tcm_dev->protocol = TOUCHCOMM_V2;
 
 	return 0;
@@ -104,7 +104,7 @@ int syna_tcm_config_timings(struct tcm_dev *tcm_dev, struct tcm_timings *product
 		return -ERR_INVAL;
 	}
 
-	SET_TIMING(TIMINGS_TURNAROUND, product->cmd_turnaround_us, tcm_msg->command_timeout_time, "Turnaround time");
+	SET_TIMING(TIMINGS_TURNAROUND, product->cmd_turnaround_us, tcm_msg->turnaround_time, "Turnaround time");
 	SET_TIMING(TIMINGS_CMD_TIMEOUT, product->cmd_timeout_ms, tcm_msg->command_timeout_time, "Command timeout");
 	SET_TIMING(TIMINGS_CMD_POLLING, product->cmd_polling_ms, tcm_msg->command_polling_time, "Response polling time");
 	SET_TIMING(TIMINGS_CMD_RETRY, product->cmd_retry_ms, tcm_msg->command_retry_time, "Command retry time");
@@ -138,9 +138,16 @@ static int syna_tcm_init_message_handler(struct tcm_message_data_blob *tcm_msg)
 	}
 
 	/* initialize internal buffers */
-	syna_tcm_buf_init(&tcm_msg->in);
 	syna_tcm_buf_init(&tcm_msg->out);
-	syna_tcm_buf_init(&tcm_msg->temp);
+	syna_tcm_buf_init(&tcm_msg->chunk_buf[0]);
+	syna_tcm_buf_init(&tcm_msg->chunk_buf[1]);
+
+	/* initialize the pool of frame buffers for data read in */
+	if (syna_tcm_frame_pool_init(&tcm_msg->frame_pool) < 0) {
+		LOGE("Fail to initialize the pool of frame buffers\n");
+		return -ERR_INVAL;
+	}
+	tcm_msg->rx_frame = NULL;
 
 	/* allocate the completion event for command processing */
 	if (syna_pal_completion_alloc(&tcm_msg->cmd_completion) < 0) {
@@ -148,6 +155,18 @@ static int syna_tcm_init_message_handler(struct tcm_message_data_blob *tcm_msg)
 		return -ERR_INVAL;
 	}
 
+	/* allocate the completion event for the asynchronous command */
+	if (syna_pal_completion_alloc(&tcm_msg->async_completion) < 0) {
+		LOGE("Fail to allocate async completion event\n");
+		return -ERR_INVAL;
+	}
+
+	/* allocate the completion event for the pipelined chunk reads */
+	if (syna_pal_completion_alloc(&tcm_msg->chunk_completion) < 0) {
+		LOGE("Fail to allocate chunk completion event\n");
+		return -ERR_INVAL;
+	}
+
 	/* allocate the cmd_mutex for command protection */
 	if (syna_pal_mutex_alloc(&tcm_msg->cmd_mutex) < 0) {
 		LOGE("Fail to allocate cmd_mutex\n");
@@ -167,24 +186,24 @@ static int syna_tcm_init_message_handler(struct tcm_message_data_blob *tcm_msg)
 	tcm_msg->payload_length = 0;
 	tcm_msg->seq_toggle = 0;
 
-	/* allocate the internal buffer.in at first */
-	syna_tcm_buf_lock(&tcm_msg->in);
+	/* allocate the frame buffer for data read in at first */
+	tcm_msg->rx_frame = syna_tcm_frame_alloc(&tcm_msg->frame_pool);
+	if (!tcm_msg->rx_frame) {
+		LOGE("Fail to allocate the frame buffer\n");
+		return -ERR_NOMEM;
+	}
 
-	if (syna_tcm_buf_alloc(&tcm_msg->in, MESSAGE_HEADER_SIZE) < 0) {
-		LOGE("Fail to allocate memory for buf.in (size = %d)\n",
+	if (syna_tcm_frame_reserve(tcm_msg->rx_frame, MESSAGE_HEADER_SIZE) < 0) {
+		LOGE("Fail to allocate memory for frame buffer (size = %d)\n",
 			MESSAGE_HEADER_SIZE);
-		tcm_msg->in.buf_size = 0;
-		tcm_msg->in.data_length = 0;
-		syna_tcm_buf_unlock(&tcm_msg->in);
 		return -ERR_NOMEM;
 	}
-	tcm_msg->in.buf_size = MESSAGE_HEADER_SIZE;
-
-	syna_tcm_buf_unlock(&tcm_msg->in);
 
 	/* initialize the features of message handling */
 	tcm_msg->predict_reads = false;
-	tcm_msg->predict_length = 0;
+	syna_tcm_reset_predict_table(tcm_msg);
+	tcm_msg->interleave_reports = false;
+	tcm_msg->interleaved_reports = 0;
 	tcm_msg->has_crc = false;
 	tcm_msg->crc_bytes = 0;
 	tcm_msg->has_extra_rc = false;
@@ -193,7 +212,9 @@ static int syna_tcm_init_message_handler(struct tcm_message_data_blob *tcm_msg)
 	/* initialize the timings for message handling */
 	tcm_msg->command_timeout_time = CMD_RESPONSE_TIMEOUT_MS;
 	tcm_msg->command_polling_time = CMD_RESPONSE_DEFAULT_POLLING_DELAY_MS;
+	syna_pal_mem_set(tcm_msg->resp_latency_us, 0, sizeof(tcm_msg->resp_latency_us));
 	tcm_msg->turnaround_time = DELAY_TURNAROUND_US;
+	tcm_msg->turnaround_pending = false;
 	tcm_msg->command_retry_time = RETRY_MS;
 
 	return 0;
@@ -217,11 +238,18 @@ static void syna_tcm_del_message_handler(struct tcm_message_data_blob *tcm_msg)
 
 	/* release the completion event */
 	syna_pal_completion_free(&tcm_msg->cmd_completion);
+	syna_pal_completion_free(&tcm_msg->async_completion);
+	syna_pal_completion_free(&tcm_msg->chunk_completion);
 
 	/* release internal buffers  */
-	syna_tcm_buf_release(&tcm_msg->temp);
 	syna_tcm_buf_release(&tcm_msg->out);
-	syna_tcm_buf_release(&tcm_msg->in);
+	syna_tcm_buf_release(&tcm_msg->chunk_buf[0]);
+	syna_tcm_buf_release(&tcm_msg->chunk_buf[1]);
+
+	/* return the frame buffer and release the pool */
+	syna_tcm_frame_put(tcm_msg->rx_frame);
+	tcm_msg->rx_frame = NULL;
+	syna_tcm_frame_pool_release(&tcm_msg->frame_pool);
 }
 
 /*
@@ -281,6 +309,7 @@ int syna_tcm_allocate_device(struct tcm_dev **ptcm_dev_ptr,
 	tcm_dev->write_message = NULL;
 	tcm_dev->read_message = NULL;
 	tcm_dev->terminate = NULL;
+	tcm_dev->process_async = NULL;
 
 	/* initialize the capability of read write
 	 * these values may be updated after the start-up packet
@@ -296,8 +325,18 @@ int syna_tcm_allocate_device(struct tcm_dev **ptcm_dev_ptr,
 		goto err_init_mutex;
 	}
 
+	/* initialize the submission list of asynchronous commands */
+	if (syna_pal_mutex_alloc(&tcm_dev->async_mutex) < 0) {
+		LOGE("Fail to allocate async_mutex\n");
+		goto err_init_async_mutex;
+	}
+	tcm_dev->async_head = NULL;
+	tcm_dev->async_tail = NULL;
+	tcm_dev->async_inflight = NULL;
+	ATOMIC_SET(tcm_dev->async_pending, 0);
+
 	/* allocate internal buffers */
-	syna_tcm_buf_init(&tcm_dev->report_buf);
+	tcm_dev->report_frame = NULL;
 	syna_tcm_buf_init(&tcm_dev->resp_buf);
 	syna_tcm_buf_init(&tcm_dev->touch_config);
 
@@ -332,9 +371,10 @@ int syna_tcm_allocate_device(struct tcm_dev **ptcm_dev_ptr,
 
 err_init_message_handler:
 	syna_tcm_buf_release(&tcm_dev->touch_config);
-	syna_tcm_buf_release(&tcm_dev->report_buf);
 	syna_tcm_buf_release(&tcm_dev->resp_buf);
 
+	syna_pal_mutex_free(&tcm_dev->async_mutex);
+err_init_async_mutex:
 	syna_pal_mutex_free(&tcm_dev->irq_en_mutex);
 err_init_mutex:
 	tcm_dev->hw = NULL;
@@ -361,14 +401,20 @@ void syna_tcm_remove_device(struct tcm_dev *tcm_dev)
 		return;
 	}
 
+	/* return the frame of latest report before the pool is removed */
+	syna_tcm_frame_put(tcm_dev->report_frame);
+	tcm_dev->report_frame = NULL;
+
 	/* release the command interface */
 	syna_tcm_del_message_handler(&tcm_dev->msg_data);
 
 	/* release resources */
+	if (tcm_dev->touch_plan.ops)
+		syna_pal_mem_free((void *)tcm_dev->touch_plan.ops);
 	syna_tcm_buf_release(&tcm_dev->touch_config);
-	syna_tcm_buf_release(&tcm_dev->report_buf);
 	syna_tcm_buf_release(&tcm_dev->resp_buf);
 
+	syna_pal_mutex_free(&tcm_dev->async_mutex);
 	syna_pal_mutex_free(&tcm_dev->irq_en_mutex);
 
 	tcm_dev->parent = NULL;
@@ -415,10 +461,11 @@ int syna_tcm_detect_device(struct tcm_dev *tcm_dev, unsigned int mode, bool rese
 	case PROTOCOL_DETECT_VERSION_1:
 #ifdef TOUCHCOMM_VERSION_1
 		if (syna_tcm_v1_detect(tcm_dev, bypass, reset_to_detect) < 0) {
-			if (tcm_dev->msg_data.in.buf_size > 0) {
+			if ((tcm_dev->msg_data.rx_frame) &&
+				(tcm_dev->msg_data.rx_frame->buf_size >= MESSAGE_HEADER_SIZE)) {
 				LOGE("Fail to detect TouchComm v1 device, %02x %02x %02x %02x ...\n",
-					tcm_dev->msg_data.in.buf[0], tcm_dev->msg_data.in.buf[1],
-					tcm_dev->msg_data.in.buf[2], tcm_dev->msg_data.in.buf[3]);
+					tcm_dev->msg_data.rx_frame->buf[0], tcm_dev->msg_data.rx_frame->buf[1],
+					tcm_dev->msg_data.rx_frame->buf[2], tcm_dev->msg_data.rx_frame->buf[3]);
 			}
 			return -ERR_NODEV;
 		}
@@ -430,10 +477,11 @@ int syna_tcm_detect_device(struct tcm_dev *tcm_dev, unsigned int mode, bool rese
 	case PROTOCOL_DETECT_VERSION_2:
 #ifdef TOUCHCOMM_VERSION_2
 		if (syna_tcm_v2_detect(tcm_dev, bypass, reset_to_detect) < 0) {
-			if (tcm_dev->msg_data.in.buf_size > 0) {
+			if ((tcm_dev->msg_data.rx_frame) &&
+				(tcm_dev->msg_data.rx_frame->buf_size >= MESSAGE_HEADER_SIZE)) {
 				LOGE("Fail to detect TouchComm v2 device, %02x %02x %02x %02x ...\n",
-					tcm_dev->msg_data.in.buf[0], tcm_dev->msg_data.in.buf[1],
-					tcm_dev->msg_data.in.buf[2], tcm_dev->msg_data.in.buf[3]);
+					tcm_dev->msg_data.rx_frame->buf[0], tcm_dev->msg_data.rx_frame->buf[1],
+					tcm_dev->msg_data.rx_frame->buf[2], tcm_dev->msg_data.rx_frame->buf[3]);
 			}
 			return -ERR_NODEV;
 		}
@@ -497,6 +545,67 @@ int syna_tcm_detect_device(struct tcm_dev *tcm_dev, unsigned int mode, bool rese
 	return tcm_dev->dev_mode;
 }
 
+/*
+ *  Helper to copy the payload of the latest report to the given buffer.
+ *  The frame of report is held during the copy, so it won't be recycled.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *    [out] dest:    buffer to store the payload
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_copy_report_frame(struct tcm_dev *tcm_dev,
+	struct tcm_buffer *dest)
+{
+	int retval = 0;
+	struct tcm_frame_pool *pool = &tcm_dev->msg_data.frame_pool;
+	struct tcm_frame_buffer *frame;
+	unsigned int payload_size;
+
+	syna_pal_mutex_lock(&pool->pool_mutex);
+	frame = syna_tcm_frame_get(tcm_dev->report_frame);
+	syna_pal_mutex_unlock(&pool->pool_mutex);
+
+	if (!frame || (frame->data_length <= MESSAGE_HEADER_SIZE))
+		goto exit;
+
+	payload_size = frame->data_length - MESSAGE_HEADER_SIZE;
+
+	syna_tcm_buf_lock(dest);
+
+	if (dest->buf_size < payload_size) {
+		retval = syna_tcm_buf_alloc(dest, payload_size);
+		if (retval < 0) {
+			LOGE("Fail to allocate memory for report copy, size: %d\n",
+				payload_size);
+			syna_tcm_buf_unlock(dest);
+			goto exit;
+		}
+	}
+
+	retval = syna_pal_mem_cpy(dest->buf,
+			dest->buf_size,
+			&frame->buf[MESSAGE_HEADER_SIZE],
+			frame->buf_size - MESSAGE_HEADER_SIZE,
+			payload_size);
+	if (retval < 0) {
+		LOGE("Fail to copy the report data, size: %d\n", payload_size);
+		syna_tcm_buf_unlock(dest);
+		goto exit;
+	}
+
+	dest->data_length = payload_size;
+
+	syna_tcm_buf_unlock(dest);
+
+exit:
+	syna_tcm_frame_put(frame);
+
+	return retval;
+}
+
 /*
  *  Helper to read out TouchComm messages when ATTN is asserted.
  *  After returning, the ATTN signal should be no longer asserted.
@@ -529,6 +638,11 @@ int syna_tcm_get_event_data(struct tcm_dev *tcm_dev, unsigned char *code,
 
 	/* retrieve the event data */
 	retval = tcm_dev->read_message(tcm_dev, code);
+
+	/* complete the asynchronous command if its response was retrieved */
+	if (tcm_dev->process_async)
+		tcm_dev->process_async(tcm_dev);
+
 	if (retval < 0) {
 		LOGE("Fail to read messages\n");
 		return retval;
@@ -540,10 +654,7 @@ int syna_tcm_get_event_data(struct tcm_dev *tcm_dev, unsigned char *code,
 
 	/* if gathering a report, copy to the user buffer */
 	if ((*code >= REPORT_IDENTIFY) && (*code != STATUS_INVALID)) {
-		if (tcm_dev->report_buf.data_length == 0)
-			goto exit;
-
-		retval = syna_tcm_buf_copy(data, &tcm_dev->report_buf);
+		retval = syna_tcm_copy_report_frame(tcm_dev, data);
 		if (retval < 0) {
 			LOGE("Fail to copy data, report type: %x\n", *code);
 			goto exit;
@@ -1990,8 +2101,8 @@ int syna_tcm_send_command(struct tcm_dev *tcm_dev, unsigned char command,
 		goto exit;
 
 	/* if gathering a report, copy to the user buffer */
-	if (IS_A_REPORT(resp_code) && (tcm_dev->report_buf.data_length > 0)) {
-		if (syna_tcm_buf_copy(resp, &tcm_dev->report_buf) < 0) {
+	if (IS_A_REPORT(resp_code)) {
+		if (syna_tcm_copy_report_frame(tcm_dev, resp) < 0) {
 			LOGE("Fail to copy data, report type: %x\n", resp_code);
 			retval = -ERR_NOMEM;
 			goto exit;
@@ -2008,6 +2119,143 @@ int syna_tcm_send_command(struct tcm_dev *tcm_dev, unsigned char command,
 exit:
 	return retval;
 }
+/*
+ *  Helper to submit a command without waiting for its response.
+ *
+ *  The command is queued in the submission list, and issued as soon as no
+ *  other command is being processed. Once the response is retrieved by the
+ *  ATTN-driven syna_tcm_get_event_data(), the result is stored in the given
+ *  context and the completion callback is invoked.
+ *
+ *  If the platform doesn't support ATTN, the command is processed by polling
+ *  before returning, and the callback is invoked at the end.
+ *
+ * param
+ *    [ in] tcm_dev:       pointer to TouchComm device
+ *    [ in] cmd:           context of the command, which shall remain valid
+ *                         until the completion callback is invoked
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_send_command_async(struct tcm_dev *tcm_dev,
+	struct tcm_async_command *cmd)
+{
+	int retval = 0;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	if (!cmd) {
+		LOGE("Invalid command context\n");
+		return -ERR_INVAL;
+	}
+
+	if ((cmd->payload_length > 0) && (!cmd->payload)) {
+		LOGE("Invalid data payload of command 0x%02x\n", cmd->command);
+		return -ERR_INVAL;
+	}
+
+	if (!tcm_dev->process_async) {
+		LOGE("Invalid TouchComm R/W operations\n");
+		return -ERR_NODEV;
+	}
+
+	cmd->resp_code = STATUS_INVALID;
+	cmd->status = 0;
+	cmd->next = NULL;
+
+	if (!tcm_dev->hw->support_attn) {
+		LOGN("No support of IRQ control, process command 0x%02x synchronously\n",
+			cmd->command);
+
+		retval = syna_tcm_send_command(tcm_dev,
+				cmd->command,
+				cmd->payload,
+				cmd->payload_length,
+				&cmd->resp_code,
+				cmd->resp,
+				tcm_dev->msg_data.command_polling_time);
+
+		cmd->status = (retval < 0) ? retval : 0;
+		if (cmd->cb)
+			cmd->cb(cmd, cmd->private_data);
+
+		return retval;
+	}
+
+	/* append to the submission list */
+	syna_pal_mutex_lock(&tcm_dev->async_mutex);
+
+	ATOMIC_INC(tcm_dev->async_pending);
+
+	if (tcm_dev->async_tail)
+		tcm_dev->async_tail->next = cmd;
+	else
+		tcm_dev->async_head = cmd;
+	tcm_dev->async_tail = cmd;
+
+	syna_pal_mutex_unlock(&tcm_dev->async_mutex);
+
+	LOGD("Command 0x%02x submitted, payload size: %d\n",
+		cmd->command, cmd->payload_length);
+
+	/* issue the command if the device is free to process */
+	tcm_dev->process_async(tcm_dev);
+
+	return retval;
+}
+/*
+ *  Helper to progress the asynchronous commands without an ATTN.
+ *
+ *  The command in flight is completed with -ERR_TIMEDOUT once its deadline
+ *  has passed, so a response that never arrives doesn't hold up the commands
+ *  submitted after it. The caller is expected to call again after the time
+ *  returned.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    the time in ms to check again, 0 if no command is pending,
+ *    or a negative value in case of failure.
+ */
+int syna_tcm_check_async_command(struct tcm_dev *tcm_dev)
+{
+	int retval = 0;
+	unsigned int timeout_ms;
+	long long elapsed_ms;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	if (!tcm_dev->process_async) {
+		LOGE("Invalid TouchComm R/W operations\n");
+		return -ERR_NODEV;
+	}
+
+	tcm_dev->process_async(tcm_dev);
+
+	timeout_ms = tcm_dev->msg_data.command_timeout_time;
+
+	syna_pal_mutex_lock(&tcm_dev->async_mutex);
+
+	if (tcm_dev->async_inflight) {
+		elapsed_ms = syna_pal_time_elapsed_us(tcm_dev->async_issued) / 1000;
+		retval = (elapsed_ms < timeout_ms) ? (int)(timeout_ms - elapsed_ms) : 1;
+	} else if (tcm_dev->async_head) {
+		/* issued at the end of the command being processed */
+		retval = (timeout_ms > 0) ? (int)timeout_ms : 1;
+	}
+
+	syna_pal_mutex_unlock(&tcm_dev->async_mutex);
+
+	return retval;
+}
 
 /*
  *  Helper to configure the current read size.
@@ -2136,6 +2384,9 @@ exit:
  *  In contrast to the predict reading, standard reads typically require two
  *  transfers for the header and the payload data.
  *
+ *  The length to read is learned from the packets observed for each report
+ *  and for the response to each command respectively.
+ *
  * param
  *    [ in] tcm_dev: pointer to TouchComm device
  *    [ in] en:      '1' to low power deep sleep mode; '0' to active mode
@@ -2150,14 +2401,99 @@ int syna_tcm_enable_predict_reading(struct tcm_dev *tcm_dev, bool en)
 		return -ERR_INVAL;
 	}
 
+	syna_pal_mutex_lock(&tcm_dev->msg_data.rw_mutex);
+
 	tcm_dev->msg_data.predict_reads = en;
-	tcm_dev->msg_data.predict_length = 0;
+	syna_tcm_reset_predict_table(&tcm_dev->msg_data);
+
+	syna_pal_mutex_unlock(&tcm_dev->msg_data.rw_mutex);
 
 	LOGI("Predicted reading is %s\n", (en) ? "enabled":"disabled");
 
 	return 0;
 }
 
+/*
+ *  Retrieve the statistics of predict reading, and clear them if requested.
+ *
+ *  The statistics are updated along with the packets read, so they are
+ *  accessed under the same lock.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *    [out] hits:    packets retrieved entirely in one transaction
+ *    [out] misses:  packets requiring an additional transaction
+ *    [ in] clear:   true to clear the statistics after reading
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_get_predict_stats(struct tcm_dev *tcm_dev, unsigned int *hits,
+	unsigned int *misses, bool clear)
+{
+	struct tcm_message_data_blob *tcm_msg;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	tcm_msg = &tcm_dev->msg_data;
+
+	syna_pal_mutex_lock(&tcm_msg->rw_mutex);
+
+	if (hits)
+		*hits = tcm_msg->predict_hits;
+	if (misses)
+		*misses = tcm_msg->predict_misses;
+
+	if (clear) {
+		tcm_msg->predict_hits = 0;
+		tcm_msg->predict_misses = 0;
+	}
+
+	syna_pal_mutex_unlock(&tcm_msg->rw_mutex);
+
+	return 0;
+}
+
+/*
+ *  Enable the feature of report interleaving.
+ *
+ *  A long command is written in several CONTINUE_WRITE chunks. If enabled,
+ *  a report pending during the write is retrieved between the chunks, so the
+ *  touch reporting is not stalled until the end of the write.
+ *
+ *  The feature relies on the level of ATTN signal, which shall be provided
+ *  by the hardware interface.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *    [ in] en:      '1' to enable; '0' to disable
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_enable_report_interleaving(struct tcm_dev *tcm_dev, bool en)
+{
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	if (en && !tcm_dev->hw->ops_get_attn_level) {
+		LOGE("No support of ATTN level reading\n");
+		return -ERR_NODEV;
+	}
+
+	tcm_dev->msg_data.interleave_reports = en;
+	tcm_dev->msg_data.interleaved_reports = 0;
+
+	LOGI("Report interleaving is %s\n", (en) ? "enabled":"disabled");
+
+	return 0;
+}
+
 /*
  *  Register callback function to handle the particular report.
  *
@@ -2258,6 +2594,137 @@ void syna_tcm_clear_command_processing(struct tcm_dev *tcm_dev)
 	tcm_dev->terminate(tcm_dev);
 }
 
+/*
+ *  Hold the frame buffer of the message being processed.
+ *
+ *  The function is supposed to be called within the callbacks of data
+ *  duplicator or report dispatcher, where the data given points into this
+ *  frame. The frame stays valid until syna_tcm_release_frame() is called.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    pointer to the frame buffer held, or NULL if no frame available.
+ */
+struct tcm_frame_buffer *syna_tcm_hold_frame(struct tcm_dev *tcm_dev)
+{
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return NULL;
+	}
+
+	return syna_tcm_frame_get(tcm_dev->msg_data.rx_frame);
+}
+
+/*
+ *  Release the frame buffer held by syna_tcm_hold_frame().
+ *
+ * param
+ *    [ in] frame: pointer to the frame buffer
+ *
+ * return
+ *    none
+ */
+void syna_tcm_release_frame(struct tcm_frame_buffer *frame)
+{
+	syna_tcm_frame_put(frame);
+}
+
+/*
+ *  Configure the pool of frame buffers for the consumer holding the frames.
+ *
+ *  The pool keeps up to the given number of idle frames for reuse, and each
+ *  frame comes with a private area of the given size, see the structure
+ *  tcm_frame_buffer. Frames already allocated without enough private area
+ *  are dropped, rather than reused, once they are put back.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] idle_frames: number of idle frames kept in the pool
+ *    [ in] priv_size:   size of private area required in each frame
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_set_frame_pool(struct tcm_dev *tcm_dev, unsigned int idle_frames,
+	unsigned int priv_size)
+{
+	int retval = 0;
+	struct tcm_message_data_blob *tcm_msg;
+	struct tcm_frame_pool *pool;
+	struct tcm_frame_buffer *frame;
+	struct tcm_frame_buffer *stale = NULL;
+	struct tcm_frame_buffer **link;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	tcm_msg = &tcm_dev->msg_data;
+	pool = &tcm_msg->frame_pool;
+
+	/* no frame is being read in while the pool is changed */
+	syna_pal_mutex_lock(&tcm_msg->rw_mutex);
+
+	syna_pal_mutex_lock(&pool->pool_mutex);
+
+	pool->max_idle = idle_frames;
+	pool->priv_size = priv_size;
+
+	/* take out the idle frames which can no longer be reused */
+	link = &pool->idle;
+	while (*link) {
+		frame = *link;
+		if ((pool->num_idle > pool->max_idle) ||
+			(frame->priv_size < pool->priv_size)) {
+			*link = frame->next;
+			pool->num_idle--;
+			frame->next = stale;
+			stale = frame;
+		} else {
+			link = &frame->next;
+		}
+	}
+
+	syna_pal_mutex_unlock(&pool->pool_mutex);
+
+	while (stale) {
+		frame = stale;
+		stale = frame->next;
+
+		syna_pal_mem_free((void *)frame->buf);
+		syna_pal_mem_free((void *)frame);
+	}
+
+	/* the frame reading in next shall come with the private area as well */
+	if (tcm_msg->rx_frame && (tcm_msg->rx_frame->priv_size < priv_size)) {
+		syna_tcm_frame_put(tcm_msg->rx_frame);
+
+		tcm_msg->rx_frame = syna_tcm_frame_alloc(pool);
+		if (!tcm_msg->rx_frame) {
+			LOGE("Fail to allocate the frame buffer\n");
+			retval = -ERR_NOMEM;
+			goto exit;
+		}
+
+		retval = syna_tcm_frame_reserve(tcm_msg->rx_frame, MESSAGE_HEADER_SIZE);
+		if (retval < 0) {
+			LOGE("Fail to allocate memory for frame buffer (size = %d)\n",
+				MESSAGE_HEADER_SIZE);
+			goto exit;
+		}
+	}
+
+	LOGD("Frame pool, idle frames:%d, private size:%d\n", idle_frames, priv_size);
+
+exit:
+	syna_pal_mutex_unlock(&tcm_msg->rw_mutex);
+
+	return retval;
+}
+
 /*
  *  Register callback function to perform the post reset
  *
@@ -403,6 +403,34 @@ int syna_tcm_reset_smart_bridge(struct tcm_dev *tcm_dev, unsigned int resp_readi
 int syna_tcm_send_command(struct tcm_dev *tcm_dev, unsigned char command,
 	unsigned char *payload, unsigned int payload_length, unsigned char *code,
 	struct tcm_buffer *resp, unsigned int delay_ms_resp);
+/*
+ *  Helper to submit a command without waiting for its response.
+ *  The completion callback in the context is invoked once the response
+ *  is retrieved.
+ *
+ * param
+ *    [ in] tcm_dev:       pointer to TouchComm device
+ *    [ in] cmd:           context of the command, which shall remain valid
+ *                         until the completion callback is invoked
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_send_command_async(struct tcm_dev *tcm_dev,
+	struct tcm_async_command *cmd);
+/*
+ *  Helper to progress the asynchronous commands without an ATTN.
+ *  The command in flight is completed with a timeout status once its
+ *  deadline has passed.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    the time in ms to check again, 0 if no command is pending,
+ *    or a negative value in case of failure.
+ */
+int syna_tcm_check_async_command(struct tcm_dev *tcm_dev);
 
 /*
  *  Helper to configure the current read size.
@@ -445,6 +473,9 @@ int syna_tcm_set_max_write_size(struct tcm_dev *tcm_dev, unsigned int wr_size, u
  *  In contrast to the predict reading, standard reads typically require two
  *  transfers for the header and the payload data.
  *
+ *  The length to read is learned from the packets observed for each report
+ *  and for the response to each command respectively.
+ *
  * param
  *    [ in] tcm_dev: pointer to TouchComm device
  *    [ in] en:      '1' to low power deep sleep mode; '0' to active mode
@@ -454,6 +485,36 @@ int syna_tcm_set_max_write_size(struct tcm_dev *tcm_dev, unsigned int wr_size, u
  */
 int syna_tcm_enable_predict_reading(struct tcm_dev *tcm_dev, bool en);
 
+/*
+ *  Retrieve the statistics of predict reading, and clear them if requested.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *    [out] hits:    packets retrieved entirely in one transaction
+ *    [out] misses:  packets requiring an additional transaction
+ *    [ in] clear:   true to clear the statistics after reading
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_get_predict_stats(struct tcm_dev *tcm_dev, unsigned int *hits,
+	unsigned int *misses, bool clear);
+
+/*
+ *  Enable the feature of report interleaving.
+ *
+ *  If enabled, a report pending during a long write is retrieved between
+ *  the CONTINUE_WRITE chunks rather than after the entire write.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *    [ in] en:      '1' to enable; '0' to disable
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_enable_report_interleaving(struct tcm_dev *tcm_dev, bool en);
+
 /*
  *  Terminate the command processing.
  *
@@ -465,6 +526,51 @@ int syna_tcm_enable_predict_reading(struct tcm_dev *tcm_dev, bool en);
  */
 void syna_tcm_clear_command_processing(struct tcm_dev *tcm_dev);
 
+/*
+ *  Hold the frame buffer of the message being processed.
+ *
+ *  The function is supposed to be called within the callbacks of data
+ *  duplicator or report dispatcher, where the data given points into this
+ *  frame. The frame stays valid until syna_tcm_release_frame() is called.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    pointer to the frame buffer held, or NULL if no frame available.
+ */
+struct tcm_frame_buffer *syna_tcm_hold_frame(struct tcm_dev *tcm_dev);
+
+/*
+ *  Release the frame buffer held by syna_tcm_hold_frame().
+ *
+ * param
+ *    [ in] frame: pointer to the frame buffer
+ *
+ * return
+ *    none
+ */
+void syna_tcm_release_frame(struct tcm_frame_buffer *frame);
+
+/*
+ *  Configure the pool of frame buffers for the consumer holding the frames.
+ *
+ *  The pool keeps up to the given number of idle frames for reuse, and each
+ *  frame comes with a private area of the given size, see the structure
+ *  tcm_frame_buffer. Frames already allocated without enough private area
+ *  are dropped, rather than reused, once they are put back.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] idle_frames: number of idle frames kept in the pool
+ *    [ in] priv_size:   size of private area required in each frame
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_set_frame_pool(struct tcm_dev *tcm_dev, unsigned int idle_frames,
+	unsigned int priv_size);
+
 
 /*
  * Helpers to set up callbacks
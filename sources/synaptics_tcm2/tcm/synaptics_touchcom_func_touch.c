@@ -52,15 +52,6 @@
 int syna_tcm_get_touch_data(const unsigned char *report, unsigned int size,
 	unsigned int offset, unsigned int bits, unsigned int *data)
 {
-	unsigned char mask;
-	unsigned char byte_data;
-	unsigned int output_data;
-	unsigned int bit_offset;
-	unsigned int byte_offset;
-	unsigned int data_bits;
-	unsigned int available_bits;
-	unsigned int remaining_bits;
-
 	if (bits == 0 || bits > 32) {
 		LOGE("Invalid number of bits %d\n", bits);
 		return -ERR_INVAL;
@@ -71,35 +62,7 @@ int syna_tcm_get_touch_data(const unsigned char *report, unsigned int size,
 		return -ERR_INVAL;
 	}
 
-	if (offset + bits > size * 8) {
-		*data = 0;
-		return 0;
-	}
-
-	output_data = 0;
-	remaining_bits = bits;
-
-	bit_offset = offset % 8;
-	byte_offset = offset / 8;
-
-	while (remaining_bits) {
-		byte_data = report[byte_offset];
-		byte_data >>= bit_offset;
-
-		available_bits = 8 - bit_offset;
-		data_bits = MIN(available_bits, remaining_bits);
-		mask = 0xff >> (8 - data_bits);
-
-		byte_data &= mask;
-
-		output_data |= byte_data << (bits - remaining_bits);
-
-		bit_offset = 0;
-		byte_offset += 1;
-		remaining_bits -= data_bits;
-	}
-
-	*data = output_data;
+	*data = syna_tcm_get_touch_bits(report, size, offset, bits);
 
 	return 0;
 }
@@ -121,7 +84,6 @@ static int syna_tcm_get_knob_data(const unsigned char *report,
 	unsigned int report_size, unsigned int offset, unsigned int bits,
 	struct tcm_knob_data_blob *knob_data)
 {
-	int retval;
 	unsigned int idx;
 	unsigned int data;
 	unsigned int data_length = 16;
@@ -141,12 +103,7 @@ static int syna_tcm_get_knob_data(const unsigned char *report,
 		if (bits - data_length <= 0)
 			continue;
 
-		retval = syna_tcm_get_touch_data(report, report_size,
-				offset, data_length, &data);
-		if (retval < 0) {
-			LOGE("Fail to get knob angle\n");
-			return retval;
-		}
+		data = syna_tcm_get_touch_bits(report, report_size, offset, data_length);
 		if (knob_data[idx].angle != (unsigned short)data) {
 			knob_data[idx].angle = (unsigned short)data;
 			knob_data[idx].is_updated = true;
@@ -157,12 +114,7 @@ static int syna_tcm_get_knob_data(const unsigned char *report,
 
 		if (bits - data_length <= 0)
 			continue;
-		retval = syna_tcm_get_touch_data(report, report_size,
-				offset, data_length, &data);
-		if (retval < 0) {
-			LOGE("Fail to get knob click data\n");
-			return retval;
-		}
+		data = syna_tcm_get_touch_bits(report, report_size, offset, data_length);
 		if (knob_data[idx].click != (unsigned short)data) {
 			knob_data[idx].click = (unsigned short)data;
 			knob_data[idx].is_clicked = true;
@@ -173,12 +125,7 @@ static int syna_tcm_get_knob_data(const unsigned char *report,
 
 		if (bits - data_length <= 0)
 			continue;
-		retval = syna_tcm_get_touch_data(report, report_size,
-				offset, data_length, &data);
-		if (retval < 0) {
-			LOGE("Fail to get knob grasp data\n");
-			return retval;
-		}
+		data = syna_tcm_get_touch_bits(report, report_size, offset, data_length);
 		if (knob_data[idx].grasp != (unsigned short)data) {
 			knob_data[idx].grasp = (unsigned short)data;
 			knob_data[idx].is_updated = true;
@@ -212,7 +159,6 @@ static int syna_tcm_get_gesture_data(const unsigned char *report,
 	unsigned int report_size, unsigned int offset, unsigned int bits,
 	struct tcm_gesture_data_blob *gesture_data, unsigned int gesture_id)
 {
-	int retval;
 	unsigned int idx;
 	unsigned int data;
 	unsigned int size;
@@ -232,12 +178,7 @@ static int syna_tcm_get_gesture_data(const unsigned char *report,
 
 	idx = 0;
 	while ((offset < data_end) && (idx < size)) {
-		retval = syna_tcm_get_touch_data(report, report_size,
-				offset, 16, &data);
-		if (retval < 0) {
-			LOGE("Fail to get gesture data %d\n", idx);
-			return retval;
-		}
+		data = syna_tcm_get_touch_bits(report, report_size, offset, 16);
 		gesture_data->data[idx++] = (unsigned char)(data & 0xff);
 		gesture_data->data[idx++] = (unsigned char)((data >> 8) & 0xff);
 		offset += 16;
@@ -267,87 +208,669 @@ static int syna_tcm_get_gesture_data(const unsigned char *report,
 	return 0;
 }
 
+/* results of the end of an object in the touch report parse plan */
+#define TOUCH_PLAN_STOP (-1)
+#define TOUCH_PLAN_LEAVE_LOOP (0)
+#define TOUCH_PLAN_NEXT_OBJECT (1)
+
+/* running state of the touch report parse plan */
+struct tcm_touch_parse_state {
+	unsigned int offset;
+	unsigned int obj;
+	unsigned int objects;
+	unsigned int active_objects;
+	bool num_of_active_objects;
+};
+
 /*
- *  Traverse through touch report configuration and parse the contents of
- *  report packet to get the exactly touched data entity from touch reports.
+ *  Translate a touch entity into the operation of parse plan.
  *
- *  At the end of function, the touched data will be parsed and stored at the
- *  associated fields inside the structure touch_data_blob.
+ * param
+ *    [ in] plan: the parse plan being compiled
+ *    [out] op:   the operation to fill
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_compile_touch_entity(struct tcm_touch_parse_plan *plan,
+	struct tcm_touch_parse_op *op)
+{
+	switch (op->code) {
+	case TOUCH_REPORT_TIMESTAMP:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, timestamp);
+		break;
+	case TOUCH_REPORT_OBJECT_N_INDEX:
+		op->type = TOUCH_PARSE_OP_OBJ_INDEX;
+		break;
+	case TOUCH_REPORT_OBJECT_N_CLASSIFICATION:
+		op->type = TOUCH_PARSE_OP_OBJ_STATUS;
+		break;
+	case TOUCH_REPORT_OBJECT_N_X_POSITION:
+		op->type = TOUCH_PARSE_OP_OBJ_FIELD;
+		op->dest = offsetof(struct tcm_objects_data_blob, x_pos);
+		break;
+	case TOUCH_REPORT_OBJECT_N_Y_POSITION:
+		op->type = TOUCH_PARSE_OP_OBJ_FIELD;
+		op->dest = offsetof(struct tcm_objects_data_blob, y_pos);
+		break;
+	case TOUCH_REPORT_OBJECT_N_Z:
+		op->type = TOUCH_PARSE_OP_OBJ_EXT_FIELD;
+		op->dest = offsetof(struct tcm_objects_ext_data_blob, z);
+		break;
+	case TOUCH_REPORT_OBJECT_N_X_WIDTH:
+		op->type = TOUCH_PARSE_OP_OBJ_FIELD;
+		op->dest = offsetof(struct tcm_objects_data_blob, x_width);
+		break;
+	case TOUCH_REPORT_OBJECT_N_Y_WIDTH:
+		op->type = TOUCH_PARSE_OP_OBJ_FIELD;
+		op->dest = offsetof(struct tcm_objects_data_blob, y_width);
+		break;
+	case TOUCH_REPORT_OBJECT_N_TX_POSITION_TIXELS:
+		op->type = TOUCH_PARSE_OP_OBJ_EXT_FIELD;
+		op->dest = offsetof(struct tcm_objects_ext_data_blob, tx_pos);
+		break;
+	case TOUCH_REPORT_OBJECT_N_RX_POSITION_TIXELS:
+		op->type = TOUCH_PARSE_OP_OBJ_EXT_FIELD;
+		op->dest = offsetof(struct tcm_objects_ext_data_blob, rx_pos);
+		break;
+	case TOUCH_REPORT_NUM_OF_ACTIVE_OBJECTS:
+		op->type = TOUCH_PARSE_OP_NUM_ACTIVE;
+		break;
+	case TOUCH_REPORT_0D_BUTTONS_STATE:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, buttons_state);
+		break;
+	case TOUCH_REPORT_GESTURE_ID:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, gesture_id);
+		plan->has_gesture = true;
+		break;
+	case TOUCH_REPORT_GESTURE_DATA:
+		op->type = TOUCH_PARSE_OP_GESTURE_DATA;
+		plan->has_gesture = true;
+		return 0;
+	case TOUCH_REPORT_FRAME_RATE:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, frame_rate);
+		break;
+	case TOUCH_REPORT_FORCE_MEASUREMENT:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, force_data);
+		break;
+	case TOUCH_REPORT_FINGERPRINT_AREA_MEET:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, fingerprint_area_meet);
+		break;
+	case TOUCH_REPORT_POWER_IM:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, power_im);
+		break;
+	case TOUCH_REPORT_CID_IM:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, cid_im);
+		break;
+	case TOUCH_REPORT_RAIL_IM:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, rail_im);
+		break;
+	case TOUCH_REPORT_CID_VARIANCE_IM:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, cid_variance_im);
+		break;
+	case TOUCH_REPORT_SENSING_FREQUENCY_INDEX:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, nsm_frequency);
+		break;
+	case TOUCH_REPORT_NSM_STATE:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, nsm_state);
+		break;
+	case TOUCH_REPORT_CPU_CYCLES_USED_SINCE_LAST_FRAME:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, num_of_cpu_cycles);
+		break;
+	case TOUCH_REPORT_FACE_DETECT:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, fd_data);
+		break;
+	case TOUCH_REPORT_SENSING_MODE:
+		op->type = TOUCH_PARSE_OP_FIELD;
+		op->dest = offsetof(struct tcm_touch_data_blob, sensing_mode);
+		break;
+#ifdef TOUCHCOMM_TDDI
+	case TOUCH_REPORT_KNOB_DATA:
+		op->type = TOUCH_PARSE_OP_KNOB_DATA;
+		return 0;
+	case TOUCH_REPORT_KNOB_CALIB:
+		op->type = TOUCH_PARSE_OP_SKIP;
+		return 0;
+#endif
+	default:
+		/* skipped unless a custom parsing method is registered */
+		LOGD("Custom touch entity:0x%02x (size:%d)\n", op->code, op->bits);
+		op->type = TOUCH_PARSE_OP_SKIP;
+		plan->has_custom = true;
+		return 0;
+	}
+
+	if ((op->bits == 0) || (op->bits > 32)) {
+		LOGE("Invalid number of bits %d for entity 0x%02x\n", op->bits, op->code);
+		return -ERR_INVAL;
+	}
+
+	return 0;
+}
+
+/*
+ *  Compile the preserved touch report configuration into a parse plan.
+ *
+ *  The plan is a flat array of operations, each of which carries the width
+ *  of the entity and the field to store. The loop over the objects is
+ *  resolved ahead of time; when the loop body consists of the object
+ *  entities only, the offset of each entity in an object is calculated as
+ *  well, so the objects can be parsed with a fixed stride.
  *
  * param
- *    [ in] tcm_dev:     pointer to TouchComm device
- *    [ in] report:      touch report generated by TouchComm device
- *    [ in] report_size: size of given report
- *    [out] touch_data:  touch data generated
+ *    [ in] tcm_dev: pointer to TouchComm device
  *
  * return
  *    0 or positive value in case of success, a negative value otherwise.
  */
-int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
-	unsigned int report_size, struct tcm_touch_data_blob *touch_data)
+static int syna_tcm_compile_touch_report_config(struct tcm_dev *tcm_dev)
 {
 	int retval;
-	bool active_only;
-	bool num_of_active_objects;
-	unsigned char code;
+	struct tcm_touch_parse_plan *plan;
+	struct tcm_touch_parse_op *op;
+	unsigned char *config;
 	unsigned int size;
 	unsigned int idx;
-	unsigned int obj;
-	unsigned int loop_start;
-	unsigned int loop_end;
-	unsigned int data;
-	unsigned int bits;
-	unsigned int offset;
-	unsigned int objects;
-	unsigned int active_objects;
-	unsigned int config_size;
-	unsigned char *config_data;
-	struct tcm_objects_data_blob *object_data;
-	unsigned int bits_tailing;
-	unsigned int bits_heading;
+	unsigned int rel_offset = 0;
+	unsigned int loops = 0;
+	bool in_loop = false;
 
 	if (!tcm_dev) {
 		LOGE("Invalid tcm device handle\n");
 		return -ERR_INVAL;
 	}
 
-	if (!report) {
-		LOGE("Invalid report data\n");
+	plan = &tcm_dev->touch_plan;
+	config = tcm_dev->touch_config.buf;
+	size = tcm_dev->touch_config.data_length;
+
+	plan->valid = false;
+	plan->num_ops = 0;
+	plan->loop_body = 0;
+	plan->loop_exit = 0;
+	plan->loop_active_only = false;
+	plan->loop_fixed = false;
+	plan->loop_has_pad = false;
+	plan->loop_stride = 0;
+	plan->has_gesture = false;
+	plan->has_custom = false;
+
+	if ((!config) || (size == 0)) {
+		LOGE("Invalid config_data\n");
 		return -ERR_INVAL;
 	}
 
-	if (!touch_data) {
-		LOGE("Invalid touch data structure\n");
-		return -ERR_INVAL;
+	/* each code makes one op at most, plus the terminating op */
+	if (plan->ops_size < size + 1) {
+		if (plan->ops)
+			syna_pal_mem_free((void *)plan->ops);
+
+		plan->ops_size = 0;
+		plan->ops = syna_pal_mem_alloc(size + 1, sizeof(struct tcm_touch_parse_op));
+		if (!plan->ops) {
+			LOGE("Fail to allocate memory for touch parse plan\n");
+			return -ERR_NOMEM;
+		}
+		plan->ops_size = size + 1;
 	}
 
-	if (tcm_dev->max_objects == 0) {
-		LOGE("Invalid max_objects supported\n");
+	idx = 0;
+	while (idx < size) {
+		op = &plan->ops[plan->num_ops++];
+		op->code = config[idx++];
+		op->bits = 0;
+		op->dest = 0;
+		op->rel_offset = (unsigned short)rel_offset;
+
+		switch (op->code) {
+		case TOUCH_REPORT_END:
+			op->type = TOUCH_PARSE_OP_END;
+			idx = size;
+			break;
+		case TOUCH_REPORT_FOREACH_ACTIVE_OBJECT:
+		case TOUCH_REPORT_FOREACH_OBJECT:
+			if ((in_loop) || (loops++ > 0)) {
+				LOGD("Multiple object loops, not compiled\n");
+				return -ERR_INVAL;
+			}
+			op->type = TOUCH_PARSE_OP_LOOP_BEGIN;
+			plan->loop_active_only = (op->code == TOUCH_REPORT_FOREACH_ACTIVE_OBJECT);
+			plan->loop_body = plan->num_ops;
+			plan->loop_fixed = true;
+			in_loop = true;
+			rel_offset = 0;
+			break;
+		case TOUCH_REPORT_FOREACH_END:
+			if (!in_loop) {
+				LOGE("Unpaired end of object loop\n");
+				return -ERR_INVAL;
+			}
+			op->type = TOUCH_PARSE_OP_LOOP_END;
+			plan->loop_exit = plan->num_ops;
+			plan->loop_stride = rel_offset;
+			in_loop = false;
+			break;
+		case TOUCH_REPORT_PAD_TO_NEXT_BYTE:
+			op->type = TOUCH_PARSE_OP_PAD;
+			rel_offset = syna_pal_int_division(rel_offset, 8, true) * 8;
+			if (in_loop)
+				plan->loop_has_pad = true;
+			break;
+		default:
+			if (idx >= size) {
+				LOGE("Incomplete touch entity:0x%02x\n", op->code);
+				return -ERR_INVAL;
+			}
+			op->bits = config[idx++];
+
+			retval = syna_tcm_compile_touch_entity(plan, op);
+			if (retval < 0)
+				return retval;
+
+			rel_offset += op->bits;
+
+			if (in_loop) {
+				switch (op->type) {
+				case TOUCH_PARSE_OP_OBJ_FIELD:
+				case TOUCH_PARSE_OP_OBJ_EXT_FIELD:
+				case TOUCH_PARSE_OP_OBJ_STATUS:
+				case TOUCH_PARSE_OP_OBJ_INDEX:
+				case TOUCH_PARSE_OP_SKIP:
+					break;
+				default:
+					plan->loop_fixed = false;
+					break;
+				}
+			}
+			break;
+		}
+	}
+
+	if (in_loop) {
+		LOGE("Unterminated object loop\n");
 		return -ERR_INVAL;
 	}
 
-	object_data = touch_data->object_data;
+	/* padding stays at the same place only if every object starts at a byte */
+	if ((plan->loop_has_pad) && (plan->loop_stride % 8))
+		plan->loop_fixed = false;
 
-	if (!object_data) {
-		LOGE("Invalid object_data\n");
-		return -ERR_INVAL;
+	/* terminate the plan, and leave to the end if there is no loop */
+	op = &plan->ops[plan->num_ops++];
+	op->type = TOUCH_PARSE_OP_END;
+	op->code = TOUCH_REPORT_END;
+	op->bits = 0;
+
+	if (loops == 0)
+		plan->loop_exit = plan->num_ops - 1;
+
+	plan->valid = true;
+
+	LOGD("Touch parse plan: %d ops, loop:%s stride:%d\n", plan->num_ops,
+		(loops == 0) ? "none" : (plan->loop_fixed) ? "fixed" : "generic",
+		plan->loop_stride);
+
+	return 0;
+}
+
+/*
+ *  Determine whether the compiled parse plan can be used; otherwise, the
+ *  touch report configuration has to be traversed per report.
+ *
+ * param
+ *    [ in] tcm_dev: pointer to TouchComm device
+ *
+ * return
+ *    true if the plan is ready to use, false otherwise.
+ */
+static inline bool syna_tcm_touch_plan_usable(struct tcm_dev *tcm_dev)
+{
+	struct tcm_touch_parse_plan *plan = &tcm_dev->touch_plan;
+
+	if (!plan->valid)
+		return false;
+
+	if ((plan->has_gesture) && (tcm_dev->cb_custom_gesture_handler.cb))
+		return false;
+
+	if ((plan->has_custom) && (tcm_dev->cb_custom_touch_entity_handler.cb))
+		return false;
+
+	return true;
+}
+
+/*
+ *  Store the status of the object, and mark the object slot being active.
+ *  The slot is also marked dirty once the status is changed.
+ *
+ * param
+ *    [out] touch_data: touch data generated
+ *    [ in] obj:        index of the object slot
+ *    [ in] status:     status of the object
+ *
+ * return
+ *    void.
+ */
+static inline void syna_tcm_set_object_status(struct tcm_touch_data_blob *touch_data,
+	unsigned int obj, unsigned char status)
+{
+	if (obj >= MAX_NUM_OBJECTS)
+		return;
+
+	touch_data->active_objects_mask |= (1U << obj);
+
+	if (touch_data->object_data[obj].status != status) {
+		touch_data->object_data[obj].status = status;
+		touch_data->dirty_objects_mask |= (1U << obj);
 	}
+}
 
-	if (ATOMIC_GET(tcm_dev->touch_config_update) == 1) {
-		LOGN("Skip because touch config is updating\n");
-		return 0;
+/*
+ *  Store the data into the field of object, and mark the object slot being
+ *  active. The slot is also marked dirty once the data is changed.
+ *
+ * param
+ *    [out] touch_data: touch data generated
+ *    [ in] obj:        index of the object slot
+ *    [ in] dest:       byte offset of the field in tcm_objects_data_blob
+ *    [ in] data:       data to store
+ *
+ * return
+ *    void.
+ */
+static inline void syna_tcm_set_object_data(struct tcm_touch_data_blob *touch_data,
+	unsigned int obj, unsigned int dest, unsigned int data)
+{
+	unsigned int *field;
+
+	if (obj >= MAX_NUM_OBJECTS)
+		return;
+
+	touch_data->active_objects_mask |= (1U << obj);
+
+	field = (unsigned int *)((unsigned char *)&touch_data->object_data[obj] + dest);
+	if (*field != data) {
+		*field = data;
+		touch_data->dirty_objects_mask |= (1U << obj);
 	}
+}
 
-	config_data = tcm_dev->touch_config.buf;
-	config_size = tcm_dev->touch_config.data_length;
+/*
+ *  Store the data into the extended field of object, and mark the object
+ *  slot being active. The extended fields are not tracked as dirty.
+ *
+ * param
+ *    [out] touch_data: touch data generated
+ *    [ in] obj:        index of the object slot
+ *    [ in] dest:       byte offset of the field in tcm_objects_ext_data_blob
+ *    [ in] data:       data to store
+ *
+ * return
+ *    void.
+ */
+static inline void syna_tcm_set_object_ext_data(struct tcm_touch_data_blob *touch_data,
+	unsigned int obj, unsigned int dest, unsigned int data)
+{
+	if (obj >= MAX_NUM_OBJECTS)
+		return;
 
-	if ((!config_data) || (config_size == 0)) {
-		LOGE("Invalid config_data\n");
-		return -ERR_INVAL;
+	touch_data->active_objects_mask |= (1U << obj);
+
+	*(unsigned int *)((unsigned char *)&touch_data->object_ext_data[obj] + dest) = data;
+}
+
+/*
+ *  Store the data parsed into the field pointed by the operation.
+ *
+ * param
+ *    [ in] op:         operation of parse plan
+ *    [ in] data:       data parsed
+ *    [ in] state:      running state of parse plan
+ *    [out] touch_data: touch data generated
+ *
+ * return
+ *    void.
+ */
+static inline void syna_tcm_touch_plan_store(const struct tcm_touch_parse_op *op,
+	unsigned int data, struct tcm_touch_parse_state *state,
+	struct tcm_touch_data_blob *touch_data)
+{
+	switch (op->type) {
+	case TOUCH_PARSE_OP_FIELD:
+		*(unsigned int *)((unsigned char *)touch_data + op->dest) = data;
+		break;
+	case TOUCH_PARSE_OP_OBJ_FIELD:
+		syna_tcm_set_object_data(touch_data, state->obj, op->dest, data);
+		break;
+	case TOUCH_PARSE_OP_OBJ_EXT_FIELD:
+		syna_tcm_set_object_ext_data(touch_data, state->obj, op->dest, data);
+		break;
+	case TOUCH_PARSE_OP_OBJ_STATUS:
+		syna_tcm_set_object_status(touch_data, state->obj, (unsigned char)data);
+		break;
+	case TOUCH_PARSE_OP_OBJ_INDEX:
+		state->obj = data;
+		touch_data->obji = data;
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ *  Determine how to proceed at the end of an object in the loop.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] state:       running state of parse plan
+ *    [ in] report_bits: size of given report in bits
+ *
+ * return
+ *    TOUCH_PLAN_NEXT_OBJECT to parse the next object, TOUCH_PLAN_LEAVE_LOOP
+ *    to leave the loop, or TOUCH_PLAN_STOP if the report runs out.
+ */
+static inline int syna_tcm_touch_plan_end_object(struct tcm_dev *tcm_dev,
+	struct tcm_touch_parse_state *state, unsigned int report_bits)
+{
+	unsigned int bits_tailing = tcm_dev->bits_config_tailing;
+
+	if (state->offset + bits_tailing > report_bits)
+		return TOUCH_PLAN_STOP;
+	else if (state->offset + bits_tailing == report_bits)
+		return TOUCH_PLAN_LEAVE_LOOP;
+
+	if (tcm_dev->touch_plan.loop_active_only) {
+		if (state->num_of_active_objects) {
+			state->objects++;
+			state->obj++;
+			if (state->objects < state->active_objects)
+				return TOUCH_PLAN_NEXT_OBJECT;
+		} else if (state->offset < report_bits) {
+			state->obj++;
+			return TOUCH_PLAN_NEXT_OBJECT;
+		}
+		return TOUCH_PLAN_LEAVE_LOOP;
 	}
 
-	size = sizeof(touch_data->object_data);
-	syna_pal_mem_set(touch_data->object_data, 0x00, size);
+	state->obj++;
+	if (state->obj < tcm_dev->max_objects)
+		return TOUCH_PLAN_NEXT_OBJECT;
+
+	return TOUCH_PLAN_LEAVE_LOOP;
+}
+
+/*
+ *  Parse the touch report by running the compiled parse plan.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] report:      touch report generated by TouchComm device
+ *    [ in] report_size: size of given report
+ *    [out] touch_data:  touch data generated
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_run_touch_plan(struct tcm_dev *tcm_dev, const unsigned char *report,
+	unsigned int report_size, struct tcm_touch_data_blob *touch_data)
+{
+	int retval;
+	struct tcm_touch_parse_plan *plan = &tcm_dev->touch_plan;
+	const struct tcm_touch_parse_op *op;
+	struct tcm_touch_parse_state state = { 0 };
+	unsigned int report_bits = report_size * 8;
+	unsigned int pc = 0;
+	unsigned int idx;
+	unsigned int base;
+	unsigned int data;
+
+	while (pc < plan->num_ops) {
+		op = &plan->ops[pc++];
+
+		switch (op->type) {
+		case TOUCH_PARSE_OP_END:
+			goto exit;
+		case TOUCH_PARSE_OP_LOOP_BEGIN:
+			if (tcm_dev->bits_config_heading + tcm_dev->bits_config_tailing >= report_bits) {
+				pc = plan->loop_exit;
+				break;
+			}
+			state.obj = 0;
+
+			if ((!plan->loop_fixed) || ((plan->loop_has_pad) && (state.offset % 8)))
+				break;
+
+			/* fixed layout, parse each object at a fixed stride */
+			do {
+				base = state.offset;
+				for (idx = plan->loop_body; idx < plan->loop_exit - 1; idx++) {
+					op = &plan->ops[idx];
+					if (op->bits == 0 || op->type == TOUCH_PARSE_OP_SKIP)
+						continue;
+
+					data = syna_tcm_get_touch_bits(report, report_size,
+						base + op->rel_offset, op->bits);
+					syna_tcm_touch_plan_store(op, data, &state, touch_data);
+				}
+				state.offset = base + plan->loop_stride;
+
+				retval = syna_tcm_touch_plan_end_object(tcm_dev, &state, report_bits);
+				if (retval == TOUCH_PLAN_STOP)
+					goto exit;
+			} while (retval == TOUCH_PLAN_NEXT_OBJECT);
+
+			pc = plan->loop_exit;
+			break;
+		case TOUCH_PARSE_OP_LOOP_END:
+			retval = syna_tcm_touch_plan_end_object(tcm_dev, &state, report_bits);
+			if (retval == TOUCH_PLAN_STOP)
+				goto exit;
+			if (retval == TOUCH_PLAN_NEXT_OBJECT)
+				pc = plan->loop_body;
+			break;
+		case TOUCH_PARSE_OP_PAD:
+			state.offset = syna_pal_int_division(state.offset, 8, true) * 8;
+			break;
+		case TOUCH_PARSE_OP_SKIP:
+			state.offset += op->bits;
+			break;
+		case TOUCH_PARSE_OP_NUM_ACTIVE:
+			data = syna_tcm_get_touch_bits(report, report_size,
+				state.offset, op->bits);
+			state.active_objects = data;
+			state.num_of_active_objects = true;
+			touch_data->num_of_active_objects = data;
+			state.offset += op->bits;
+			if (data == 0)
+				pc = plan->loop_exit;
+			break;
+		case TOUCH_PARSE_OP_GESTURE_DATA:
+			retval = syna_tcm_get_gesture_data(report, report_size,
+				state.offset, op->bits, &touch_data->gesture_data,
+				touch_data->gesture_id);
+			if (retval < 0) {
+				LOGE("Fail to get gesture data\n");
+				return retval;
+			}
+			state.offset += op->bits;
+			break;
+#ifdef TOUCHCOMM_TDDI
+		case TOUCH_PARSE_OP_KNOB_DATA:
+			retval = syna_tcm_get_knob_data(report, report_size,
+				state.offset, op->bits, touch_data->knob);
+			if (retval < 0) {
+				LOGE("Fail to get knob data\n");
+				return retval;
+			}
+			state.offset += op->bits;
+			break;
+#endif
+		default:
+			/* bits of the entities are validated while compiling */
+			data = syna_tcm_get_touch_bits(report, report_size,
+				state.offset, op->bits);
+			syna_tcm_touch_plan_store(op, data, &state, touch_data);
+			state.offset += op->bits;
+			break;
+		}
+	}
+
+exit:
+	return state.offset;
+}
+
+/*
+ *  Traverse through touch report configuration per report, and parse the
+ *  contents of report packet. This is used when the compiled parse plan is
+ *  not available.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] report:      touch report generated by TouchComm device
+ *    [ in] report_size: size of given report
+ *    [out] touch_data:  touch data generated
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int syna_tcm_traverse_touch_report(struct tcm_dev *tcm_dev,
+	unsigned char *report, unsigned int report_size,
+	struct tcm_touch_data_blob *touch_data)
+{
+	int retval;
+	bool active_only;
+	bool num_of_active_objects;
+	unsigned char code;
+	unsigned int idx;
+	unsigned int obj;
+	unsigned int loop_start;
+	unsigned int loop_end;
+	unsigned int data;
+	unsigned int bits;
+	unsigned int offset;
+	unsigned int objects;
+	unsigned int active_objects;
+	unsigned int config_size;
+	unsigned char *config_data;
+	unsigned int bits_tailing;
+	unsigned int bits_heading;
+
+	config_data = tcm_dev->touch_config.buf;
+	config_size = tcm_dev->touch_config.data_length;
 
 	num_of_active_objects = false;
 
@@ -444,7 +967,7 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
 				LOGE("Fail to get object classification\n");
 				return retval;
 			}
-			object_data[obj].status = (unsigned char)data;
+			syna_tcm_set_object_status(touch_data, obj, (unsigned char)data);
 			offset += bits;
 			break;
 		case TOUCH_REPORT_OBJECT_N_X_POSITION:
@@ -455,7 +978,8 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
 				LOGE("Fail to get object x position\n");
 				return retval;
 			}
-			object_data[obj].x_pos = data;
+			syna_tcm_set_object_data(touch_data, obj,
+				offsetof(struct tcm_objects_data_blob, x_pos), data);
 			offset += bits;
 			break;
 		case TOUCH_REPORT_OBJECT_N_Y_POSITION:
@@ -466,7 +990,8 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
 				LOGE("Fail to get object y position\n");
 				return retval;
 			}
-			object_data[obj].y_pos = data;
+			syna_tcm_set_object_data(touch_data, obj,
+				offsetof(struct tcm_objects_data_blob, y_pos), data);
 			offset += bits;
 			break;
 		case TOUCH_REPORT_OBJECT_N_Z:
@@ -477,7 +1002,8 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
 				LOGE("Fail to get object z\n");
 				return retval;
 			}
-			object_data[obj].z = data;
+			syna_tcm_set_object_ext_data(touch_data, obj,
+				offsetof(struct tcm_objects_ext_data_blob, z), data);
 			offset += bits;
 			break;
 		case TOUCH_REPORT_OBJECT_N_X_WIDTH:
@@ -488,7 +1014,8 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
 				LOGE("Fail to get object x width\n");
 				return retval;
 			}
-			object_data[obj].x_width = data;
+			syna_tcm_set_object_data(touch_data, obj,
+				offsetof(struct tcm_objects_data_blob, x_width), data);
 			offset += bits;
 			break;
 		case TOUCH_REPORT_OBJECT_N_Y_WIDTH:
@@ -499,7 +1026,8 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
 				LOGE("Fail to get object y width\n");
 				return retval;
 			}
-			object_data[obj].y_width = data;
+			syna_tcm_set_object_data(touch_data, obj,
+				offsetof(struct tcm_objects_data_blob, y_width), data);
 			offset += bits;
 			break;
 		case TOUCH_REPORT_OBJECT_N_TX_POSITION_TIXELS:
@@ -510,7 +1038,8 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
 				LOGE("Fail to get object tx position\n");
 				return retval;
 			}
-			object_data[obj].tx_pos = data;
+			syna_tcm_set_object_ext_data(touch_data, obj,
+				offsetof(struct tcm_objects_ext_data_blob, tx_pos), data);
 			offset += bits;
 			break;
 		case TOUCH_REPORT_OBJECT_N_RX_POSITION_TIXELS:
@@ -521,7 +1050,8 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
 				LOGE("Fail to get object rx position\n");
 				return retval;
 			}
-			object_data[obj].rx_pos = data;
+			syna_tcm_set_object_ext_data(touch_data, obj,
+				offsetof(struct tcm_objects_ext_data_blob, rx_pos), data);
 			offset += bits;
 			break;
 		case TOUCH_REPORT_NUM_OF_ACTIVE_OBJECTS:
@@ -762,6 +1292,165 @@ exit:
 	return offset;
 }
 
+/*
+ *  Traverse through touch report configuration and parse the contents of
+ *  report packet to get the exactly touched data entity from touch reports.
+ *
+ *  At the end of function, the touched data will be parsed and stored at the
+ *  associated fields inside the structure touch_data_blob. Only the object
+ *  slots no longer reported are cleared, and the slots changed are flagged
+ *  in dirty_objects_mask. Fields of a reported slot which are not carried
+ *  by the report keep their previous values.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] report:      touch report generated by TouchComm device
+ *    [ in] report_size: size of given report
+ *    [out] touch_data:  touch data generated
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev, unsigned char *report,
+	unsigned int report_size, struct tcm_touch_data_blob *touch_data)
+{
+	int retval;
+	unsigned int obj;
+	unsigned int stale;
+
+	if (!tcm_dev) {
+		LOGE("Invalid tcm device handle\n");
+		return -ERR_INVAL;
+	}
+
+	if (!report) {
+		LOGE("Invalid report data\n");
+		return -ERR_INVAL;
+	}
+
+	if (!touch_data) {
+		LOGE("Invalid touch data structure\n");
+		return -ERR_INVAL;
+	}
+
+	if (tcm_dev->max_objects == 0) {
+		LOGE("Invalid max_objects supported\n");
+		return -ERR_INVAL;
+	}
+
+	if (ATOMIC_GET(tcm_dev->touch_config_update) == 1) {
+		LOGN("Skip because touch config is updating\n");
+		return 0;
+	}
+
+	if ((!tcm_dev->touch_config.buf) || (tcm_dev->touch_config.data_length == 0)) {
+		LOGE("Invalid config_data\n");
+		return -ERR_INVAL;
+	}
+
+	/* slots active in the previous report, cleared unless reported again */
+	stale = touch_data->active_objects_mask;
+	touch_data->active_objects_mask = 0;
+	touch_data->dirty_objects_mask = 0;
+
+	/* run the compiled plan unless the custom parsing methods take part in */
+	if (syna_tcm_touch_plan_usable(tcm_dev))
+		retval = syna_tcm_run_touch_plan(tcm_dev, report, report_size, touch_data);
+	else
+		retval = syna_tcm_traverse_touch_report(tcm_dev, report, report_size, touch_data);
+
+	stale &= ~touch_data->active_objects_mask;
+	for (obj = 0; stale != 0; obj++, stale >>= 1) {
+		if (!(stale & 0x01))
+			continue;
+
+		syna_pal_mem_set(&touch_data->object_data[obj], 0x00,
+			sizeof(struct tcm_objects_data_blob));
+		syna_pal_mem_set(&touch_data->object_ext_data[obj], 0x00,
+			sizeof(struct tcm_objects_ext_data_blob));
+		touch_data->dirty_objects_mask |= (1U << obj);
+	}
+
+	return retval;
+}
+
+/*
+ *  Get the firmware timestamp from the touch report without parsing the
+ *  whole report.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] report:      touch report generated by TouchComm device
+ *    [ in] report_size: size of given report
+ *    [out] timestamp:   timestamp parsed
+ *    [out] bits:        number of bits representing the timestamp
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_get_touch_timestamp(struct tcm_dev *tcm_dev,
+	const unsigned char *report, unsigned int report_size,
+	unsigned int *timestamp, unsigned int *bits)
+{
+	struct tcm_touch_parse_plan *plan;
+	const struct tcm_touch_parse_op *op;
+	unsigned int report_bits = report_size * 8;
+	unsigned int offset = 0;
+	unsigned int pc = 0;
+	bool in_tail = false;
+
+	if ((!tcm_dev) || (!report) || (!timestamp) || (!bits)) {
+		LOGE("Invalid parameters\n");
+		return -ERR_INVAL;
+	}
+
+	if (ATOMIC_GET(tcm_dev->touch_config_update) == 1)
+		return -ERR_BUSY;
+
+	plan = &tcm_dev->touch_plan;
+	if (!plan->valid)
+		return -ERR_NODEV;
+
+	while (pc < plan->num_ops) {
+		op = &plan->ops[pc++];
+
+		switch (op->type) {
+		case TOUCH_PARSE_OP_END:
+			return -ERR_NODEV;
+		case TOUCH_PARSE_OP_LOOP_BEGIN:
+			/* the entities after the loop are located from the end */
+			if (tcm_dev->bits_config_tailing > report_bits)
+				return -ERR_INVAL;
+			offset = report_bits - tcm_dev->bits_config_tailing;
+			pc = plan->loop_exit;
+			in_tail = true;
+			break;
+		case TOUCH_PARSE_OP_LOOP_END:
+			return -ERR_NODEV;
+		case TOUCH_PARSE_OP_PAD:
+			if (in_tail)
+				return -ERR_NODEV;
+			offset = syna_pal_int_division(offset, 8, true) * 8;
+			break;
+		default:
+			if ((op->type == TOUCH_PARSE_OP_FIELD) &&
+				(op->code == TOUCH_REPORT_TIMESTAMP)) {
+				if (offset + op->bits > report_bits)
+					return -ERR_INVAL;
+
+				*timestamp = syna_tcm_get_touch_bits(report, report_size,
+					offset, op->bits);
+				*bits = op->bits;
+				return 0;
+			}
+			offset += op->bits;
+			break;
+		}
+	}
+
+	return -ERR_NODEV;
+}
+
 /*
  *  Set up the custom touch report configuration.
  *
@@ -848,6 +1537,9 @@ int syna_tcm_set_touch_report_config(struct tcm_dev *tcm_dev,
 		goto exit;
 	}
 
+	/* the plan is rebuilt when the new config is preserved */
+	tcm_dev->touch_plan.valid = false;
+
 	LOGI("Set touch config done\n");
 
 exit:
@@ -916,6 +1608,7 @@ int syna_tcm_preserve_touch_report_config(struct tcm_dev *tcm_dev,
 	syna_tcm_buf_lock(&tcm_dev->touch_config);
 
 	ATOMIC_SET(tcm_dev->touch_config_update, 1);
+	tcm_dev->touch_plan.valid = false;
 
 	size = tcm_dev->resp_buf.data_length;
 	retval = syna_tcm_buf_alloc(&tcm_dev->touch_config,
@@ -988,12 +1681,178 @@ int syna_tcm_preserve_touch_report_config(struct tcm_dev *tcm_dev,
 	tcm_dev->bits_config_loop = bits_in_loop;
 	tcm_dev->bits_config_tailing = bits_tailing;
 
+	/* compile the parse plan, the report is traversed per report if failed */
+	if (syna_tcm_compile_touch_report_config(tcm_dev) < 0)
+		LOGW("Fail to compile touch config, use the generic parser instead\n");
+
 exit:
 	ATOMIC_SET(tcm_dev->touch_config_update, 0);
 
 	return retval;
 }
 
+/*
+ *  Reduce the touch report configuration to the entities requested.
+ *
+ *  The entities requested keep the number of bits given in the original
+ *  configuration; the others are removed, as well as the object loop
+ *  and the padding that carry no entity anymore.
+ *
+ * param
+ *    [ in] config:       the original report configuration
+ *    [ in] config_size:  size of given config
+ *    [ in] entity_mask:  mask of the entities requested,
+ *                        TOUCH_ENTITY_MASK_SIZE bytes
+ *    [out] reduced:      buffer to store the reduced configuration
+ *    [ in] reduced_size: size of the buffer
+ *
+ * return
+ *    the size of reduced configuration in case of success,
+ *    a negative value otherwise.
+ */
+int syna_tcm_reduce_touch_report_config(const unsigned char *config,
+	unsigned int config_size, const unsigned char *entity_mask,
+	unsigned char *reduced, unsigned int reduced_size)
+{
+	unsigned int idx = 0;
+	unsigned int size = 0;
+	unsigned int loop_start = 0;
+	unsigned char code;
+	unsigned char bits;
+	/* entities kept since the object loop or the last padding */
+	bool kept = false;
+	bool in_loop = false;
+
+	if ((!config) || (config_size == 0) || (!entity_mask) || (!reduced)) {
+		LOGE("Invalid parameters\n");
+		return -ERR_INVAL;
+	}
+
+	while (idx < config_size) {
+		code = config[idx++];
+
+		/* each code takes two bytes at most, plus the terminating code */
+		if (size + 3 > reduced_size) {
+			LOGE("Insufficient buffer size %d\n", reduced_size);
+			return -ERR_NOMEM;
+		}
+
+		switch (code) {
+		case TOUCH_REPORT_END:
+			idx = config_size;
+			break;
+		case TOUCH_REPORT_FOREACH_ACTIVE_OBJECT:
+		case TOUCH_REPORT_FOREACH_OBJECT:
+			loop_start = size;
+			reduced[size++] = code;
+			in_loop = true;
+			kept = false;
+			break;
+		case TOUCH_REPORT_FOREACH_END:
+			if (!in_loop) {
+				LOGE("Unpaired end of object loop\n");
+				return -ERR_INVAL;
+			}
+			/* drop the loop if nothing left in the loop body */
+			if (size == loop_start + 1)
+				size = loop_start;
+			else
+				reduced[size++] = code;
+			in_loop = false;
+			kept = false;
+			break;
+		case TOUCH_REPORT_PAD_TO_NEXT_BYTE:
+			if (kept)
+				reduced[size++] = code;
+			kept = false;
+			break;
+		default:
+			if (idx >= config_size) {
+				LOGE("Incomplete touch entity:0x%02x\n", code);
+				return -ERR_INVAL;
+			}
+			bits = config[idx++];
+
+			if (!syna_tcm_test_touch_entity(entity_mask, code))
+				break;
+
+			reduced[size++] = code;
+			reduced[size++] = bits;
+			kept = true;
+			break;
+		}
+	}
+
+	if (in_loop) {
+		LOGE("Unterminated object loop\n");
+		return -ERR_INVAL;
+	}
+
+	reduced[size++] = TOUCH_REPORT_END;
+
+	return (int)size;
+}
+
+/*
+ *  Calculate the number of bits of a touch report generated by the given
+ *  report configuration.
+ *
+ * param
+ *    [ in] config:      the report configuration
+ *    [ in] config_size: size of given config
+ *    [ in] num_objects: number of objects reported in the object loop
+ *
+ * return
+ *    the number of bits of a touch report.
+ */
+unsigned int syna_tcm_get_touch_report_bits(const unsigned char *config,
+	unsigned int config_size, unsigned int num_objects)
+{
+	unsigned int idx = 0;
+	unsigned int offset = 0;
+	unsigned int loop_offset = 0;
+	unsigned char code;
+	bool in_loop = false;
+
+	if ((!config) || (config_size == 0))
+		return 0;
+
+	while (idx < config_size) {
+		code = config[idx++];
+
+		switch (code) {
+		case TOUCH_REPORT_END:
+			idx = config_size;
+			break;
+		case TOUCH_REPORT_FOREACH_ACTIVE_OBJECT:
+		case TOUCH_REPORT_FOREACH_OBJECT:
+			in_loop = true;
+			loop_offset = 0;
+			break;
+		case TOUCH_REPORT_FOREACH_END:
+			offset += loop_offset * num_objects;
+			in_loop = false;
+			break;
+		case TOUCH_REPORT_PAD_TO_NEXT_BYTE:
+			if (in_loop)
+				loop_offset = syna_pal_int_division(loop_offset, 8, true) * 8;
+			else
+				offset = syna_pal_int_division(offset, 8, true) * 8;
+			break;
+		default:
+			if (idx >= config_size)
+				break;
+			if (in_loop)
+				loop_offset += config[idx++];
+			else
+				offset += config[idx++];
+			break;
+		}
+	}
+
+	return offset;
+}
+
 /*
  *  Register callback function to handle custom touch entity.
  *
@@ -109,6 +109,78 @@ enum touch_report_code {
 	TOUCH_REPORT_KNOB_CALIB = 0x86,
 };
 
+/* Size of the mask of touch entities, one bit for each entity code */
+#define TOUCH_ENTITY_MASK_SIZE (32)
+
+/*
+ *  Mark the touch entity in the mask of touch entities.
+ *
+ * param
+ *    [out] mask: mask of touch entities, TOUCH_ENTITY_MASK_SIZE bytes
+ *    [ in] code: code of touch entity
+ *
+ * return
+ *    void.
+ */
+static inline void syna_tcm_set_touch_entity(unsigned char *mask,
+	unsigned char code)
+{
+	mask[code >> 3] |= (unsigned char)(1 << (code & 0x7));
+}
+/*
+ *  Check whether the touch entity is marked in the mask of touch entities.
+ *
+ * param
+ *    [ in] mask: mask of touch entities, TOUCH_ENTITY_MASK_SIZE bytes
+ *    [ in] code: code of touch entity
+ *
+ * return
+ *    true if the entity is marked, false otherwise.
+ */
+static inline bool syna_tcm_test_touch_entity(const unsigned char *mask,
+	unsigned char code)
+{
+	return (mask[code >> 3] & (1 << (code & 0x7))) != 0;
+}
+
+
+/*
+ *  Extract a bit field from the touch report.
+ *
+ *  The field is taken from a single little-endian 64-bit load, which covers
+ *  any field of up to 32 bits at any bit position. Near the end of report,
+ *  the remaining bytes are assembled one by one instead, so no read goes
+ *  beyond the report.
+ *
+ * param
+ *    [ in] report:  touch report generated by TouchComm device
+ *    [ in] size:    size of given report
+ *    [ in] offset:  bit offset in the report
+ *    [ in] bits:    number of bits representing the data, 1 to 32
+ *
+ * return
+ *    the data extracted, or 0 if the field is out of the report.
+ */
+static inline unsigned int syna_tcm_get_touch_bits(const unsigned char *report,
+	unsigned int size, unsigned int offset, unsigned int bits)
+{
+	unsigned int byte_offset = offset >> 3;
+	unsigned int idx;
+	unsigned long long word = 0;
+
+	if (offset + bits > size * 8)
+		return 0;
+
+	if (byte_offset + sizeof(word) <= size) {
+		word = syna_pal_le8_to_u64(&report[byte_offset]);
+	} else {
+		for (idx = byte_offset; idx < size; idx++)
+			word |= (unsigned long long)report[idx] << ((idx - byte_offset) * 8);
+	}
+
+	return (unsigned int)((word >> (offset & 0x7)) & ((1ULL << bits) - 1));
+}
+
 
 /*
  * Standard API Definitions
@@ -134,6 +206,28 @@ int syna_tcm_parse_touch_report(struct tcm_dev *tcm_dev,
 		unsigned char *report, unsigned int report_size,
 		struct tcm_touch_data_blob *touch_data);
 
+/*
+ *  Get the firmware timestamp from the touch report without parsing the
+ *  whole report.
+ *
+ *  The timestamp is located by the compiled parse plan, so it's available
+ *  only if it comes before the loop of objects, or after the loop with no
+ *  padding in between.
+ *
+ * param
+ *    [ in] tcm_dev:     pointer to TouchComm device
+ *    [ in] report:      touch report generated by TouchComm device
+ *    [ in] report_size: size of given report
+ *    [out] timestamp:   timestamp parsed
+ *    [out] bits:        number of bits representing the timestamp
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int syna_tcm_get_touch_timestamp(struct tcm_dev *tcm_dev,
+	const unsigned char *report, unsigned int report_size,
+	unsigned int *timestamp, unsigned int *bits);
+
 /*
  *  Set up the custom touch report configuration.
  *
@@ -169,6 +263,44 @@ int syna_tcm_set_touch_report_config(struct tcm_dev *tcm_dev,
 int syna_tcm_preserve_touch_report_config(struct tcm_dev *tcm_dev,
 	unsigned int resp_reading);
 
+/*
+ *  Reduce the touch report configuration to the entities requested.
+ *
+ *  The entities requested keep the number of bits given in the original
+ *  configuration; the others are removed, as well as the object loop
+ *  and the padding that carry no entity anymore.
+ *
+ * param
+ *    [ in] config:       the original report configuration
+ *    [ in] config_size:  size of given config
+ *    [ in] entity_mask:  mask of the entities requested,
+ *                        TOUCH_ENTITY_MASK_SIZE bytes
+ *    [out] reduced:      buffer to store the reduced configuration
+ *    [ in] reduced_size: size of the buffer
+ *
+ * return
+ *    the size of reduced configuration in case of success,
+ *    a negative value otherwise.
+ */
+int syna_tcm_reduce_touch_report_config(const unsigned char *config,
+	unsigned int config_size, const unsigned char *entity_mask,
+	unsigned char *reduced, unsigned int reduced_size);
+
+/*
+ *  Calculate the number of bits of a touch report generated by the given
+ *  report configuration.
+ *
+ * param
+ *    [ in] config:      the report configuration
+ *    [ in] config_size: size of given config
+ *    [ in] num_objects: number of objects reported in the object loop
+ *
+ * return
+ *    the number of bits of a touch report.
+ */
+unsigned int syna_tcm_get_touch_report_bits(const unsigned char *config,
+	unsigned int config_size, unsigned int num_objects);
+
 /*
  *  Get data entity from the Touch report.
  *
@@ -90,6 +90,8 @@ struct tcm_hw_platform {
 	 * set to 'true' if the platform supports ATTN notifications; otherwise, set to 'false' by default.
 	 */
 	bool support_attn;
+	/* level of the ATTN signal when asserted, compared with ops_get_attn_level() */
+	unsigned int attn_active_level;
 
 	/* indicates the extra data alignment on the target platform */
 	bool alignment_enabled;
@@ -139,6 +141,29 @@ struct tcm_hw_platform {
 	int (*ops_write_then_read_data)(struct tcm_hw_platform *hw,
 		unsigned char *wr_data, unsigned int wr_len, unsigned char *rd_data,
 		unsigned int rd_len, unsigned int turnaround_bytes);
+
+	/* abstraction to submit a write-then-read transaction without waiting
+	 * for its completion, optional; the wr_data is consumed before return,
+	 * while the rd_data shall remain valid until the complete() is called
+	 *
+	 * param
+	 *    [ in] hw:       pointer to the hardware platform
+	 *    [ in] wr_data:  data to write
+	 *    [ in] wr_len:   length of written data in bytes
+	 *    [out] rd_data:  buffer for storing data retrieved from device
+	 *    [ in] rd_len:   number of bytes retrieved from device
+	 *    [ in] turnaround_bytes:  number of bytes for bus turnaround
+	 *    [ in] complete: callback invoked with the context and the status
+	 *                    once the transaction is done
+	 *    [ in] context:  context passed to the callback
+	 *
+	 * return
+	 *    0 if the transaction is submitted, a negative value otherwise.
+	 */
+	int (*ops_write_then_read_data_async)(struct tcm_hw_platform *hw,
+		unsigned char *wr_data, unsigned int wr_len, unsigned char *rd_data,
+		unsigned int rd_len, unsigned int turnaround_bytes,
+		void (*complete)(void *context, int status), void *context);
 #endif
 	/* abstraction to wait for the ATTN assertion
 	 *
@@ -0,0 +1,103 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Synaptics TouchComm touchscreen driver
+ *
+ * Copyright (C) 2017-2025 Synaptics Incorporated. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND SYNAPTICS
+ * EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES, INCLUDING ANY
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE,
+ * AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY INTELLECTUAL PROPERTY RIGHTS.
+ * IN NO EVENT SHALL SYNAPTICS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, PUNITIVE, OR CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION
+ * WITH THE USE OF THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED
+ * AND BASED ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT JURISDICTION DOES
+ * NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY OTHER DAMAGES, SYNAPTICS'
+ * TOTAL CUMULATIVE LIABILITY TO ANY PARTY SHALL NOT EXCEED ONE HUNDRED U.S.
+ * DOLLARS.
+ */
+
+/*
+ * This file implements the common helpers of the microbenchmarks.
+ *
+ * Each case is run several rounds and the best round is reported, in cycles
+ * per iteration where the time stamp counter is available, or nanoseconds
+ * per iteration otherwise.
+ */
+
+#ifndef _SYNAPTICS_TCM2_BENCH_H_
+#define _SYNAPTICS_TCM2_BENCH_H_
+
+#include "syna_tcm2_runtime.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+#else
+#define BENCH_UNIT "ns"
+#endif
+
+#define BENCH_ROUNDS (7)
+
+/* keep the compiler from dropping the result being measured */
+#define BENCH_KEEP(var) \
+	__asm__ __volatile__("" : : "g"(var) : "memory")
+
+/*
+ * Read the current time stamp
+ *
+ * return
+ *    the cycle counter if available; otherwise, the monotonic time in ns.
+ */
+static inline unsigned long long bench_stamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return (unsigned long long)syna_pal_get_time();
+#endif
+}
+
+/*
+ * Run the given case for several rounds and return the best one
+ *
+ * param
+ *    [ in] func:  the case to run, it shall loop 'iters' times
+ *    [ in] arg:   argument passed to the case
+ *    [ in] iters: number of iterations per round
+ *
+ * return
+ *    the cost of one iteration in the best round.
+ */
+static inline double bench_run(void (*func)(void *arg, unsigned int iters),
+	void *arg, unsigned int iters)
+{
+	unsigned long long start;
+	unsigned long long best = ~0ULL;
+	int round;
+
+	/* warm up the caches and the branch predictors */
+	func(arg, iters);
+
+	for (round = 0; round < BENCH_ROUNDS; round++) {
+		start = bench_stamp();
+		func(arg, iters);
+		best = MIN(best, bench_stamp() - start);
+	}
+
+	return (double)best / iters;
+}
+
+#endif /* _SYNAPTICS_TCM2_BENCH_H_ */
@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Synaptics TouchComm touchscreen driver
+ *
+ * Copyright (C) 2017-2025 Synaptics Incorporated. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND SYNAPTICS
+ * EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES, INCLUDING ANY
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE,
+ * AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY INTELLECTUAL PROPERTY RIGHTS.
+ * IN NO EVENT SHALL SYNAPTICS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, PUNITIVE, OR CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION
+ * WITH THE USE OF THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED
+ * AND BASED ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT JURISDICTION DOES
+ * NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY OTHER DAMAGES, SYNAPTICS'
+ * TOTAL CUMULATIVE LIABILITY TO ANY PARTY SHALL NOT EXCEED ONE HUNDRED U.S.
+ * DOLLARS.
+ */
+
+/*
+ * This file implements the microbenchmark of the per-frame buffer handling
+ * on the read, write and dispatch paths of the TouchComm v2 core library.
+ *
+ * Each path is driven through the core library against the device emulated
+ * in bench_device.c:
+ *   read:     read_message() retrieving a report, up to the dispatcher
+ *   write:    write_message() sending a command with a frame of payload
+ *   dispatch: write_message() receiving a frame of response data
+ *
+ * The same paths are timed on the library as it is, where the buffers are
+ * sized by syna_tcm_buf_reserve(), and on the one built by
+ * core_v2_buf_alloc.c, where they are sized by syna_tcm_buf_alloc().
+ */
+
+#include "bench.h"
+#include "bench_device.h"
+#include "synaptics_touchcom_func_base.h"
+
+#define ITERATIONS (20000)
+
+/* touch report of 10 fingers, and a 36x18 image of 16-bit deltas */
+#define TOUCH_FRAME_SIZE (64)
+#define RAW_FRAME_SIZE (36 * 18 * 2 + 64)
+
+/* commands carrying the frames on the write and dispatch paths */
+#define BENCH_WRITE_COMMAND CMD_SET_TOUCH_REPORT_CONFIG
+#define BENCH_DISPATCH_COMMAND CMD_GET_TOUCH_REPORT_CONFIG
+
+/* the library built by core_v2_buf_alloc.c */
+int syna_tcm_v2_detect_buf_alloc(struct tcm_dev *tcm_dev, bool bypass,
+	bool do_reset);
+
+enum bench_path {
+	BENCH_PATH_READ = 0,
+	BENCH_PATH_WRITE,
+	BENCH_PATH_DISPATCH,
+};
+
+struct bench_case {
+	struct bench_device bdev;
+	enum bench_path path;
+	unsigned char *frame;
+	unsigned int frame_size;
+	/* code expected from the device */
+	unsigned char code;
+	/* the report received by the dispatcher lastly */
+	const unsigned char *report;
+	unsigned int report_size;
+};
+
+/*
+ * The dispatcher of the reports, as registered by the driver
+ */
+static int bench_report_dispatcher(const unsigned char code,
+	const unsigned char *data, unsigned int data_size, void *callback_data)
+{
+	struct bench_case *bc = (struct bench_case *)callback_data;
+
+	bc->report = data;
+	bc->report_size = data_size;
+
+	return 0;
+}
+
+/*
+ * Run the path once for a frame of the given size
+ *
+ * param
+ *    [ in] bc:   the case set up
+ *    [ in] size: size of frame
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static inline int bench_path_run(struct bench_case *bc, unsigned int size)
+{
+	struct tcm_dev *tcm_dev = bc->bdev.tcm_dev;
+	unsigned char code;
+	int retval;
+
+	switch (bc->path) {
+	case BENCH_PATH_READ:
+		retval = tcm_dev->read_message(tcm_dev, &code);
+		break;
+	case BENCH_PATH_WRITE:
+		retval = tcm_dev->write_message(tcm_dev, BENCH_WRITE_COMMAND,
+				bc->frame, size, &code, CMD_RESPONSE_IN_ATTN);
+		break;
+	default:
+		retval = tcm_dev->write_message(tcm_dev, BENCH_DISPATCH_COMMAND,
+				NULL, 0, &code, CMD_RESPONSE_IN_ATTN);
+		break;
+	}
+
+	if ((retval >= 0) && (code != bc->code))
+		retval = -ERR_TCMMSG;
+
+	return retval;
+}
+
+static void bench_frame(void *arg, unsigned int iters)
+{
+	struct bench_case *bc = (struct bench_case *)arg;
+	unsigned int i;
+
+	for (i = 0; i < iters; i++) {
+		if (bench_path_run(bc, bc->frame_size) < 0)
+			exit(EXIT_FAILURE);
+	}
+
+	BENCH_KEEP(bc->bdev.tcm_dev->resp_buf.buf);
+}
+
+/*
+ * Let the device return frames of the given size on the path
+ *
+ * param
+ *    [ in] bc:   the case set up
+ *    [ in] size: size of frame
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int bench_case_set_frame(struct bench_case *bc, unsigned int size)
+{
+	bc->code = STATUS_OK;
+
+	switch (bc->path) {
+	case BENCH_PATH_READ:
+		bc->code = (size > TOUCH_FRAME_SIZE) ? REPORT_RAW : REPORT_TOUCH;
+		return bench_device_set_report(&bc->bdev, bc->code, bc->frame, size);
+	case BENCH_PATH_DISPATCH:
+		return bench_device_set_response(&bc->bdev, bc->frame, size);
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Check that the frame went through the path intact
+ *
+ * param
+ *    [ in] bc: the case set up
+ *
+ * return
+ *    true if the frame is delivered; otherwise, false.
+ */
+static bool bench_case_verify(struct bench_case *bc)
+{
+	struct tcm_dev *tcm_dev = bc->bdev.tcm_dev;
+
+	if (bench_path_run(bc, bc->frame_size) < 0)
+		return false;
+
+	switch (bc->path) {
+	case BENCH_PATH_READ:
+		return (bc->report_size == bc->frame_size) &&
+			(memcmp(bc->report, bc->frame, bc->frame_size) == 0);
+	case BENCH_PATH_DISPATCH:
+		return (tcm_dev->resp_buf.data_length == bc->frame_size) &&
+			(memcmp(tcm_dev->resp_buf.buf, bc->frame, bc->frame_size) == 0);
+	default:
+		return (tcm_dev->msg_data.out.data_length ==
+			bc->frame_size + MESSAGE_HEADER_SIZE + TCM_MSG_CRC_LENGTH) &&
+			(memcmp(&tcm_dev->msg_data.out.buf[MESSAGE_HEADER_SIZE],
+				bc->frame, bc->frame_size) == 0);
+	}
+}
+
+/*
+ * Measure one path on one build of the library
+ *
+ * param
+ *    [ in] path:       the path to measure
+ *    [ in] detect:     entry of the build of library
+ *    [ in] frame_size: size of each frame
+ *    [ in] capacity:   size of the frames passed before the measurement
+ *
+ * return
+ *    the cost per frame.
+ */
+static double bench_case_run(enum bench_path path, bench_detect_t detect,
+	unsigned int frame_size, unsigned int capacity)
+{
+	static struct bench_case bc;
+	unsigned int i;
+	double cost;
+
+	syna_pal_mem_set(&bc, 0x00, sizeof(bc));
+	bc.path = path;
+	bc.frame_size = frame_size;
+
+	bc.frame = (unsigned char *)syna_pal_mem_alloc(MAX(frame_size, capacity), 1);
+	if (!bc.frame)
+		exit(EXIT_FAILURE);
+
+	for (i = 0; i < MAX(frame_size, capacity); i++)
+		bc.frame[i] = (unsigned char)(i * 7);
+
+	if (bench_device_create(&bc.bdev, detect) < 0)
+		exit(EXIT_FAILURE);
+
+	syna_tcm_set_report_dispatcher(bc.bdev.tcm_dev, REPORT_TOUCH,
+		bench_report_dispatcher, &bc);
+	syna_tcm_set_report_dispatcher(bc.bdev.tcm_dev, REPORT_RAW,
+		bench_report_dispatcher, &bc);
+
+	/* grow the buffers by a frame of the capacity at first */
+	if ((bench_case_set_frame(&bc, capacity) < 0) ||
+		(bench_path_run(&bc, capacity) < 0))
+		exit(EXIT_FAILURE);
+
+	if (bench_case_set_frame(&bc, frame_size) < 0)
+		exit(EXIT_FAILURE);
+
+	if (!bench_case_verify(&bc)) {
+		LOGE("Frame of %u bytes is not delivered on path %d\n",
+			frame_size, path);
+		exit(EXIT_FAILURE);
+	}
+
+	cost = bench_run(bench_frame, &bc, ITERATIONS);
+
+	bench_device_remove(&bc.bdev);
+	syna_pal_mem_free(bc.frame);
+
+	return cost;
+}
+
+int main(void)
+{
+	static const char * const paths[] = { "read", "write", "dispatch" };
+	static const struct {
+		const char *name;
+		unsigned int frame_size;
+		unsigned int capacity;
+	} workloads[] = {
+		{ "touch-only", TOUCH_FRAME_SIZE, TOUCH_FRAME_SIZE },
+		/* touch frames after a raw frame has grown the buffers */
+		{ "touch-after-raw", TOUCH_FRAME_SIZE, RAW_FRAME_SIZE },
+		{ "raw-frame", RAW_FRAME_SIZE, RAW_FRAME_SIZE },
+	};
+	double alloc_cost;
+	double reserve_cost;
+	unsigned int path;
+	unsigned int i;
+
+	printf("%-8s %-16s %6s %8s %14s %14s\n", "path", "workload", "frame",
+		"capacity", "alloc/" BENCH_UNIT, "reserve/" BENCH_UNIT);
+
+	for (path = BENCH_PATH_READ; path <= BENCH_PATH_DISPATCH; path++) {
+		for (i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++) {
+			alloc_cost = bench_case_run(path, syna_tcm_v2_detect_buf_alloc,
+					workloads[i].frame_size, workloads[i].capacity);
+			reserve_cost = bench_case_run(path, syna_tcm_v2_detect,
+					workloads[i].frame_size, workloads[i].capacity);
+
+			printf("%-8s %-16s %6u %8u %14.1f %14.1f\n", paths[path],
+				workloads[i].name, workloads[i].frame_size,
+				workloads[i].capacity, alloc_cost, reserve_cost);
+		}
+	}
+
+	return 0;
+}
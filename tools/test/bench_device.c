@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Synaptics TouchComm touchscreen driver
+ *
+ * Copyright (C) 2017-2025 Synaptics Incorporated. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND SYNAPTICS
+ * EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES, INCLUDING ANY
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE,
+ * AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY INTELLECTUAL PROPERTY RIGHTS.
+ * IN NO EVENT SHALL SYNAPTICS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, PUNITIVE, OR CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION
+ * WITH THE USE OF THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED
+ * AND BASED ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT JURISDICTION DOES
+ * NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY OTHER DAMAGES, SYNAPTICS'
+ * TOTAL CUMULATIVE LIABILITY TO ANY PARTY SHALL NOT EXCEED ONE HUNDRED U.S.
+ * DOLLARS.
+ */
+
+/*
+ * This file implements a TouchComm v2 device emulated in memory.
+ *
+ * The device answers each command right away, CMD_GET_REPORT by the report
+ * set and any other command by STATUS_OK along with the response set. Both
+ * are assembled ahead of time, so a transfer costs the copy only and the
+ * time measured is spent in the core library. The continued reads and the
+ * writes split into chunks are not emulated, the size of transfer is large
+ * enough for any packet instead.
+ */
+
+#include "bench_device.h"
+#include "synaptics_touchcom_func_base.h"
+
+/*
+ * Assemble a packet sent by the device, for both values of the sequence bit
+ *
+ * param
+ *    [out] pkt:     the packet to assemble
+ *    [ in] code:    status or report code
+ *    [ in] payload: data payload, if any
+ *    [ in] size:    size of payload
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int bench_packet_set(struct bench_packet *pkt, unsigned char code,
+	const unsigned char *payload, unsigned int size)
+{
+	unsigned char *buf;
+	unsigned short crc16;
+	unsigned int seq;
+
+	pkt->size = MESSAGE_HEADER_SIZE;
+	if (size > 0)
+		pkt->size += size + TCM_MSG_CRC_LENGTH;
+
+	for (seq = 0; seq < 2; seq++) {
+		syna_pal_mem_free(pkt->buf[seq]);
+
+		buf = (unsigned char *)syna_pal_mem_alloc(pkt->size, 1);
+		pkt->buf[seq] = buf;
+		if (!buf)
+			return -ERR_NOMEM;
+
+		buf[0] = code;
+		buf[1] = (unsigned char)size;
+		buf[2] = (unsigned char)(size >> 8);
+		buf[3] = (unsigned char)(seq << 6);
+		buf[3] |= syna_tcm_crc6(buf, (MESSAGE_HEADER_SIZE << 3) - 6);
+
+		if (size == 0)
+			continue;
+
+		syna_pal_mem_cpy(&buf[MESSAGE_HEADER_SIZE], size, payload, size, size);
+
+		crc16 = syna_tcm_crc16(buf, MESSAGE_HEADER_SIZE + size, 0xFFFF);
+		buf[MESSAGE_HEADER_SIZE + size] = (unsigned char)(crc16 >> 8);
+		buf[MESSAGE_HEADER_SIZE + size + 1] = (unsigned char)crc16;
+	}
+
+	return 0;
+}
+
+/*
+ * Take a command written by the core library, and prepare the packet
+ * answering it
+ *
+ * param
+ *    [ in] hw:      the hw platform interface of device
+ *    [ in] wr_data: command packet written
+ *    [ in] wr_len:  size of command packet
+ *
+ * return
+ *    the number of bytes written.
+ */
+static int bench_device_write(struct tcm_hw_platform *hw,
+	unsigned char *wr_data, unsigned int wr_len)
+{
+	struct bench_device *bdev = (struct bench_device *)hw;
+
+	/* the response carries the sequence bit of the command */
+	bdev->seq = (wr_data[3] >> 6) & 0x01;
+	bdev->next = (wr_data[0] == CMD_GET_REPORT) ? &bdev->report : &bdev->resp;
+
+	return wr_len;
+}
+
+/*
+ * Return the packet answering the command written lastly, a read beyond the
+ * packet is padded with zeros
+ *
+ * param
+ *    [ in] hw:      the hw platform interface of device
+ *    [out] rd_data: buffer to read the packet in
+ *    [ in] rd_len:  number of bytes to read
+ *
+ * return
+ *    the number of bytes read.
+ */
+static int bench_device_read(struct tcm_hw_platform *hw,
+	unsigned char *rd_data, unsigned int rd_len)
+{
+	struct bench_device *bdev = (struct bench_device *)hw;
+	const struct bench_packet *pkt = bdev->next;
+	unsigned int size = MIN(rd_len, pkt->size);
+
+	syna_pal_mem_cpy(rd_data, rd_len, pkt->buf[bdev->seq], pkt->size, size);
+	if (rd_len > size)
+		syna_pal_mem_set(&rd_data[size], 0x00, rd_len - size);
+
+	return rd_len;
+}
+
+/*
+ * Create the TouchComm device running the application firmware
+ *
+ * param
+ *    [out] bdev:   the device to create
+ *    [ in] detect: entry of the TouchComm v2 protocol to set up the device
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int bench_device_create(struct bench_device *bdev, bench_detect_t detect)
+{
+	int retval;
+
+	syna_pal_mem_set(bdev, 0x00, sizeof(*bdev));
+
+	bdev->hw.rd_chunk_size = BENCH_DEVICE_CHUNK_SIZE;
+	bdev->hw.wr_chunk_size = BENCH_DEVICE_CHUNK_SIZE;
+	bdev->hw.ops_read_data = bench_device_read;
+	bdev->hw.ops_write_data = bench_device_write;
+
+	retval = bench_device_set_report(bdev, STATUS_NO_REPORT_AVAILABLE, NULL, 0);
+	if (retval < 0)
+		return retval;
+
+	retval = bench_device_set_response(bdev, NULL, 0);
+	if (retval < 0)
+		return retval;
+
+	bdev->next = &bdev->resp;
+
+	retval = syna_tcm_allocate_device(&bdev->tcm_dev, &bdev->hw, bdev);
+	if (retval < 0)
+		return retval;
+
+	/* the startup packet is not emulated */
+	retval = detect(bdev->tcm_dev, true, false);
+	if (retval < 0) {
+		syna_tcm_remove_device(bdev->tcm_dev);
+		return retval;
+	}
+
+	bdev->tcm_dev->dev_mode = MODE_APPLICATION_FIRMWARE;
+	/* the device answers right away, no bus turnaround to wait for */
+	bdev->tcm_dev->msg_data.turnaround_time = 0;
+
+	return 0;
+}
+
+/*
+ * Remove the TouchComm device created
+ *
+ * param
+ *    [ in] bdev: the device to remove
+ *
+ * return
+ *    void.
+ */
+void bench_device_remove(struct bench_device *bdev)
+{
+	unsigned int seq;
+
+	syna_tcm_remove_device(bdev->tcm_dev);
+
+	for (seq = 0; seq < 2; seq++) {
+		syna_pal_mem_free(bdev->report.buf[seq]);
+		syna_pal_mem_free(bdev->resp.buf[seq]);
+	}
+}
+
+/*
+ * Set the report returned for CMD_GET_REPORT
+ *
+ * param
+ *    [ in] bdev:    the device
+ *    [ in] code:    report code
+ *    [ in] payload: report data
+ *    [ in] size:    size of report data
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int bench_device_set_report(struct bench_device *bdev,
+	unsigned char code, const unsigned char *payload, unsigned int size)
+{
+	return bench_packet_set(&bdev->report, code, payload, size);
+}
+
+/*
+ * Set the data returned along with STATUS_OK for the other commands
+ *
+ * param
+ *    [ in] bdev:    the device
+ *    [ in] payload: response data
+ *    [ in] size:    size of response data
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+int bench_device_set_response(struct bench_device *bdev,
+	const unsigned char *payload, unsigned int size)
+{
+	return bench_packet_set(&bdev->resp, STATUS_OK, payload, size);
+}
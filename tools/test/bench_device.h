@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Synaptics TouchComm touchscreen driver
+ *
+ * Copyright (C) 2017-2025 Synaptics Incorporated. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND SYNAPTICS
+ * EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES, INCLUDING ANY
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE,
+ * AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY INTELLECTUAL PROPERTY RIGHTS.
+ * IN NO EVENT SHALL SYNAPTICS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, PUNITIVE, OR CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION
+ * WITH THE USE OF THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED
+ * AND BASED ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT JURISDICTION DOES
+ * NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY OTHER DAMAGES, SYNAPTICS'
+ * TOTAL CUMULATIVE LIABILITY TO ANY PARTY SHALL NOT EXCEED ONE HUNDRED U.S.
+ * DOLLARS.
+ */
+
+/*
+ * This file declares a TouchComm v2 device emulated in memory.
+ *
+ * The core library talks to the device through the hardware platform
+ * interface as it does to the real one, so the packets written and read in
+ * go through the actual read, write and dispatch functions of the library.
+ */
+
+#ifndef _SYNAPTICS_TCM2_BENCH_DEVICE_H_
+#define _SYNAPTICS_TCM2_BENCH_DEVICE_H_
+
+#include "synaptics_touchcom_core_dev.h"
+
+/* size of each transfer, any packet is carried by a single transfer */
+#define BENCH_DEVICE_CHUNK_SIZE (4096)
+
+/* a packet to return, assembled for both values of the sequence bit */
+struct bench_packet {
+	unsigned char *buf[2];
+	unsigned int size;
+};
+
+struct bench_device {
+	/* keep it the first, the hw platform interface leads to the device */
+	struct tcm_hw_platform hw;
+	struct tcm_dev *tcm_dev;
+
+	/* packets answering CMD_GET_REPORT and the other commands */
+	struct bench_packet report;
+	struct bench_packet resp;
+
+	/* the packet answering the command written lastly */
+	const struct bench_packet *next;
+	unsigned char seq;
+};
+
+/* the entry of the TouchComm v2 protocol the device is detected by */
+typedef int (*bench_detect_t)(struct tcm_dev *tcm_dev, bool bypass,
+	bool do_reset);
+
+int bench_device_create(struct bench_device *bdev, bench_detect_t detect);
+void bench_device_remove(struct bench_device *bdev);
+int bench_device_set_report(struct bench_device *bdev,
+	unsigned char code, const unsigned char *payload, unsigned int size);
+int bench_device_set_response(struct bench_device *bdev,
+	const unsigned char *payload, unsigned int size);
+
+#endif /* _SYNAPTICS_TCM2_BENCH_DEVICE_H_ */
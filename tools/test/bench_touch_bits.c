@@ -0,0 +1,562 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Synaptics TouchComm touchscreen driver
+ *
+ * Copyright (C) 2017-2025 Synaptics Incorporated. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND SYNAPTICS
+ * EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES, INCLUDING ANY
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE,
+ * AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY INTELLECTUAL PROPERTY RIGHTS.
+ * IN NO EVENT SHALL SYNAPTICS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, PUNITIVE, OR CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION
+ * WITH THE USE OF THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED
+ * AND BASED ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT JURISDICTION DOES
+ * NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY OTHER DAMAGES, SYNAPTICS'
+ * TOTAL CUMULATIVE LIABILITY TO ANY PARTY SHALL NOT EXCEED ONE HUNDRED U.S.
+ * DOLLARS.
+ */
+
+/*
+ * This file implements the microbenchmark of the touch report parsing.
+ *
+ * Each report config is returned by the device emulated in bench_device.c,
+ * and preserved by syna_tcm_preserve_touch_report_config() as the driver
+ * does at startup. A trace of touch frames is then encoded into reports of
+ * the config, which are retrieved by read_message() and handed over to the
+ * report dispatcher.
+ *
+ * The reports received are parsed by syna_tcm_parse_touch_report(), through
+ * the compiled plan and through the generic traversal taken along with the
+ * custom callbacks, on the library as it is and on the one built by
+ * func_touch_bytewise.c. Before timing, the touch data parsed is compared
+ * with the trace and between all the ways of parsing.
+ */
+
+#include "bench.h"
+#include "bench_device.h"
+#include "synaptics_touchcom_func_base.h"
+#include "synaptics_touchcom_func_touch.h"
+
+#define FRAMES (64)
+#define MAX_REPORT_SIZE (256)
+
+/* the parser built by func_touch_bytewise.c */
+int syna_tcm_parse_touch_report_bytewise(struct tcm_dev *tcm_dev,
+	unsigned char *report, unsigned int report_size,
+	struct tcm_touch_data_blob *touch_data);
+
+typedef int (*bench_parse_t)(struct tcm_dev *tcm_dev, unsigned char *report,
+	unsigned int report_size, struct tcm_touch_data_blob *touch_data);
+
+enum bench_mode {
+	BENCH_MODE_PLAN = 0,
+	BENCH_MODE_TRAVERSE,
+};
+
+struct bench_object {
+	unsigned int x;
+	unsigned int y;
+	unsigned int z;
+	unsigned int x_width;
+	unsigned int y_width;
+};
+
+/* a frame of the trace, the objects are in slots 0 to num_objects - 1 */
+struct bench_frame {
+	unsigned int timestamp;
+	unsigned int num_objects;
+	struct bench_object objects[MAX_NUM_OBJECTS];
+};
+
+struct bench_case {
+	struct bench_device bdev;
+	const unsigned char *config;
+	unsigned int config_size;
+	struct bench_frame frames[FRAMES];
+	/* reports received by the dispatcher */
+	unsigned char reports[FRAMES][MAX_REPORT_SIZE];
+	unsigned int report_sizes[FRAMES];
+	unsigned int received;
+	/* touch data parsed from each report by the plan of the library as it is */
+	struct tcm_touch_data_blob expected[FRAMES];
+	struct tcm_touch_data_blob touch_data;
+	bench_parse_t parse;
+};
+
+/*
+ * Generate the trace of touch frames, a swipe of one finger, a pinch of
+ * two fingers, then ten fingers landing and all of them lifted at last
+ *
+ * param
+ *    [out] frames: the frames of trace
+ *
+ * return
+ *    void.
+ */
+static void bench_trace_generate(struct bench_frame *frames)
+{
+	struct bench_object *object;
+	unsigned int f;
+	unsigned int obj;
+
+	for (f = 0; f < FRAMES; f++) {
+		frames[f].timestamp = f * 8333;
+
+		if (f < 16)
+			frames[f].num_objects = 1;
+		else if (f < 40)
+			frames[f].num_objects = 2;
+		else if (f < 56)
+			frames[f].num_objects = MAX_NUM_OBJECTS;
+		else
+			frames[f].num_objects = 0;
+
+		for (obj = 0; obj < frames[f].num_objects; obj++) {
+			object = &frames[f].objects[obj];
+			object->x = 100 + obj * 90 + f * 7;
+			object->y = 200 + obj * 150 + ((obj & 0x01) ? (FRAMES - f) : f) * 23;
+			object->z = 40 + (f + obj) % 64;
+			object->x_width = 3 + (f + obj) % 8;
+			object->y_width = 4 + (f + obj) % 8;
+		}
+	}
+}
+
+/*
+ * Return the value of an entity in the frame
+ *
+ * param
+ *    [ in] frame: the frame of trace
+ *    [ in] code:  code of touch entity
+ *    [ in] obj:   slot of object in the loop; or, -1 out of the loop
+ *
+ * return
+ *    the value of entity.
+ */
+static unsigned int bench_trace_value(const struct bench_frame *frame,
+	unsigned char code, int obj)
+{
+	const struct bench_object *object = NULL;
+
+	if ((obj >= 0) && ((unsigned int)obj < frame->num_objects))
+		object = &frame->objects[obj];
+
+	switch (code) {
+	case TOUCH_REPORT_TIMESTAMP:
+		return frame->timestamp;
+	case TOUCH_REPORT_NUM_OF_ACTIVE_OBJECTS:
+		return frame->num_objects;
+	case TOUCH_REPORT_FRAME_RATE:
+		return 120;
+	case TOUCH_REPORT_OBJECT_N_INDEX:
+		return (unsigned int)obj;
+	case TOUCH_REPORT_OBJECT_N_CLASSIFICATION:
+		return (object) ? FINGER : LIFT;
+	case TOUCH_REPORT_OBJECT_N_X_POSITION:
+		return (object) ? object->x : 0;
+	case TOUCH_REPORT_OBJECT_N_Y_POSITION:
+		return (object) ? object->y : 0;
+	case TOUCH_REPORT_OBJECT_N_Z:
+		return (object) ? object->z : 0;
+	case TOUCH_REPORT_OBJECT_N_X_WIDTH:
+		return (object) ? object->x_width : 0;
+	case TOUCH_REPORT_OBJECT_N_Y_WIDTH:
+		return (object) ? object->y_width : 0;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Encode a frame of trace into a report in the format of given config,
+ * as the firmware does
+ *
+ * param
+ *    [ in] bc:     the case set up
+ *    [ in] frame:  the frame of trace
+ *    [out] report: the report encoded, MAX_REPORT_SIZE bytes
+ *
+ * return
+ *    the size of report.
+ */
+static unsigned int bench_report_encode(const struct bench_case *bc,
+	const struct bench_frame *frame, unsigned char *report)
+{
+	const unsigned char *config = bc->config;
+	unsigned int idx = 0;
+	unsigned int offset = 0;
+	unsigned int loop_start = 0;
+	unsigned int loop_count = 0;
+	unsigned int data;
+	unsigned int bit;
+	unsigned char code;
+	unsigned char bits;
+	int obj = -1;
+
+	syna_pal_mem_set(report, 0x00, MAX_REPORT_SIZE);
+
+	while (idx < bc->config_size) {
+		code = config[idx++];
+
+		switch (code) {
+		case TOUCH_REPORT_END:
+			return (offset + 7) / 8;
+		case TOUCH_REPORT_FOREACH_ACTIVE_OBJECT:
+		case TOUCH_REPORT_FOREACH_OBJECT:
+			loop_count = (code == TOUCH_REPORT_FOREACH_OBJECT) ?
+				MAX_NUM_OBJECTS : frame->num_objects;
+			loop_start = idx;
+			obj = 0;
+			if (loop_count > 0)
+				break;
+			/* skip the loop if no object to report */
+			while ((idx < bc->config_size) && (config[idx] != TOUCH_REPORT_FOREACH_END))
+				idx += (config[idx] > TOUCH_REPORT_PAD_TO_NEXT_BYTE) ? 2 : 1;
+			idx++;
+			obj = -1;
+			break;
+		case TOUCH_REPORT_FOREACH_END:
+			if ((unsigned int)++obj < loop_count)
+				idx = loop_start;
+			else
+				obj = -1;
+			break;
+		case TOUCH_REPORT_PAD_TO_NEXT_BYTE:
+			offset = (offset + 7) & ~0x7;
+			break;
+		default:
+			bits = config[idx++];
+			data = bench_trace_value(frame, code, obj);
+			for (bit = 0; bit < bits; bit++, offset++) {
+				if ((bit < 32) && (data & (1U << bit)))
+					report[offset / 8] |= (unsigned char)(1 << (offset % 8));
+			}
+			break;
+		}
+	}
+
+	return (offset + 7) / 8;
+}
+
+/*
+ * The dispatcher of the touch reports, as registered by the driver
+ */
+static int bench_report_dispatcher(const unsigned char code,
+	const unsigned char *data, unsigned int data_size, void *callback_data)
+{
+	struct bench_case *bc = (struct bench_case *)callback_data;
+
+	if ((bc->received >= FRAMES) || (data_size > MAX_REPORT_SIZE))
+		return -ERR_INVAL;
+
+	syna_pal_mem_cpy(bc->reports[bc->received], MAX_REPORT_SIZE,
+		data, data_size, data_size);
+	bc->report_sizes[bc->received++] = data_size;
+
+	return 0;
+}
+
+/*
+ * Set up the case, preserve the config and receive the reports of trace
+ *
+ * param
+ *    [out] bc:          the case to set up
+ *    [ in] config:      the report config
+ *    [ in] config_size: size of given config
+ *
+ * return
+ *    0 or positive value in case of success, a negative value otherwise.
+ */
+static int bench_case_setup(struct bench_case *bc, const unsigned char *config,
+	unsigned int config_size)
+{
+	struct tcm_dev *tcm_dev;
+	unsigned char report[MAX_REPORT_SIZE];
+	unsigned char code;
+	unsigned int size;
+	unsigned int f;
+	int retval;
+
+	syna_pal_mem_set(bc, 0x00, sizeof(*bc));
+	bc->config = config;
+	bc->config_size = config_size;
+
+	retval = bench_device_create(&bc->bdev, syna_tcm_v2_detect);
+	if (retval < 0)
+		return retval;
+
+	tcm_dev = bc->bdev.tcm_dev;
+	tcm_dev->max_objects = MAX_NUM_OBJECTS;
+
+	syna_tcm_set_report_dispatcher(tcm_dev, REPORT_TOUCH,
+		bench_report_dispatcher, bc);
+
+	/* preserve the config returned by device, the parse plan is compiled */
+	retval = bench_device_set_response(&bc->bdev, config, config_size);
+	if (retval < 0)
+		return retval;
+
+	retval = syna_tcm_preserve_touch_report_config(tcm_dev, CMD_RESPONSE_IN_ATTN);
+	if (retval < 0)
+		return retval;
+
+	if (!tcm_dev->touch_plan.valid) {
+		LOGE("Touch report config is not compiled\n");
+		return -ERR_INVAL;
+	}
+
+	bench_trace_generate(bc->frames);
+
+	for (f = 0; f < FRAMES; f++) {
+		size = bench_report_encode(bc, &bc->frames[f], report);
+
+		retval = bench_device_set_report(&bc->bdev, REPORT_TOUCH, report, size);
+		if (retval < 0)
+			return retval;
+
+		retval = tcm_dev->read_message(tcm_dev, &code);
+		if ((retval < 0) || (code != REPORT_TOUCH) || (bc->received != f + 1))
+			return -ERR_TCMMSG;
+	}
+
+	return 0;
+}
+
+/*
+ * Parse all the reports received in one way, and check the touch data
+ *
+ * param
+ *    [ in] bc:    the case set up
+ *    [ in] mode:  parse by the compiled plan or by the traversal
+ *    [ in] parse: the parser
+ *
+ * return
+ *    true if the touch data agrees with the trace and the other ways;
+ *    otherwise, false.
+ */
+static bool bench_case_verify(struct bench_case *bc, enum bench_mode mode,
+	bench_parse_t parse)
+{
+	struct tcm_dev *tcm_dev = bc->bdev.tcm_dev;
+	struct tcm_touch_data_blob *touch_data = &bc->touch_data;
+	const struct bench_frame *frame;
+	const struct tcm_objects_data_blob *object;
+	bool reference = (mode == BENCH_MODE_PLAN) &&
+		(parse == syna_tcm_parse_touch_report);
+	unsigned int f;
+	unsigned int obj;
+
+	tcm_dev->touch_plan.valid = (mode == BENCH_MODE_PLAN);
+	syna_pal_mem_set(touch_data, 0x00, sizeof(*touch_data));
+
+	for (f = 0; f < FRAMES; f++) {
+		frame = &bc->frames[f];
+
+		if (parse(tcm_dev, bc->reports[f], bc->report_sizes[f], touch_data) < 0) {
+			LOGE("Fail to parse report %u\n", f);
+			return false;
+		}
+
+		for (obj = 0; obj < MAX_NUM_OBJECTS; obj++) {
+			object = &touch_data->object_data[obj];
+
+			if (obj >= frame->num_objects) {
+				if (object->status != LIFT)
+					break;
+				continue;
+			}
+
+			if ((object->status != FINGER) ||
+				(object->x_pos != frame->objects[obj].x) ||
+				(object->y_pos != frame->objects[obj].y))
+				break;
+		}
+		if (obj < MAX_NUM_OBJECTS) {
+			LOGE("Object %u of report %u differs from the trace\n", obj, f);
+			return false;
+		}
+
+		if (reference) {
+			syna_pal_mem_cpy(&bc->expected[f], sizeof(bc->expected[f]),
+				touch_data, sizeof(*touch_data), sizeof(*touch_data));
+		} else if (memcmp(&bc->expected[f], touch_data, sizeof(*touch_data)) != 0) {
+			LOGE("Touch data of report %u differs from the plan\n", f);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void bench_parse(void *arg, unsigned int iters)
+{
+	struct bench_case *bc = (struct bench_case *)arg;
+	unsigned int f;
+	unsigned int i;
+
+	for (i = 0; i < iters; i++) {
+		f = i % FRAMES;
+		bc->parse(bc->bdev.tcm_dev, bc->reports[f], bc->report_sizes[f],
+			&bc->touch_data);
+	}
+
+	BENCH_KEEP(bc->touch_data.object_data[0].x_pos);
+}
+
+/*
+ * Measure one way of parsing
+ *
+ * param
+ *    [ in] bc:    the case set up
+ *    [ in] mode:  parse by the compiled plan or by the traversal
+ *    [ in] parse: the parser
+ *
+ * return
+ *    the cost per report.
+ */
+static double bench_case_run(struct bench_case *bc, enum bench_mode mode,
+	bench_parse_t parse)
+{
+	bc->bdev.tcm_dev->touch_plan.valid = (mode == BENCH_MODE_PLAN);
+	bc->parse = parse;
+
+	return bench_run(bench_parse, bc, FRAMES * 500);
+}
+
+int main(void)
+{
+	/* custom_touch_format of the driver, along with the wakeup gesture */
+	static const unsigned char config_driver[] = {
+		TOUCH_REPORT_GESTURE_ID, 8,
+		TOUCH_REPORT_NUM_OF_ACTIVE_OBJECTS, 8,
+		TOUCH_REPORT_FOREACH_ACTIVE_OBJECT,
+		TOUCH_REPORT_OBJECT_N_INDEX, 8,
+		TOUCH_REPORT_OBJECT_N_CLASSIFICATION, 8,
+		TOUCH_REPORT_OBJECT_N_X_POSITION, 16,
+		TOUCH_REPORT_OBJECT_N_Y_POSITION, 16,
+		TOUCH_REPORT_FOREACH_END,
+		TOUCH_REPORT_END,
+	};
+	/* every object slot in 12-bit positions, followed by the frame info */
+	static const unsigned char config_all_slots[] = {
+		TOUCH_REPORT_TIMESTAMP, 32,
+		TOUCH_REPORT_NUM_OF_ACTIVE_OBJECTS, 8,
+		TOUCH_REPORT_FOREACH_OBJECT,
+		TOUCH_REPORT_OBJECT_N_INDEX, 4,
+		TOUCH_REPORT_OBJECT_N_CLASSIFICATION, 4,
+		TOUCH_REPORT_OBJECT_N_X_POSITION, 12,
+		TOUCH_REPORT_OBJECT_N_Y_POSITION, 12,
+		TOUCH_REPORT_OBJECT_N_Z, 8,
+		TOUCH_REPORT_OBJECT_N_X_WIDTH, 4,
+		TOUCH_REPORT_OBJECT_N_Y_WIDTH, 4,
+		TOUCH_REPORT_FOREACH_END,
+		TOUCH_REPORT_0D_BUTTONS_STATE, 8,
+		TOUCH_REPORT_FRAME_RATE, 8,
+		TOUCH_REPORT_GESTURE_ID, 8,
+		TOUCH_REPORT_PAD_TO_NEXT_BYTE,
+		TOUCH_REPORT_END,
+	};
+	/* active objects in odd widths, each padded to the next byte */
+	static const unsigned char config_packed[] = {
+		TOUCH_REPORT_TIMESTAMP, 16,
+		TOUCH_REPORT_NUM_OF_ACTIVE_OBJECTS, 4,
+		TOUCH_REPORT_PAD_TO_NEXT_BYTE,
+		TOUCH_REPORT_FOREACH_ACTIVE_OBJECT,
+		TOUCH_REPORT_OBJECT_N_INDEX, 4,
+		TOUCH_REPORT_OBJECT_N_CLASSIFICATION, 3,
+		TOUCH_REPORT_OBJECT_N_X_POSITION, 13,
+		TOUCH_REPORT_OBJECT_N_Y_POSITION, 13,
+		TOUCH_REPORT_OBJECT_N_X_WIDTH, 5,
+		TOUCH_REPORT_OBJECT_N_Y_WIDTH, 5,
+		TOUCH_REPORT_OBJECT_N_Z, 7,
+		TOUCH_REPORT_PAD_TO_NEXT_BYTE,
+		TOUCH_REPORT_FOREACH_END,
+		TOUCH_REPORT_FRAME_RATE, 8,
+		TOUCH_REPORT_END,
+	};
+	static const char * const modes[] = { "plan", "traverse" };
+	unsigned char config_minimal[sizeof(config_all_slots) + 1];
+	unsigned char mask[TOUCH_ENTITY_MASK_SIZE] = { 0 };
+	struct {
+		const char *name;
+		const unsigned char *config;
+		unsigned int config_size;
+	} configs[] = {
+		{ "driver", config_driver, sizeof(config_driver) },
+		{ "all slots", config_all_slots, sizeof(config_all_slots) },
+		{ "minimal", config_minimal, 0 },
+		{ "packed", config_packed, sizeof(config_packed) },
+	};
+	static struct bench_case bc;
+	double byte_cost;
+	double word_cost;
+	unsigned int max_size;
+	unsigned int mode;
+	unsigned int f;
+	unsigned int i;
+	int size;
+
+	/* 'all slots' reduced to the entities the driver reports */
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_TIMESTAMP);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_NUM_OF_ACTIVE_OBJECTS);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_INDEX);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_CLASSIFICATION);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_X_POSITION);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_OBJECT_N_Y_POSITION);
+	syna_tcm_set_touch_entity(mask, TOUCH_REPORT_FRAME_RATE);
+
+	size = syna_tcm_reduce_touch_report_config(config_all_slots,
+			sizeof(config_all_slots), mask,
+			config_minimal, sizeof(config_minimal));
+	if (size < 0)
+		return EXIT_FAILURE;
+	configs[2].config_size = (unsigned int)size;
+
+	printf("%-10s %-9s %6s %14s %14s\n", "config", "parser", "bytes",
+		"byte/" BENCH_UNIT, "word/" BENCH_UNIT);
+
+	for (i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+		if (bench_case_setup(&bc, configs[i].config, configs[i].config_size) < 0) {
+			LOGE("Fail to set up the case of config '%s'\n", configs[i].name);
+			return EXIT_FAILURE;
+		}
+
+		max_size = 0;
+		for (f = 0; f < FRAMES; f++)
+			max_size = MAX(max_size, bc.report_sizes[f]);
+
+		for (mode = BENCH_MODE_PLAN; mode <= BENCH_MODE_TRAVERSE; mode++) {
+			if (!bench_case_verify(&bc, mode, syna_tcm_parse_touch_report) ||
+				!bench_case_verify(&bc, mode, syna_tcm_parse_touch_report_bytewise)) {
+				LOGE("Config '%s' is not parsed correctly by %s\n",
+					configs[i].name, modes[mode]);
+				return EXIT_FAILURE;
+			}
+		}
+
+		for (mode = BENCH_MODE_PLAN; mode <= BENCH_MODE_TRAVERSE; mode++) {
+			byte_cost = bench_case_run(&bc, mode, syna_tcm_parse_touch_report_bytewise);
+			word_cost = bench_case_run(&bc, mode, syna_tcm_parse_touch_report);
+
+			printf("%-10s %-9s %6u %14.1f %14.1f\n", configs[i].name,
+				modes[mode], max_size, byte_cost, word_cost);
+		}
+
+		bench_device_remove(&bc.bdev);
+	}
+
+	return 0;
+}
@@ -0,0 +1,308 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Synaptics TouchComm touchscreen driver
+ *
+ * Copyright (C) 2017-2025 Synaptics Incorporated. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND SYNAPTICS
+ * EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES, INCLUDING ANY
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE,
+ * AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY INTELLECTUAL PROPERTY RIGHTS.
+ * IN NO EVENT SHALL SYNAPTICS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, PUNITIVE, OR CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION
+ * WITH THE USE OF THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED
+ * AND BASED ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT JURISDICTION DOES
+ * NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY OTHER DAMAGES, SYNAPTICS'
+ * TOTAL CUMULATIVE LIABILITY TO ANY PARTY SHALL NOT EXCEED ONE HUNDRED U.S.
+ * DOLLARS.
+ */
+
+/*
+ * This file implements the kernel APIs used by syna_tcm2_runtime.h on top of
+ * libc and pthreads, so the driver's own runtime header and TouchComm core
+ * library are built as they are in userspace.
+ *
+ * Every kernel header included by syna_tcm2_runtime.h is generated by the
+ * Makefile as a stub including this file. The managed device requested by
+ * the runtime is defined in kernel_shim.c.
+ */
+
+#ifndef _SYNAPTICS_TCM2_KERNEL_SHIM_H_
+#define _SYNAPTICS_TCM2_KERNEL_SHIM_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#define KERNEL_VERSION(a, b, c) (((a) << 16) + ((b) << 8) + (c))
+#define LINUX_VERSION_CODE KERNEL_VERSION(6, 6, 0)
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+/*
+ * Kernel log, only the errors and warnings are printed
+ */
+#define pr_err(fmt, ...) fprintf(stderr, fmt, ##__VA_ARGS__)
+#define pr_warn(fmt, ...) fprintf(stderr, fmt, ##__VA_ARGS__)
+#define pr_notice(fmt, ...) do { } while (0)
+#define pr_info(fmt, ...) do { } while (0)
+#define pr_debug(fmt, ...) do { } while (0)
+
+/*
+ * Atomic operations
+ */
+typedef struct {
+	int counter;
+} atomic_t;
+
+#define atomic_set(v, i) __atomic_store_n(&(v)->counter, (i), __ATOMIC_SEQ_CST)
+#define atomic_read(v) __atomic_load_n(&(v)->counter, __ATOMIC_SEQ_CST)
+#define atomic_inc_return(v) __atomic_add_fetch(&(v)->counter, 1, __ATOMIC_SEQ_CST)
+#define atomic_dec_return(v) __atomic_sub_fetch(&(v)->counter, 1, __ATOMIC_SEQ_CST)
+
+/* a single load as the kernel does on the architectures allowing it */
+static inline u64 get_unaligned_le64(const void *p)
+{
+	u64 v;
+
+	memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	v = __builtin_bswap64(v);
+#endif
+	return v;
+}
+
+/*
+ * Memory, the managed device is a placeholder and devres is not tracked
+ */
+struct device {
+	int unused;
+};
+
+#define GFP_KERNEL (0)
+
+static inline void *kcalloc(size_t n, size_t size, int flags)
+{
+	return calloc(n, size);
+}
+
+static inline void kfree(const void *ptr)
+{
+	free((void *)ptr);
+}
+
+static inline void *devm_kcalloc(struct device *dev, size_t n, size_t size,
+	int flags)
+{
+	return calloc(n, size);
+}
+
+static inline void devm_kfree(struct device *dev, const void *ptr)
+{
+	free((void *)ptr);
+}
+
+static inline ssize_t strscpy(char *dest, const char *src, size_t count)
+{
+	size_t len;
+
+	if (count == 0)
+		return -E2BIG;
+
+	len = strnlen(src, count - 1);
+	memcpy(dest, src, len);
+	dest[len] = '\0';
+
+	return (src[len] == '\0') ? (ssize_t)len : -E2BIG;
+}
+
+/*
+ * Mutex and completion
+ */
+struct mutex {
+	pthread_mutex_t lock;
+};
+
+#define mutex_init(m) pthread_mutex_init(&(m)->lock, NULL)
+#define mutex_lock(m) pthread_mutex_lock(&(m)->lock)
+#define mutex_unlock(m) pthread_mutex_unlock(&(m)->lock)
+#define mutex_trylock(m) (pthread_mutex_trylock(&(m)->lock) == 0)
+
+struct completion {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	unsigned int done;
+};
+
+static inline void init_completion(struct completion *x)
+{
+	pthread_mutex_init(&x->lock, NULL);
+	pthread_cond_init(&x->cond, NULL);
+	x->done = 0;
+}
+
+static inline void reinit_completion(struct completion *x)
+{
+	pthread_mutex_lock(&x->lock);
+	x->done = 0;
+	pthread_mutex_unlock(&x->lock);
+}
+
+static inline bool completion_done(struct completion *x)
+{
+	bool done;
+
+	pthread_mutex_lock(&x->lock);
+	done = (x->done != 0);
+	pthread_mutex_unlock(&x->lock);
+
+	return done;
+}
+
+static inline void complete(struct completion *x)
+{
+	pthread_mutex_lock(&x->lock);
+	x->done++;
+	pthread_cond_broadcast(&x->cond);
+	pthread_mutex_unlock(&x->lock);
+}
+
+/*
+ * Time, jiffies are counted in milliseconds
+ */
+typedef long long ktime_t;
+
+#define NSEC_PER_USEC (1000LL)
+#define NSEC_PER_MSEC (1000000LL)
+#define NSEC_PER_SEC (1000000000LL)
+
+static inline ktime_t ktime_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (ktime_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+#define ktime_us_delta(later, earlier) (((later) - (earlier)) / NSEC_PER_USEC)
+#define ktime_add_us(kt, us) ((kt) + (ktime_t)(us) * NSEC_PER_USEC)
+
+static inline unsigned long msecs_to_jiffies(unsigned int ms)
+{
+	return ms;
+}
+
+static inline unsigned long wait_for_completion_timeout(struct completion *x,
+	unsigned long timeout)
+{
+	struct timespec ts;
+	ktime_t deadline = ktime_get() + (ktime_t)timeout * NSEC_PER_MSEC;
+	unsigned long left = 1;
+
+	/* the condition variable waits on the realtime clock */
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += timeout / 1000;
+	ts.tv_nsec += (long)(timeout % 1000) * NSEC_PER_MSEC;
+	if (ts.tv_nsec >= NSEC_PER_SEC) {
+		ts.tv_sec++;
+		ts.tv_nsec -= NSEC_PER_SEC;
+	}
+
+	pthread_mutex_lock(&x->lock);
+	while (x->done == 0) {
+		if (pthread_cond_timedwait(&x->cond, &x->lock, &ts) == ETIMEDOUT) {
+			left = 0;
+			break;
+		}
+	}
+	if (x->done > 0) {
+		x->done--;
+		if (ktime_get() < deadline)
+			left = (unsigned long)((deadline - ktime_get()) / NSEC_PER_MSEC) + 1;
+	}
+	pthread_mutex_unlock(&x->lock);
+
+	return left;
+}
+
+/*
+ * Delays
+ */
+static inline void kshim_sleep_ns(long long ns)
+{
+	struct timespec ts = {
+		.tv_sec = ns / NSEC_PER_SEC,
+		.tv_nsec = ns % NSEC_PER_SEC,
+	};
+
+	nanosleep(&ts, NULL);
+}
+
+static inline void kshim_spin_ns(long long ns)
+{
+	ktime_t until = ktime_get() + ns;
+
+	while (ktime_get() < until)
+		;
+}
+
+#define msleep(ms) kshim_sleep_ns((long long)(ms) * NSEC_PER_MSEC)
+#define usleep_range(min, max) kshim_sleep_ns((long long)(min) * NSEC_PER_USEC)
+#define udelay(us) kshim_spin_ns((long long)(us) * NSEC_PER_USEC)
+#define mdelay(ms) kshim_spin_ns((long long)(ms) * NSEC_PER_MSEC)
+
+#define TASK_UNINTERRUPTIBLE (2)
+#define HRTIMER_MODE_ABS (0)
+#define set_current_state(state) do { } while (0)
+
+static inline int schedule_hrtimeout_range(ktime_t *expires, u64 delta,
+	int mode)
+{
+	ktime_t now = ktime_get();
+
+	if (*expires > now)
+		kshim_sleep_ns(*expires - now);
+
+	return 0;
+}
+
+/*
+ * CRC32, the little-endian variant as crc32() of the kernel
+ */
+static inline u32 crc32(u32 crc, const void *data, size_t len)
+{
+	const u8 *p = (const u8 *)data;
+	int bit;
+
+	while (len--) {
+		crc ^= *p++;
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+	}
+
+	return crc;
+}
+
+#endif /* _SYNAPTICS_TCM2_KERNEL_SHIM_H_ */